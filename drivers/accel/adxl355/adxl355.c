@@ -64,6 +64,10 @@ int adxl355_read_device_data(struct adxl355_dev *dev, uint8_t base_address,
 			     uint16_t size, uint8_t *read_data)
 {
 	int ret;
+	struct no_os_i2c_msg msgs[2] = {
+		{ .buf = &base_address, .len = 1, .flags = 0 },
+		{ .buf = read_data, .len = size, .flags = NO_OS_I2C_M_RD },
+	};
 
 	if (dev->comm_type == ADXL355_SPI_COMM) {
 		dev->comm_buff[0] = ADXL355_SPI_READ | (base_address << 1);
@@ -72,10 +76,9 @@ int adxl355_read_device_data(struct adxl355_dev *dev, uint8_t base_address,
 		for (uint16_t idx = 0; idx < size; idx++)
 			read_data[idx] = dev->comm_buff[idx + 1];
 	} else {
-		ret = no_os_i2c_write(dev->com_desc.i2c_desc, &base_address, 1, 0);
-		if (ret)
-			return ret;
-		ret = no_os_i2c_read(dev->com_desc.i2c_desc, read_data, size, 1);
+		/* FIFO reads can be longer than 255 bytes */
+		ret = no_os_i2c_transfer(dev->com_desc.i2c_desc, msgs,
+					 NO_OS_ARRAY_SIZE(msgs));
 	}
 
 	return ret;
@@ -42,6 +42,7 @@
 #include "no_os_error.h"
 #include "no_os_util.h"
 #include "no_os_alloc.h"
+#include "no_os_regmap.h"
 
 #define AD469x_TEST_DATA 0xEA
 
@@ -67,17 +68,34 @@ struct ad469x_device_info dev_info[] = {
 	[ID_AD4698] = {.max_data_ch = 8, .max_rate_ksps = 1000},
 };
 
+/* Registers changed by the device, which are never cached */
+static const struct no_os_regmap_range ad469x_volatile_ranges[] = {
+	/* Software reset, self clearing */
+	{ AD469x_REG_IF_CONFIG_A, AD469x_REG_IF_CONFIG_A },
+	/* Scratch pad, written and read back to check the SPI link */
+	{ AD469x_REG_SCRATCH_PAD, AD469x_REG_SCRATCH_PAD },
+	{ AD469x_REG_IF_STATUS, AD469x_REG_IF_STATUS },
+	/* Status, alert and clamp status */
+	{ AD469x_REG_STATUS, AD469x_REG_CLAMP_STATUS2 },
+	{ AD469x_REG_GPIO_STATE, AD469x_REG_GPIO_STATE },
+};
+
+static const struct no_os_regmap_table ad469x_volatile_table = {
+	.ranges = ad469x_volatile_ranges,
+	.nb_ranges = NO_OS_ARRAY_SIZE(ad469x_volatile_ranges),
+};
+
 /**
- * Read from device.
- * @param dev - The device structure.
+ * Read a register of the device. Used by the register map.
+ * @param map - The register map, whose bus is the device structure.
  * @param reg_addr - The register address.
  * @param reg_data - The register data.
  * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad469x_spi_reg_read(struct ad469x_dev *dev,
-			    uint16_t reg_addr,
-			    uint8_t *reg_data)
+static int ad469x_bus_read(struct no_os_regmap *map, uint32_t reg_addr,
+			   uint32_t *reg_data)
 {
+	struct ad469x_dev *dev = map->bus;
 	int32_t ret;
 	uint8_t buf[3];
 
@@ -109,16 +127,16 @@ int32_t ad469x_spi_reg_read(struct ad469x_dev *dev,
 }
 
 /**
- * Write to device.
- * @param dev - The device structure.
+ * Write a register of the device. Used by the register map.
+ * @param map - The register map, whose bus is the device structure.
  * @param reg_addr - The register address.
  * @param reg_data - The register data.
- * @@eturn 0 in case of success, negative error code otherwise.
+ * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad469x_spi_reg_write(struct ad469x_dev *dev,
-			     uint16_t reg_addr,
-			     uint8_t reg_data)
+static int ad469x_bus_write(struct no_os_regmap *map, uint32_t reg_addr,
+			    uint32_t reg_data)
 {
+	struct ad469x_dev *dev = map->bus;
 	int32_t ret;
 	uint8_t buf[3];
 
@@ -148,6 +166,49 @@ int32_t ad469x_spi_reg_write(struct ad469x_dev *dev,
 	return ret;
 }
 
+static const struct no_os_regmap_bus_ops ad469x_bus_ops = {
+	.reg_read = ad469x_bus_read,
+	.reg_write = ad469x_bus_write,
+};
+
+/**
+ * Read from device. Registers which are not volatile are read from the
+ * register cache.
+ * @param dev - The device structure.
+ * @param reg_addr - The register address.
+ * @param reg_data - The register data.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_spi_reg_read(struct ad469x_dev *dev,
+			    uint16_t reg_addr,
+			    uint8_t *reg_data)
+{
+	uint32_t val;
+	int32_t ret;
+
+	ret = no_os_regmap_read(dev->regmap, reg_addr, &val);
+	if (ret)
+		return ret;
+
+	*reg_data = val;
+
+	return 0;
+}
+
+/**
+ * Write to device.
+ * @param dev - The device structure.
+ * @param reg_addr - The register address.
+ * @param reg_data - The register data.
+ * @@eturn 0 in case of success, negative error code otherwise.
+ */
+int32_t ad469x_spi_reg_write(struct ad469x_dev *dev,
+			     uint16_t reg_addr,
+			     uint8_t reg_data)
+{
+	return no_os_regmap_write(dev->regmap, reg_addr, reg_data);
+}
+
 /**
  * SPI read from device using a mask.
  * @param dev - The device structure.
@@ -174,7 +235,8 @@ int32_t ad469x_spi_read_mask(struct ad469x_dev *dev,
 }
 
 /**
- * SPI write to device using a mask.
+ * SPI write to device using a mask. Only the write goes on the bus for
+ * cached registers, and none if the value doesn't change.
  * @param dev - The device structure.
  * @param reg_addr - The register address.
  * @param mask - The mask.
@@ -186,17 +248,7 @@ int32_t ad469x_spi_write_mask(struct ad469x_dev *dev,
 			      uint8_t mask,
 			      uint8_t data)
 {
-	uint8_t reg_data;
-	int32_t ret;
-
-	ret = ad469x_spi_reg_read(dev, reg_addr, &reg_data);
-	if (ret != 0)
-		return ret;
-
-	reg_data &= ~mask;
-	reg_data |= data;
-
-	return ad469x_spi_reg_write(dev, reg_addr, reg_data);
+	return no_os_regmap_update_bits(dev->regmap, reg_addr, mask, data);
 }
 
 /**
@@ -771,23 +823,21 @@ int32_t ad469x_seq_read_data(struct ad469x_dev *dev,
 	return 0;
 }
 
+#if !defined(USE_STANDARD_SPI)
 /**
- * @brief Read from device.
- *        Enter register mode to read/write registers
+ * @brief Get the offload program that reads a channel.
+ *        The program is compiled only when the channel or the capture data
+ *        width changed since the previous call.
  * @param [in] dev - ad469x_dev device handler.
  * @param [in] channel - ad469x selected channel.
- * @param [out] buf - data buffer.
- * @param [in] samples - sample number.
- * @return 0 in case of success, -1 otherwise.
+ * @param [out] prog - offload program.
+ * @return 0 in case of success, negative error code otherwise.
  */
-int32_t ad469x_read_data(struct ad469x_dev *dev,
-			 uint8_t channel,
-			 uint32_t *buf,
-			 uint16_t samples)
+static int32_t ad469x_offload_prog_get(struct ad469x_dev *dev,
+				       uint8_t channel,
+				       struct spi_engine_offload_program **prog)
 {
 	int32_t ret;
-
-#if !defined(USE_STANDARD_SPI)
 	uint32_t commands_data[1];
 	struct spi_engine_offload_message msg;
 	uint32_t spi_eng_msg_cmds[3] = {
@@ -795,6 +845,13 @@ int32_t ad469x_read_data(struct ad469x_dev *dev,
 		WRITE_READ(1),
 		CS_HIGH
 	};
+
+	if (dev->offload_prog && dev->offload_prog_ch == channel &&
+	    dev->offload_prog_width == dev->capture_data_width) {
+		*prog = dev->offload_prog;
+		return 0;
+	}
+
 	if (channel < dev->num_data_ch)
 		commands_data[0] = AD469x_CMD_CONFIG_CH_SEL(channel) << 8;
 	else if (channel == dev->num_data_ch)
@@ -802,23 +859,63 @@ int32_t ad469x_read_data(struct ad469x_dev *dev,
 	else
 		return -EINVAL;
 
-	no_os_pwm_enable(dev->trigger_pwm_desc);
-
 	ret = spi_engine_offload_init(dev->spi_desc, dev->offload_init_param);
 	if (ret != 0)
 		return ret;
 
+	if (dev->offload_prog) {
+		spi_engine_offload_program_remove(dev->spi_desc, dev->offload_prog);
+		dev->offload_prog = NULL;
+	}
+
 	msg.commands = spi_eng_msg_cmds;
 	msg.no_commands = NO_OS_ARRAY_SIZE(spi_eng_msg_cmds);
-	msg.rx_addr = (uint32_t)buf;
 	msg.commands_data = commands_data;
 
-	ret = spi_engine_offload_transfer(dev->spi_desc, msg, samples);
+	ret = spi_engine_offload_compile(dev->spi_desc, &msg, &dev->offload_prog);
+	if (ret != 0)
+		return ret;
+
+	dev->offload_prog_ch = channel;
+	dev->offload_prog_width = dev->capture_data_width;
+	*prog = dev->offload_prog;
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief Read from device.
+ *        Enter register mode to read/write registers
+ * @param [in] dev - ad469x_dev device handler.
+ * @param [in] channel - ad469x selected channel.
+ * @param [out] buf - data buffer.
+ * @param [in] samples - sample number.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t ad469x_read_data(struct ad469x_dev *dev,
+			 uint8_t channel,
+			 uint32_t *buf,
+			 uint16_t samples)
+{
+	int32_t ret;
+
+#if !defined(USE_STANDARD_SPI)
+	struct spi_engine_offload_program *prog;
+
+	ret = ad469x_offload_prog_get(dev, channel, &prog);
+	if (ret != 0)
+		return ret;
+
+	no_os_pwm_enable(dev->trigger_pwm_desc);
+
+	ret = spi_engine_offload_run(dev->spi_desc, prog, 0, (uint32_t)buf,
+				     samples);
 	if (ret != 0)
 		return ret;
 
 	if (dev->dcache_invalidate_range)
-		dev->dcache_invalidate_range(msg.rx_addr, samples * 4);
+		dev->dcache_invalidate_range((uint32_t)buf, samples * 4);
 #else
 	ret = no_os_spi_write_and_read(dev->spi_desc, buf, (samples * 2));
 	if (ret != 0)
@@ -850,6 +947,9 @@ int32_t ad469x_reset_dev(struct ad469x_dev *dev)
 
 	no_os_mdelay(10);
 
+	/* The registers are back to their reset values */
+	no_os_regmap_cache_drop(dev->regmap);
+
 	ret = ad469x_spi_reg_read(dev, AD469x_REG_STATUS, &reset_status);
 	if (ret != 0)
 		return ret;
@@ -1055,13 +1155,21 @@ int32_t ad469x_get_ain_high_z_status(struct ad469x_dev *dev,
 int32_t ad469x_init(struct ad469x_dev **device,
 		    struct ad469x_init_param *init_param)
 {
+	struct no_os_regmap_init_param regmap_ip = {
+		.bus_ops = &ad469x_bus_ops,
+		.reg_bits = 16,
+		.val_bits = 8,
+		.max_register = AD469x_REG_AS_SLOT(0x7F),
+		.volatile_table = &ad469x_volatile_table,
+		.cache_type = NO_OS_REGMAP_CACHE_FLAT,
+	};
 	struct ad469x_dev *dev;
 	int32_t ret;
 	uint8_t data = 0;
 	uint8_t max_data_ch;
 	uint32_t sample_frequncy_ksps;
 
-	dev = (struct ad469x_dev *)no_os_malloc(sizeof(*dev));
+	dev = (struct ad469x_dev *)no_os_calloc(1, sizeof(*dev));
 	if (!dev)
 		return -ENOMEM;
 
@@ -1089,6 +1197,11 @@ int32_t ad469x_init(struct ad469x_dev **device,
 	if (ret != 0)
 		goto error_gpio;
 
+	regmap_ip.bus = dev;
+	ret = no_os_regmap_init(&dev->regmap, &regmap_ip);
+	if (ret != 0)
+		goto error_spi;
+
 #if !defined(USE_STANDARD_SPI)
 	dev->offload_init_param = init_param->offload_init_param;
 	dev->reg_access_speed = init_param->reg_access_speed;
@@ -1161,6 +1274,7 @@ int32_t ad469x_init(struct ad469x_dev **device,
 	return ret;
 
 error_spi:
+	no_os_regmap_remove(dev->regmap);
 	no_os_spi_remove(dev->spi_desc);
 error_gpio:
 	no_os_gpio_remove(dev->gpio_resetn);
@@ -1192,12 +1306,17 @@ int32_t ad469x_remove(struct ad469x_dev *dev)
 	ret = no_os_pwm_remove(dev->trigger_pwm_desc);
 	if (ret != 0)
 		return ret;
+
+	if (dev->offload_prog)
+		spi_engine_offload_program_remove(dev->spi_desc, dev->offload_prog);
 #endif
 
 	ret = no_os_spi_remove(dev->spi_desc);
 	if (ret != 0)
 		return ret;
 
+	no_os_regmap_remove(dev->regmap);
+
 	ret = no_os_gpio_remove(dev->gpio_resetn);
 	if (ret != 0)
 		return ret;
@@ -52,6 +52,7 @@
 #endif
 
 #include "no_os_gpio.h"
+#include "no_os_regmap.h"
 
 /* AD469x registers */
 #define AD469x_REG_IF_CONFIG_A		0x000
@@ -296,6 +297,8 @@ struct ad469x_init_param {
 struct ad469x_dev {
 	/* SPI descriptor */
 	struct no_os_spi_desc		*spi_desc;
+	/* Register map, caching the configuration registers */
+	struct no_os_regmap		*regmap;
 #if !defined(USE_STANDARD_SPI)
 	/* Clock gen for hdl design structure */
 	struct axi_clkgen	*clkgen;
@@ -303,6 +306,11 @@ struct ad469x_dev {
 	struct no_os_pwm_desc		*trigger_pwm_desc;
 	/* SPI module offload init */
 	struct spi_engine_offload_init_param *offload_init_param;
+	/* Offload program used by the last ad469x_read_data() */
+	struct spi_engine_offload_program *offload_prog;
+	/* Channel and capture data width the offload program was built for */
+	uint8_t		offload_prog_ch;
+	uint8_t		offload_prog_width;
 #endif
 	/* Register access speed */
 	uint32_t		reg_access_speed;
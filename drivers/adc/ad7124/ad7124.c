@@ -1174,7 +1174,7 @@ int32_t ad7124_setup(struct ad7124_dev **device,
 error_spi:
 	no_os_spi_remove(dev->spi_desc);
 error_dev:
-	free(dev);
+	no_os_free(dev);
 
 	return ret;
 }
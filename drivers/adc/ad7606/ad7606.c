@@ -89,7 +89,7 @@ struct ad7606_chip_info {
 };
 
 NO_OS_DECLARE_CRC8_TABLE(ad7606_crc8);
-NO_OS_DECLARE_CRC16_TABLE(ad7606_crc16);
+NO_OS_DECLARE_CRC16_SLICE_TABLE(ad7606_crc16);
 
 static const struct ad7606_range ad7606_range_table[] = {
 	{-5000, 5000, AD7606_HW_RANGE},		/* RANGE pin LOW */
@@ -525,57 +525,115 @@ int32_t ad7606_reg_write_mask(struct ad7606_dev *dev,
 	return ad7606_reg_write(dev, addr, reg_data);
 }
 
-/* Internal function to copy the content of a buffer in 18-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy18b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
+/* Internal function to load 8 bytes of a big-endian stream. */
+static inline uint64_t ad7606_get_be64(const uint8_t *p)
 {
-	unsigned int i, j;
-
-	if (srcsz % 9)
-		return -EINVAL;
+	return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+	       ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+	       ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+	       ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
 
-	for (i = 0; i < srcsz; i += 9) {
-		j = 4 * (i / 9);
-		pdst[j + 0] = ((uint32_t)(psrc[i + 0] & 0xff) << 10) | ((
-					uint32_t)psrc[i + 1] << 2)
-			      | ((uint32_t)psrc[i + 2] >> 6);
-		pdst[j + 1] = ((uint32_t)(psrc[i + 2] & 0x3f) << 12) | ((
-					uint32_t)psrc[i + 3] << 4)
-			      | ((uint32_t)psrc[i + 4] >> 4);
-		pdst[j + 2] = ((uint32_t)(psrc[i + 4] & 0x0f) << 14) | ((
-					uint32_t)psrc[i + 5] << 6)
-			      | ((uint32_t)psrc[i + 6] >> 2);
-		pdst[j + 3] = ((uint32_t)(psrc[i + 6] & 0x03) << 16) | ((
-					uint32_t)psrc[i + 7] << 8)
-			      | ((uint32_t)psrc[i + 8] >> 0);
-	}
-	return 0;
+/* Internal function to load 4 bytes of a big-endian stream. */
+static inline uint32_t ad7606_get_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+	       ((uint32_t)p[2] << 8) | (uint32_t)p[3];
 }
 
-/* Internal function to copy the content of a buffer in 26-bit chunks to a 32-bit buffer by
- * extending the chunks to 32-bit size. */
-static int32_t cpy26b32b(uint8_t *psrc, uint32_t srcsz, uint32_t *pdst)
+/*
+ * Internal function to extend nwords big-endian words of width bits (16, 18,
+ * 24 or 26), packed back to back in psrc, to 32-bit words in pdst.
+ *
+ * Four words always take a whole number of bytes (width / 2), so the stream
+ * is decoded one group of four at a time, the group being fetched with wide
+ * loads instead of byte by byte. The groups are walked from the last one
+ * and each group is fully read before its words are stored, so psrc may
+ * point to the beginning of pdst and the frames be decoded in place.
+ */
+static int32_t ad7606_unpack(const uint8_t *psrc, uint32_t nwords,
+			     uint8_t width, uint32_t *pdst)
 {
-	unsigned int i, j;
+	uint32_t a, b, c, t[3], i, n, g = nwords / 4;
+	const uint8_t *p;
+	uint32_t *d;
+	uint64_t x;
 
-	if (srcsz % 13)
-		return -EINVAL;
+	switch (width) {
+	case 16:
+	case 18:
+	case 24:
+	case 26:
+		break;
+	default:
+		return -ENOTSUP;
+	}
 
-	for (i = 0; i < srcsz; i += 13) {
-		j = 4 * (i / 13);
-		pdst[j + 0] = ((uint32_t)(psrc[i + 0] & 0xff) << 18) | ((
-					uint32_t)psrc[i + 1] << 10)
-			      | ((uint32_t)psrc[i + 2] << 2) | ((uint32_t)psrc[i + 3] >> 6);
-		pdst[j + 1] = ((uint32_t)(psrc[i + 3] & 0x3f) << 20) | ((
-					uint32_t)psrc[i + 4] << 12)
-			      | ((uint32_t)psrc[i + 5] << 4) | ((uint32_t)psrc[i + 6] >> 4);
-		pdst[j + 2] = ((uint32_t)(psrc[i + 6] & 0x0f) << 22) | ((
-					uint32_t)psrc[i + 7] << 14)
-			      | ((uint32_t)psrc[i + 8] << 6) | ((uint32_t)psrc[i + 9] >> 2);
-		pdst[j + 3] = ((uint32_t)(psrc[i + 9] & 0x03) << 24) | ((
-					uint32_t)psrc[i + 10] << 16)
-			      | ((uint32_t)psrc[i + 11] << 8) | ((uint32_t)psrc[i + 12] >> 0);
+	/* Words left after the last group (6 channel parts), decoded first */
+	p = psrc + g * width / 2;
+	for (x = 0, n = 0, i = 0; i < nwords % 4; i++) {
+		while (n < width) {
+			x = (x << 8) | *p++;
+			n += 8;
+		}
+		n -= width;
+		t[i] = (x >> n) & NO_OS_GENMASK(width - 1, 0);
+	}
+	for (i = 0; i < nwords % 4; i++)
+		pdst[g * 4 + i] = t[i];
+
+	switch (width) {
+	case 16:
+		while (g--) {
+			p = psrc + g * 8;
+			d = pdst + g * 4;
+			x = ad7606_get_be64(p);
+			d[3] = x & 0xffff;
+			d[2] = (x >> 16) & 0xffff;
+			d[1] = (x >> 32) & 0xffff;
+			d[0] = x >> 48;
+		}
+		break;
+	case 18:
+		while (g--) {
+			p = psrc + g * 9;
+			d = pdst + g * 4;
+			x = ad7606_get_be64(p);
+			a = p[8];
+			d[3] = ((uint32_t)(x & 0x3ff) << 8) | a;
+			d[2] = (x >> 10) & 0x3ffff;
+			d[1] = (x >> 28) & 0x3ffff;
+			d[0] = x >> 46;
+		}
+		break;
+	case 24:
+		while (g--) {
+			p = psrc + g * 12;
+			d = pdst + g * 4;
+			a = ad7606_get_be32(p);
+			b = ad7606_get_be32(p + 4);
+			c = ad7606_get_be32(p + 8);
+			d[3] = c & 0xffffff;
+			d[2] = ((b & 0xffff) << 8) | (c >> 24);
+			d[1] = ((a & 0xff) << 16) | (b >> 16);
+			d[0] = a >> 8;
+		}
+		break;
+	case 26:
+		while (g--) {
+			p = psrc + g * 13;
+			d = pdst + g * 4;
+			x = ad7606_get_be64(p);
+			a = ad7606_get_be32(p + 9);
+			b = p[8];
+			d[3] = a & 0x3ffffff;
+			d[2] = ((uint32_t)(x & 0xfff) << 14) | (b << 6) | (a >> 26);
+			d[1] = (x >> 12) & 0x3ffffff;
+			d[0] = x >> 38;
+		}
+		break;
 	}
+
 	return 0;
 }
 
@@ -615,6 +673,67 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 	return no_os_gpio_set_value(dev->gpio_convst, 1);
 }
 
+/* Internal function to get the width in bits of a word of a serial frame. */
+static inline uint8_t ad7606_frame_width(struct ad7606_dev *dev)
+{
+	return ad7606_chip_info_tbl[dev->device_id].bits +
+	       (dev->config.status_header ? 8 : 0);
+}
+
+/* Internal function to get the size in bytes of a serial frame, without CRC. */
+static inline uint32_t ad7606_frame_size(struct ad7606_dev *dev)
+{
+	/* Number of bits to read, corresponds to SCLK cycles in transfer.
+	 * This should always be a multiple of 8 to work with most SPI's.
+	 * With this chip family this holds true because we either:
+	 *  - multiply 8 channels * bits per sample
+	 *  - multiply 4 channels * bits per sample (always multiple of 2)
+	 * Therefore, due to design reasons, we don't check for the
+	 * remainder of this division because it is zero by design.
+	 */
+	return ad7606_chip_info_tbl[dev->device_id].num_channels *
+	       ad7606_frame_width(dev) / 8;
+}
+
+/* Internal function to clock out one raw serial frame and check its CRC.
+ * buf must have room for the frame and the 2 CRC bytes, if enabled. */
+static int32_t ad7606_spi_frame_read(struct ad7606_dev *dev, uint8_t *buf)
+{
+	uint32_t sz = ad7606_frame_size(dev);
+	uint16_t crc, icrc;
+	int32_t ret;
+
+	if (dev->digital_diag_enable.int_crc_err_en) {
+		sz += 2;
+	}
+
+	memset(buf, 0, sz);
+	ret = no_os_spi_write_and_read(dev->spi_desc, buf, sz);
+	if (ret < 0)
+		return ret;
+
+	if (dev->digital_diag_enable.int_crc_err_en) {
+		sz -= 2;
+		crc = no_os_crc16_slice(ad7606_crc16, buf, sz, 0);
+		icrc = ((uint16_t)buf[sz] << 8) | buf[sz + 1];
+		if (icrc != crc)
+			return -EBADMSG;
+	}
+
+	return 0;
+}
+
+/* Internal function to extend nframes raw serial frames, stored back to back
+ * in src, to one 32-bit word per channel. src may alias the start of data. */
+static int32_t ad7606_unpack_frames(struct ad7606_dev *dev, const uint8_t *src,
+				    uint32_t nframes, uint32_t *data)
+{
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
+
+	return ad7606_unpack(src, nframes * nchannels, ad7606_frame_width(dev),
+			     data);
+}
+
 /***************************************************************************//**
  * @brief Read conversion data.
  *
@@ -637,70 +756,88 @@ int32_t ad7606_convst(struct ad7606_dev *dev)
 *******************************************************************************/
 int32_t ad7606_spi_data_read(struct ad7606_dev *dev, uint32_t *data)
 {
-	uint32_t sz;
-	int32_t ret, i;
-	uint16_t crc, icrc;
-	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
-	uint8_t sbits = dev->config.status_header ? 8 : 0;
-	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
-
-	sz = nchannels * (bits + sbits);
-
-	/* Number of bits to read, corresponds to SCLK cycles in transfer.
-	 * This should always be a multiple of 8 to work with most SPI's.
-	 * With this chip family this holds true because we either:
-	 *  - multiply 8 channels * bits per sample
-	 *  - multiply 4 channels * bits per sample (always multiple of 2)
-	 * Therefore, due to design reasons, we don't check for the
-	 * remainder of this division because it is zero by design.
-	 */
-	sz /= 8;
-
-	if (dev->digital_diag_enable.int_crc_err_en) {
-		sz += 2;
-	}
+	int32_t ret;
 
-	memset(dev->data, 0, sz);
-	ret = no_os_spi_write_and_read(dev->spi_desc, dev->data, sz);
+	ret = ad7606_spi_frame_read(dev, dev->data);
 	if (ret < 0)
 		return ret;
 
-	if (dev->digital_diag_enable.int_crc_err_en) {
-		sz -= 2;
-		crc = no_os_crc16(ad7606_crc16, dev->data, sz, 0);
-		icrc = ((uint16_t)dev->data[sz] << 8) |
-		       dev->data[sz + 1];
-		if (icrc != crc)
-			return -EBADMSG;
-	}
+	return ad7606_unpack_frames(dev, dev->data, 1, data);
+}
 
-	switch (bits) {
-	case 18:
-		if (dev->config.status_header)
-			ret = cpy26b32b(dev->data, sz, data);
+/*
+ * Internal function to split the status header from nframes unpacked frames
+ * and to sign extend the samples of the bipolar channels. raw and data may
+ * point to the same buffer.
+ */
+static void ad7606_correct_frames(struct ad7606_dev *dev, const uint32_t *raw,
+				  uint32_t nframes, int32_t *data, uint8_t *status)
+{
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
+	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
+	uint8_t shift[AD7606_MAX_CHANNELS];
+	uint32_t i, j, val;
+
+	/* Sign extend with a shift pair, no shift for the unipolar channels */
+	for (j = 0; j < nchannels; j++) {
+		if (dev->range_ch_type[j] == AD7606_SW_RANGE_SINGLE_ENDED_UNIPOLAR)
+			shift[j] = 0;
 		else
-			ret = cpy18b32b(dev->data, sz, data);
-		if (ret < 0)
-			return ret;
-		break;
-	case 16:
-		for (i = 0; i < nchannels; i++) {
+			shift[j] = 32 - bits;
+	}
+
+	for (i = 0; i < nframes; i++) {
+		for (j = 0; j < nchannels; j++) {
+			val = raw[j];
 			if (dev->config.status_header) {
-				data[i] = (uint32_t)dev->data[i * 3] << 16;
-				data[i] |= (uint32_t)dev->data[i * 3 + 1] << 8;
-				data[i] |= (uint32_t)dev->data[i * 3 + 2];
-			} else {
-				data[i] = (uint32_t)dev->data[i * 2] << 8;
-				data[i] |= (uint32_t)dev->data[i * 2 + 1];
+				if (status)
+					*status++ = val & 0xff;
+				val >>= 8;
 			}
+			data[j] = (int32_t)(val << shift[j]) >> shift[j];
 		}
-		break;
-	default:
-		ret = -ENOTSUP;
-		break;
-	};
+		raw += nchannels;
+		data += nchannels;
+	}
+}
 
-	return ret;
+/***************************************************************************//**
+ * @brief Decode raw serial frames into signed samples.
+ *
+ * The frames are expected back to back, as clocked out on the serial
+ * interface and without the CRC bytes. The samples are sign extended, except
+ * for the channels set to a single-ended unipolar range, and the status
+ * header, if enabled, is split from the samples.
+ *
+ * @param dev        - The device structure.
+ * @param frames     - Pointer to the raw frames.
+ * @param nframes    - Number of frames to decode.
+ * @param data       - Pointer to the output buffer, nframes samples of each
+ *                     channel.
+ * @param status     - Pointer to the status output buffer, same layout as data.
+ *                     Can be NULL if the status is not needed.
+ *
+ * @return ret - return code.
+ *         Example: -EINVAL - Invalid parameters.
+ *                  -ENOTSUP - Device bits per sample not supported.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_decode_frames(struct ad7606_dev *dev, const uint8_t *frames,
+			     uint32_t nframes, int32_t *data, uint8_t *status)
+{
+	uint32_t *raw = (uint32_t *)data;
+	int32_t ret;
+
+	if (!frames || !data)
+		return -EINVAL;
+
+	ret = ad7606_unpack_frames(dev, frames, nframes, raw);
+	if (ret)
+		return ret;
+
+	ad7606_correct_frames(dev, raw, nframes, data, status);
+
+	return 0;
 }
 
 /***************************************************************************//**
@@ -888,23 +1025,8 @@ error:
 #endif
 }
 
-/***************************************************************************//**
- * @brief Blocking conversion start and read data (for a single sample from all
- *        channels).
- *
- * This function performs a conversion start and then proceeds to reading
- * the conversion data.
- *
- * @param dev        - The device structure.
- * @param data       - Pointer to location of buffer where to store the data.
- *
- * @return ret - return code.
- *         Example: -EIO - SPI communication error.
- *                  -ETIME - Timeout while waiting for the BUSY signal.
- *                  -EBADMSG - CRC computation mismatch.
- *                  0 - No errors encountered.
-*******************************************************************************/
-int32_t ad7606_read_one_sample(struct ad7606_dev *dev, uint32_t * data)
+/* Internal function to start a conversion and wait for it to complete. */
+static int32_t ad7606_convst_wait(struct ad7606_dev *dev)
 {
 	int32_t ret;
 	uint8_t busy;
@@ -935,6 +1057,33 @@ int32_t ad7606_read_one_sample(struct ad7606_dev *dev, uint32_t * data)
 		no_os_udelay(tconv_max[dev->oversampling.os_ratio]);
 	}
 
+	return 0;
+}
+
+/***************************************************************************//**
+ * @brief Blocking conversion start and read data (for a single sample from all
+ *        channels).
+ *
+ * This function performs a conversion start and then proceeds to reading
+ * the conversion data.
+ *
+ * @param dev        - The device structure.
+ * @param data       - Pointer to location of buffer where to store the data.
+ *
+ * @return ret - return code.
+ *         Example: -EIO - SPI communication error.
+ *                  -ETIME - Timeout while waiting for the BUSY signal.
+ *                  -EBADMSG - CRC computation mismatch.
+ *                  0 - No errors encountered.
+*******************************************************************************/
+int32_t ad7606_read_one_sample(struct ad7606_dev *dev, uint32_t * data)
+{
+	int32_t ret;
+
+	ret = ad7606_convst_wait(dev);
+	if (ret < 0)
+		return ret;
+
 	return ad7606_spi_data_read(dev, data);
 }
 
@@ -986,51 +1135,71 @@ void ad7606_capture_post_disable(struct ad7606_dev *dev)
  * This function performs a series of conversion starts and then proceeds to
  * reading the conversion data (after each conversion).
  *
+ * Without an AXI interface, the raw frames are stored back to back at the
+ * start of the output buffer and they are all decoded in a single pass once
+ * the capture is done, so that the time between conversions is only spent
+ * on the SPI transfers.
+ *
  * @param dev        - The device structure.
  * @param data       - Pointer to location of buffer where to store the data.
- * @param samples    - Number of samples to read
+ * @param samples    - Number of samples to read, from all channels. Must be
+ *                     a multiple of the number of channels.
  *
  * @return ret - return code.
  *         Example: -EIO - SPI communication error.
  *                  -ETIME - Timeout while waiting for the BUSY signal.
  *                  -EBADMSG - CRC computation mismatch.
+ *                  -EINVAL - Invalid number of samples.
  *                  0 - No errors encountered.
 *******************************************************************************/
 int32_t ad7606_read_samples(struct ad7606_dev *dev, uint32_t * data,
 			    uint32_t samples)
 {
+	uint8_t nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
+	uint8_t *raw = (uint8_t *)data;
+	uint32_t nframes, sz, i;
+	int32_t ret;
 #ifdef XILINX_PLATFORM
 	struct ad7606_axi_dev *axi = &dev->axi_dev;
-	uint32_t nchannels, i, sample_size;
-	int32_t ret;
 
-	if (dev->reg_mode) {
-		/* Enter ADC reading mode by writing at address zero. */
-		ret = ad7606_reg_write(dev, 0, 0);
-		if (ret < 0)
-			return ret;
+	if (axi->initialized) {
+		if (dev->reg_mode) {
+			/* Enter ADC reading mode by writing at address zero. */
+			ret = ad7606_reg_write(dev, 0, 0);
+			if (ret < 0)
+				return ret;
 
-		dev->reg_mode = false;
-	}
+			dev->reg_mode = false;
+		}
 
-	if (axi->initialized) {
 		if (dev->parallel_interface)
 			return ad7606_read_raw_data_parallel(dev, data, samples);
 		return ad7606_read_raw_data_spi_engine(dev, data, samples);
 	}
+#endif
 
-	nchannels = ad7606_chip_info_tbl[dev->device_id].num_channels;
-	sample_size = nchannels * sizeof(uint32_t);
+	if (samples % nchannels)
+		return -EINVAL;
 
-	for (i = 0; i < samples; i++) {
-		ret = ad7606_read_one_sample(dev, data);
-		if (ret)
+	nframes = samples / nchannels;
+	sz = ad7606_frame_size(dev);
+
+	/*
+	 * A frame, with its CRC, is never larger than its decoded samples, so
+	 * the frames fit in the output buffer. The CRC of a frame is checked
+	 * before being overwritten by the next frame.
+	 */
+	for (i = 0; i < nframes; i++) {
+		ret = ad7606_convst_wait(dev);
+		if (ret < 0)
+			return ret;
+
+		ret = ad7606_spi_frame_read(dev, raw + i * sz);
+		if (ret < 0)
 			return ret;
-		data += sample_size;
 	}
-#endif
 
-	return 0;
+	return ad7606_unpack_frames(dev, raw, nframes, data);
 }
 
 /* Internal function to reset device settings to default state after chip reset. */
@@ -1107,6 +1276,75 @@ int32_t ad7606_reset(struct ad7606_dev *dev)
 	return ret;
 }
 
+/* Internal function that initializes the oversampling GPIOs. */
+static int32_t ad7606_request_os_gpios(struct ad7606_dev *dev,
+				       struct ad7606_init_param *init_param)
+{
+	int32_t ret;
+
+	if (init_param->gpio_os) {
+		if (init_param->gpio_os->num != 3)
+			return -EINVAL;
+
+		ret = no_os_gpio_group_get(&dev->gpio_os, init_param->gpio_os);
+		if (ret < 0)
+			return ret;
+
+		return no_os_gpio_group_direction_output(dev->gpio_os, 0);
+	}
+
+	ret = no_os_gpio_get_optional(&dev->gpio_os0, init_param->gpio_os0);
+	if (ret < 0)
+		return ret;
+
+	if (dev->gpio_os0) {
+		ret = no_os_gpio_direction_output(dev->gpio_os0, NO_OS_GPIO_LOW);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = no_os_gpio_get_optional(&dev->gpio_os1, init_param->gpio_os1);
+	if (ret < 0)
+		return ret;
+
+	if (dev->gpio_os1) {
+		ret = no_os_gpio_direction_output(dev->gpio_os1, NO_OS_GPIO_LOW);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = no_os_gpio_get_optional(&dev->gpio_os2, init_param->gpio_os2);
+	if (ret < 0)
+		return ret;
+
+	if (dev->gpio_os2) {
+		ret = no_os_gpio_direction_output(dev->gpio_os2, NO_OS_GPIO_LOW);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* Internal function that sets OS[2:0] to the bits of val. */
+static int32_t ad7606_set_os_pins(struct ad7606_dev *dev, uint8_t val)
+{
+	int32_t ret;
+
+	if (dev->gpio_os)
+		return no_os_gpio_group_set_values(dev->gpio_os, 0x07, val);
+
+	ret = no_os_gpio_set_value(dev->gpio_os0, (val & 0x01) >> 0);
+	if (ret < 0)
+		return ret;
+
+	ret = no_os_gpio_set_value(dev->gpio_os1, (val & 0x02) >> 1);
+	if (ret < 0)
+		return ret;
+
+	return no_os_gpio_set_value(dev->gpio_os2, (val & 0x04) >> 2);
+}
+
 /* Internal function that initializes GPIOs. */
 static int32_t ad7606_request_gpios(struct ad7606_dev *dev,
 				    struct ad7606_init_param *init_param)
@@ -1166,36 +1404,10 @@ static int32_t ad7606_request_gpios(struct ad7606_dev *dev,
 	if (!ad7606_chip_info_tbl[dev->device_id].has_oversampling)
 		return ret;
 
-	ret = no_os_gpio_get_optional(&dev->gpio_os0, init_param->gpio_os0);
+	ret = ad7606_request_os_gpios(dev, init_param);
 	if (ret < 0)
 		return ret;
 
-	if (dev->gpio_os0) {
-		ret = no_os_gpio_direction_output(dev->gpio_os0, NO_OS_GPIO_LOW);
-		if (ret < 0)
-			return ret;
-	}
-
-	ret = no_os_gpio_get_optional(&dev->gpio_os1, init_param->gpio_os1);
-	if (ret < 0)
-		return ret;
-
-	if (dev->gpio_os1) {
-		ret = no_os_gpio_direction_output(dev->gpio_os1, NO_OS_GPIO_LOW);
-		if (ret < 0)
-			return ret;
-	}
-
-	ret = no_os_gpio_get_optional(&dev->gpio_os2, init_param->gpio_os2);
-	if (ret < 0)
-		return ret;
-
-	if (dev->gpio_os2) {
-		ret = no_os_gpio_direction_output(dev->gpio_os2, NO_OS_GPIO_LOW);
-		if (ret < 0)
-			return ret;
-	}
-
 	ret = no_os_gpio_get_optional(&dev->gpio_par_ser, init_param->gpio_par_ser);
 	if (ret < 0)
 		return ret;
@@ -1249,18 +1461,7 @@ int32_t ad7606_set_oversampling(struct ad7606_dev *dev,
 		if (oversampling.os_ratio > AD7606_OSR_64)
 			oversampling.os_ratio = AD7606_OSR_64;
 
-		ret = no_os_gpio_set_value(dev->gpio_os0,
-					   ((oversampling.os_ratio & 0x01) >> 0));
-		if (ret < 0)
-			return ret;
-
-		ret = no_os_gpio_set_value(dev->gpio_os1,
-					   ((oversampling.os_ratio & 0x02) >> 1));
-		if (ret < 0)
-			return ret;
-
-		ret = no_os_gpio_set_value(dev->gpio_os2,
-					   ((oversampling.os_ratio & 0x04) >> 2));
+		ret = ad7606_set_os_pins(dev, oversampling.os_ratio);
 		if (ret < 0)
 			return ret;
 	}
@@ -1781,7 +1982,7 @@ int32_t ad7606_init(struct ad7606_dev **device,
 	int32_t i, ret;
 
 	no_os_crc8_populate_msb(ad7606_crc8, 0x7);
-	no_os_crc16_populate_msb(ad7606_crc16, 0x755b);
+	no_os_crc16_populate_msb_slice(ad7606_crc16, 0x755b);
 
 	dev = (struct ad7606_dev *)no_os_calloc(1, sizeof(*dev));
 	if (!dev)
@@ -1820,15 +2021,7 @@ int32_t ad7606_init(struct ad7606_dev **device,
 		goto error;
 
 	if (dev->sw_mode) {
-		ret = no_os_gpio_set_value(dev->gpio_os0, NO_OS_GPIO_HIGH);
-		if (ret < 0)
-			goto error;
-
-		ret = no_os_gpio_set_value(dev->gpio_os1, NO_OS_GPIO_HIGH);
-		if (ret < 0)
-			goto error;
-
-		ret = no_os_gpio_set_value(dev->gpio_os2, NO_OS_GPIO_HIGH);
+		ret = ad7606_set_os_pins(dev, 0x07);
 		if (ret < 0)
 			goto error;
 	}
@@ -1929,6 +2122,8 @@ error:
  *        2. split data and status information into 2 arrays
  *        note: this function should be called after read a sample through spi
  *              serial interface( parallel interface not supported yet)
+ *        It applies the same correction as ad7606_decode_frames(), to a
+ *        frame already unpacked by ad7606_spi_data_read().
  *
  * @param dev          - The device structure.
  * @param buf          - pointer to data buffer read by spi.
@@ -1944,36 +2139,13 @@ error:
 int32_t ad7606_data_correction_serial(struct ad7606_dev *dev,
 				      uint32_t *buf, int32_t *data, uint8_t *status)
 {
-	uint8_t i = 0;
-	uint8_t num_ch = dev->num_channels;
-	uint32_t *pbuf = buf;
-	uint8_t bits = ad7606_chip_info_tbl[dev->device_id].bits;
-
-	if (dev->config.status_header) {
-		// validate status pointers
-		if (!status)
-			return EINVAL;
+	if (!buf || !data)
+		return -EINVAL;
 
-		for (i = 0; i < num_ch; i++) {
-			*status = (uint8_t) * pbuf | 0xff;
-			*pbuf = *pbuf >> 8;
-			pbuf++;
-			status++;
-		}
-	}
+	if (dev->config.status_header && !status)
+		return -EINVAL;
 
-	// validate data pointers
-	if (!status)
-		return EINVAL;
-
-	// correct negative data value
-	for (i = 0; i < num_ch; i++) {
-		// if negative value exist (hardware/bipolar)
-		if (dev->range_ch_type[i] != AD7606_SW_RANGE_SINGLE_ENDED_UNIPOLAR)
-			*data = no_os_sign_extend32(*buf, bits - 1);
-		buf++;
-		data++;
-	}
+	ad7606_correct_frames(dev, buf, 1, data, status);
 
 	return 0;
 }
@@ -2024,6 +2196,7 @@ int32_t ad7606_remove(struct ad7606_dev *dev)
 	no_os_gpio_remove(dev->gpio_os0);
 	no_os_gpio_remove(dev->gpio_os1);
 	no_os_gpio_remove(dev->gpio_os2);
+	no_os_gpio_group_remove(dev->gpio_os);
 	no_os_gpio_remove(dev->gpio_par_ser);
 
 	if (!dev->parallel_interface)
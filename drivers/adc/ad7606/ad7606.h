@@ -325,6 +325,8 @@ struct ad7606_dev {
 	struct no_os_gpio_desc *gpio_os1;
 	/** OS2 GPIO descriptor */
 	struct no_os_gpio_desc *gpio_os2;
+	/** OS[2:0] GPIO group descriptor, used instead of gpio_os0..2 if set */
+	struct no_os_gpio_group_desc *gpio_os;
 	/** PARn/SER GPIO descriptor */
 	struct no_os_gpio_desc *gpio_par_ser;
 	/** Device ID */
@@ -409,6 +411,11 @@ struct ad7606_init_param {
 	struct no_os_gpio_init_param *gpio_os1;
 	/** OS2 GPIO initialization parameters */
 	struct no_os_gpio_init_param *gpio_os2;
+	/**
+	 * OS[2:0] GPIO group initialization parameters (OS0 first). If set, it
+	 * is used instead of gpio_os0..2 and the pins are updated together.
+	 */
+	struct no_os_gpio_group_init_param *gpio_os;
 	/** PARn/SER GPIO initialization parameters */
 	struct no_os_gpio_init_param *gpio_par_ser;
 	/** Device ID */
@@ -459,6 +466,11 @@ int32_t ad7606_spi_data_read(struct ad7606_dev *dev,
 int32_t ad7606_read_samples(struct ad7606_dev *dev,
 			    uint32_t *data,
 			    uint32_t samples);
+int32_t ad7606_decode_frames(struct ad7606_dev *dev,
+			     const uint8_t *frames,
+			     uint32_t nframes,
+			     int32_t *data,
+			     uint8_t *status);
 int32_t ad7606_convst(struct ad7606_dev *dev);
 int32_t ad7606_reset(struct ad7606_dev *dev);
 int32_t ad7606_set_oversampling(struct ad7606_dev *dev,
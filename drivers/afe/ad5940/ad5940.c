@@ -656,18 +656,15 @@ static int AD5940_FIFORd_Fast(struct no_os_spi_desc *spi, uint32_t *pBuffer,
 	uint32_t i = 0;
 	uint32_t s = 0;
 
-	if (!iobuf_alloc_sz) {
-		iobuf = no_os_malloc(iobuf_sz);
-		if (!iobuf)
-			return -ENOMEM;
-	}
-
+	/* Grown as needed, its content is rewritten below */
 	if (iobuf_alloc_sz < iobuf_sz) {
-		buf = realloc(iobuf, iobuf_sz);
+		buf = no_os_malloc(iobuf_sz);
 		if (!buf)
 			return -ENOMEM;
 
+		no_os_free(iobuf);
 		iobuf = buf;
+		iobuf_alloc_sz = iobuf_sz;
 	}
 
 	// zero-out everything, needed for bytes 1 through 6 (dummy bytes).
@@ -47,30 +47,31 @@
 static void default_sg_callback(void *context)
 {
 	struct no_os_dma_default_handler_data *data = context;
-	struct no_os_dma_xfer_desc *next_xfer;
+	struct no_os_dma_xfer_desc *next_xfer = NULL;
 	struct no_os_dma_xfer_desc *old_xfer;
-	uint32_t list_size;
-	int ret;
+	struct no_os_list_node *node;
 
 	/* Handle the next transfer from the SG list */
-	ret = no_os_list_get_first(data->channel->sg_list, (void **)&old_xfer);
-	if (ret) {
+	node = no_os_list_node_pop_first(&data->channel->sg_list);
+	if (!node) {
 		/*
-		 * This should only happen if the list descriptor is NULL.
 		 * The case in which there is no transfer left in the list should
 		 * have been handled in the previous interrupt.
 		 */
 		no_os_dma_xfer_abort(data->desc, data->channel);
 		return;
 	}
+	old_xfer = no_os_list_entry(node, struct no_os_dma_xfer_desc, node);
+
+	node = no_os_list_node_first(&data->channel->sg_list);
+	if (node)
+		next_xfer = no_os_list_entry(node, struct no_os_dma_xfer_desc, node);
 
-	no_os_list_read_first(data->channel->sg_list, (void **)&next_xfer);
-	no_os_list_get_size(data->channel->sg_list, &list_size);
 	if (old_xfer->xfer_complete_cb)
 		old_xfer->xfer_complete_cb(old_xfer, next_xfer,
 					   old_xfer->xfer_complete_ctx);
 
-	if (!list_size) {
+	if (!next_xfer) {
 		no_os_irq_disable(data->desc->irq_ctrl, data->channel->irq_num);
 		data->channel->free = true;
 		return;
@@ -91,7 +92,7 @@ int no_os_dma_init(struct no_os_dma_desc **desc,
 		   struct no_os_dma_init_param *param)
 {
 	int ret;
-	uint32_t i, j;
+	uint32_t i;
 	void *mutex;
 
 	if (!param || !param->platform_ops)
@@ -112,23 +113,11 @@ int no_os_dma_init(struct no_os_dma_desc **desc,
 	(*desc)->platform_ops = param->platform_ops;
 
 	for (i = 0; i < param->num_ch; i++) {
-		ret = no_os_list_init(&(*desc)->channels[i].sg_list, NO_OS_LIST_QUEUE, NULL);
-		if (ret)
-			goto list_err;
-
+		no_os_list_node_init(&(*desc)->channels[i].sg_list);
 		no_os_mutex_init(&(*desc)->channels[i].mutex);
 	}
 
 	(*desc)->ref++;
-	no_os_mutex_unlock(mutex);
-
-	return 0;
-
-list_err:
-	for (j = 0; j < i; j++)
-		no_os_list_remove((*desc)->channels[i].sg_list);
-
-	no_os_dma_remove(*desc);
 unlock:
 	no_os_mutex_unlock(mutex);
 
@@ -152,10 +141,7 @@ int no_os_dma_remove(struct no_os_dma_desc *desc)
 		return 0;
 
 	for (i = 0; i < desc->num_ch; i++) {
-		ret = no_os_list_remove(desc->channels[i].sg_list);
-		if (ret)
-			return ret;
-
+		no_os_list_node_init(&desc->channels[i].sg_list);
 		no_os_mutex_remove(desc->channels[i].mutex);
 		if (desc->irq_ctrl && desc->channels[i].cb_desc.handle) {
 			no_os_irq_unregister_callback(desc->irq_ctrl,
@@ -245,7 +231,6 @@ int no_os_dma_config_xfer(struct no_os_dma_desc *desc,
 {
 	uint32_t i;
 	int ret;
-	void *discard;
 	struct no_os_callback_desc *sg_callback;
 
 	if (!desc || !xfer || !len || !ch)
@@ -258,7 +243,7 @@ int no_os_dma_config_xfer(struct no_os_dma_desc *desc,
 	 * there are no ongoing transfers on this channel.
 	 */
 	for (i = 0; i < len; i++)
-		no_os_list_add_last(ch->sg_list, &xfer[i]);
+		no_os_list_node_add_last(&ch->sg_list, &xfer[i].node);
 
 	if (desc->irq_ctrl) {
 		sg_callback = &ch->cb_desc;
@@ -303,7 +288,7 @@ int no_os_dma_config_xfer(struct no_os_dma_desc *desc,
 	return 0;
 err:
 	for (i = 0; i < len; i++)
-		no_os_list_get_first(ch->sg_list, &discard);
+		no_os_list_node_pop_first(&ch->sg_list);
 	no_os_mutex_unlock(ch->mutex);
 
 	return ret;
@@ -383,7 +368,6 @@ int no_os_dma_xfer_start(struct no_os_dma_desc *desc, struct no_os_dma_ch *ch)
  */
 int no_os_dma_xfer_abort(struct no_os_dma_desc *desc, struct no_os_dma_ch *ch)
 {
-	void *discard;
 	int ret;
 
 	if (!desc || !desc->platform_ops || !ch)
@@ -397,9 +381,8 @@ int no_os_dma_xfer_abort(struct no_os_dma_desc *desc, struct no_os_dma_ch *ch)
 	if (desc->irq_ctrl)
 		no_os_irq_disable(desc->irq_ctrl, ch->irq_num);
 
-	do {
-		ret = no_os_list_get_first(ch->sg_list, &discard);
-	} while (!ret);
+	while (no_os_list_node_pop_first(&ch->sg_list))
+		;
 
 	ret = desc->platform_ops->dma_xfer_abort(desc, ch);
 
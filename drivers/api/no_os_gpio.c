@@ -35,6 +35,8 @@
 #include "no_os_gpio.h"
 #include <stdlib.h>
 #include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_util.h"
 
 /**
  * @brief Obtain the GPIO decriptor.
@@ -229,3 +231,273 @@ int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 
 	return 0;
 }
+
+/**
+ * @brief Free the per GPIO descriptors of an emulated GPIO group.
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_gpio_group_free(struct no_os_gpio_group_desc *desc)
+{
+	int32_t ret = 0;
+	int32_t err;
+	uint32_t i;
+
+	for (i = 0; i < desc->num; i++) {
+		err = no_os_gpio_remove(desc->gpios[i]);
+		if (err && !ret)
+			ret = err;
+	}
+
+	no_os_free(desc->gpios);
+	no_os_free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Obtain a descriptor for a group of GPIOs of the same port.
+ *
+ * Bit n of the values passed to or returned by the group functions maps to
+ * param->numbers[n]. Platforms implementing the group operations update all
+ * the GPIOs of the group at once, otherwise the group is handled one GPIO at
+ * a time.
+ *
+ * @param desc - The GPIO group descriptor.
+ * @param param - GPIO group initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_get(struct no_os_gpio_group_desc **desc,
+			     const struct no_os_gpio_group_init_param *param)
+{
+	struct no_os_gpio_group_desc *group;
+	struct no_os_gpio_init_param gpio_param;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !param || !param->platform_ops || !param->numbers)
+		return -EINVAL;
+
+	if (!param->num || param->num > NO_OS_GPIO_GROUP_MAX)
+		return -EINVAL;
+
+	if (param->platform_ops->gpio_ops_group_get) {
+		ret = param->platform_ops->gpio_ops_group_get(desc, param);
+		if (ret)
+			return ret;
+
+		(*desc)->platform_ops = param->platform_ops;
+
+		return 0;
+	}
+
+	if (!param->platform_ops->gpio_ops_get)
+		return -ENOSYS;
+
+	group = no_os_calloc(1, sizeof(*group));
+	if (!group)
+		return -ENOMEM;
+
+	group->gpios = no_os_calloc(param->num, sizeof(*group->gpios));
+	if (!group->gpios) {
+		no_os_free(group);
+		return -ENOMEM;
+	}
+
+	gpio_param.port = param->port;
+	gpio_param.pull = param->pull;
+	gpio_param.platform_ops = param->platform_ops;
+	gpio_param.extra = param->extra;
+
+	for (i = 0; i < param->num; i++) {
+		gpio_param.number = param->numbers[i];
+		ret = no_os_gpio_get(&group->gpios[i], &gpio_param);
+		if (ret) {
+			group->num = i;
+			no_os_gpio_group_free(group);
+			return ret;
+		}
+		group->numbers[i] = param->numbers[i];
+	}
+
+	group->port = param->port;
+	group->num = param->num;
+	group->pull = param->pull;
+	group->platform_ops = param->platform_ops;
+	*desc = group;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_gpio_group_get().
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_remove(struct no_os_gpio_group_desc *desc)
+{
+	if (!desc)
+		return 0;
+
+	if (desc->gpios)
+		return no_os_gpio_group_free(desc);
+
+	if (!desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->gpio_ops_group_remove)
+		return -ENOSYS;
+
+	return desc->platform_ops->gpio_ops_group_remove(desc);
+}
+
+/**
+ * @brief Enable the input direction of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_direction_input(struct no_os_gpio_group_desc *desc)
+{
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->gpios) {
+		for (i = 0; i < desc->num; i++) {
+			ret = no_os_gpio_direction_input(desc->gpios[i]);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	if (!desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->gpio_ops_group_direction_input)
+		return -ENOSYS;
+
+	return desc->platform_ops->gpio_ops_group_direction_input(desc);
+}
+
+/**
+ * @brief Enable the output direction of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Initial output values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_direction_output(struct no_os_gpio_group_desc *desc,
+		uint32_t values)
+{
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->gpios) {
+		for (i = 0; i < desc->num; i++) {
+			ret = no_os_gpio_direction_output(desc->gpios[i],
+							  (values >> i) & 1);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	if (!desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->gpio_ops_group_direction_output)
+		return -ENOSYS;
+
+	return desc->platform_ops->gpio_ops_group_direction_output(desc, values);
+}
+
+/**
+ * @brief Set the GPIOs of the group selected by mask.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - GPIOs to be updated, bit n for GPIO n of the group.
+ * @param values - New values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_set_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t values)
+{
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc)
+		return -EINVAL;
+
+	if (desc->num < NO_OS_GPIO_GROUP_MAX)
+		mask &= NO_OS_BIT(desc->num) - 1;
+	if (!mask)
+		return 0;
+
+	if (desc->gpios) {
+		for (i = 0; i < desc->num; i++) {
+			if (!(mask & NO_OS_BIT(i)))
+				continue;
+
+			ret = no_os_gpio_set_value(desc->gpios[i],
+						   (values >> i) & 1);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	if (!desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->gpio_ops_group_set_values)
+		return -ENOSYS;
+
+	return desc->platform_ops->gpio_ops_group_set_values(desc, mask,
+			values);
+}
+
+/**
+ * @brief Get the values of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Read values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_gpio_group_get_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t *values)
+{
+	uint8_t value;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !values)
+		return -EINVAL;
+
+	if (desc->gpios) {
+		*values = 0;
+		for (i = 0; i < desc->num; i++) {
+			ret = no_os_gpio_get_value(desc->gpios[i], &value);
+			if (ret)
+				return ret;
+
+			if (value)
+				*values |= NO_OS_BIT(i);
+		}
+
+		return 0;
+	}
+
+	if (!desc->platform_ops)
+		return -EINVAL;
+
+	if (!desc->platform_ops->gpio_ops_group_get_values)
+		return -ENOSYS;
+
+	return desc->platform_ops->gpio_ops_group_get_values(desc, values);
+}
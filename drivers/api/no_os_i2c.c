@@ -34,9 +34,11 @@
 #include <inttypes.h>
 #include "no_os_i2c.h"
 #include <stdlib.h>
+#include <stdbool.h>
 #include "no_os_error.h"
 #include "no_os_mutex.h"
 #include "no_os_alloc.h"
+#include "no_os_util.h"
 
 /**
  * @brief i2c_table contains the pointers towards the i2c buses
@@ -207,3 +209,70 @@ int32_t no_os_i2c_read(struct no_os_i2c_desc *desc,
 
 	return ret;
 }
+
+/**
+ * @brief Send messages as one combined I2C transaction, like the Linux
+ * I2C_RDWR ioctl. The messages are separated by repeated starts and a stop is
+ * generated after the last one. The bus is locked for the whole transaction.
+ * Platforms without a transfer operation use the read/write ones. There, a
+ * read longer than 255 bytes is done in chunks separated by repeated starts,
+ * which devices with an auto-incremented address (like EEPROMs) read as one,
+ * and a write longer than 255 bytes is not supported.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param nb_msgs - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t nb_msgs)
+{
+	const struct no_os_i2c_platform_ops *ops;
+	uint32_t offset;
+	uint32_t len;
+	uint32_t i;
+	bool last;
+	int32_t ret = 0;
+
+	if (!desc || !desc->platform_ops || !msgs || !nb_msgs)
+		return -EINVAL;
+
+	ops = desc->platform_ops;
+	if (ops->i2c_ops_transfer) {
+		no_os_mutex_lock(desc->bus->mutex);
+		ret = ops->i2c_ops_transfer(desc, msgs, nb_msgs);
+		no_os_mutex_unlock(desc->bus->mutex);
+
+		return ret;
+	}
+
+	if (!ops->i2c_ops_write || !ops->i2c_ops_read)
+		return -ENOSYS;
+
+	for (i = 0; i < nb_msgs; i++)
+		if (!(msgs[i].flags & NO_OS_I2C_M_RD) && msgs[i].len > UINT8_MAX)
+			return -EINVAL;
+
+	no_os_mutex_lock(desc->bus->mutex);
+	for (i = 0; i < nb_msgs; i++) {
+		offset = 0;
+		do {
+			len = no_os_min(msgs[i].len - offset, (uint32_t)UINT8_MAX);
+			last = (i == nb_msgs - 1) && (offset + len == msgs[i].len);
+			if (msgs[i].flags & NO_OS_I2C_M_RD)
+				ret = ops->i2c_ops_read(desc, msgs[i].buf + offset,
+							len, last);
+			else
+				ret = ops->i2c_ops_write(desc, msgs[i].buf + offset,
+							 len, last);
+			if (ret)
+				goto out;
+			offset += len;
+		} while (offset < msgs[i].len);
+	}
+
+out:
+	no_os_mutex_unlock(desc->bus->mutex);
+
+	return ret;
+}
@@ -0,0 +1,619 @@
+/***************************************************************************//**
+ *   @file   no_os_regmap.c
+ *   @brief  Register map with write-through cache, on top of the bus APIs.
+********************************************************************************
+ *   @copyright
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <string.h>
+#include "no_os_regmap.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_alloc.h"
+
+static bool no_os_regmap_in_table(const struct no_os_regmap_table *table,
+				  uint32_t reg)
+{
+	uint32_t i;
+
+	for (i = 0; i < table->nb_ranges; i++)
+		if (reg >= table->ranges[i].min && reg <= table->ranges[i].max)
+			return true;
+
+	return false;
+}
+
+static bool no_os_regmap_readable(struct no_os_regmap *map, uint32_t reg)
+{
+	if (reg > map->max_register)
+		return false;
+
+	return !map->rd_table || no_os_regmap_in_table(map->rd_table, reg);
+}
+
+static bool no_os_regmap_writeable(struct no_os_regmap *map, uint32_t reg)
+{
+	if (reg > map->max_register)
+		return false;
+
+	return !map->wr_table || no_os_regmap_in_table(map->wr_table, reg);
+}
+
+/* Whether the value of reg is kept in the cache */
+static bool no_os_regmap_cacheable(struct no_os_regmap *map, uint32_t reg)
+{
+	if (map->cache_type == NO_OS_REGMAP_CACHE_NONE)
+		return false;
+
+	return !map->volatile_table ||
+	       !no_os_regmap_in_table(map->volatile_table, reg);
+}
+
+static bool no_os_regmap_bit(const uint32_t *bitmap, uint32_t bit)
+{
+	return bitmap[bit / 32] & (1U << (bit % 32));
+}
+
+static void no_os_regmap_assign_bit(uint32_t *bitmap, uint32_t bit, bool set)
+{
+	if (set)
+		bitmap[bit / 32] |= (1U << (bit % 32));
+	else
+		bitmap[bit / 32] &= ~(1U << (bit % 32));
+}
+
+static uint32_t no_os_regmap_cache_get(struct no_os_regmap *map, uint32_t reg)
+{
+	switch (map->val_bytes) {
+	case 1:
+		return ((uint8_t *)map->cache)[reg];
+	case 2:
+		return ((uint16_t *)map->cache)[reg];
+	default:
+		return ((uint32_t *)map->cache)[reg];
+	}
+}
+
+/* Store the value of a cacheable register, dirty if not on the device yet */
+static void no_os_regmap_cache_set(struct no_os_regmap *map, uint32_t reg,
+				   uint32_t val, bool dirty)
+{
+	switch (map->val_bytes) {
+	case 1:
+		((uint8_t *)map->cache)[reg] = val;
+		break;
+	case 2:
+		((uint16_t *)map->cache)[reg] = val;
+		break;
+	default:
+		((uint32_t *)map->cache)[reg] = val;
+		break;
+	}
+
+	no_os_regmap_assign_bit(map->cache_valid, reg, true);
+	no_os_regmap_assign_bit(map->cache_dirty, reg, dirty);
+}
+
+/* Number of registers moved by one bus transaction */
+static uint32_t no_os_regmap_burst_len(struct no_os_regmap *map)
+{
+	if (!map->burst || !map->bus_ops->bulk_read)
+		return 1;
+
+	return NO_OS_REGMAP_BURST_MAX / map->val_bytes;
+}
+
+static void no_os_regmap_format_val(struct no_os_regmap *map, uint8_t *buf,
+				    uint32_t val)
+{
+	uint8_t i;
+
+	for (i = map->val_bytes; i > 0; i--) {
+		buf[i - 1] = val & 0xFF;
+		val >>= 8;
+	}
+}
+
+static uint32_t no_os_regmap_parse_val(struct no_os_regmap *map,
+				       const uint8_t *buf)
+{
+	uint32_t val = 0;
+	uint8_t i;
+
+	for (i = 0; i < map->val_bytes; i++)
+		val = (val << 8) | buf[i];
+
+	return val;
+}
+
+/* Read count registers from the device, in as few transactions as possible */
+static int no_os_regmap_bus_read(struct no_os_regmap *map, uint32_t reg,
+				 uint32_t *vals, uint32_t count)
+{
+	uint8_t buf[NO_OS_REGMAP_BURST_MAX];
+	uint32_t burst, n, i;
+	int ret;
+
+	if (map->bus_ops->reg_read && (count == 1 || !map->burst ||
+				       !map->bus_ops->bulk_read)) {
+		for (i = 0; i < count; i++) {
+			ret = map->bus_ops->reg_read(map, reg + i, &vals[i]);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	burst = no_os_regmap_burst_len(map);
+	while (count) {
+		n = no_os_min(count, burst);
+		ret = map->bus_ops->bulk_read(map, reg, buf, n);
+		if (ret)
+			return ret;
+
+		for (i = 0; i < n; i++)
+			vals[i] = no_os_regmap_parse_val(map,
+							 &buf[i * map->val_bytes]);
+		reg += n;
+		vals += n;
+		count -= n;
+	}
+
+	return 0;
+}
+
+/* Write count registers to the device, in as few transactions as possible */
+static int no_os_regmap_bus_write(struct no_os_regmap *map, uint32_t reg,
+				  const uint32_t *vals, uint32_t count)
+{
+	uint8_t buf[NO_OS_REGMAP_BURST_MAX];
+	uint32_t burst, n, i;
+	int ret;
+
+	if (map->bus_ops->reg_write && (count == 1 || !map->burst ||
+					!map->bus_ops->bulk_write)) {
+		for (i = 0; i < count; i++) {
+			ret = map->bus_ops->reg_write(map, reg + i, vals[i]);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
+
+	burst = no_os_regmap_burst_len(map);
+	while (count) {
+		n = no_os_min(count, burst);
+		for (i = 0; i < n; i++)
+			no_os_regmap_format_val(map, &buf[i * map->val_bytes],
+						vals[i]);
+
+		ret = map->bus_ops->bulk_write(map, reg, buf, n);
+		if (ret)
+			return ret;
+
+		reg += n;
+		vals += n;
+		count -= n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Initialize a register map.
+ * @param map - The register map.
+ * @param param - The register map initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_init(struct no_os_regmap **map,
+		      const struct no_os_regmap_init_param *param)
+{
+	const struct no_os_regmap_bus_ops *ops;
+	struct no_os_regmap *desc;
+	uint32_t nb_regs, words, i;
+	uint8_t stride;
+
+	if (!map || !param || !param->bus_ops)
+		return -EINVAL;
+
+	ops = param->bus_ops;
+	if (!(ops->reg_read && ops->reg_write) &&
+	    !(ops->bulk_read && ops->bulk_write))
+		return -EINVAL;
+
+	if (!param->reg_bits || param->reg_bits > 32 ||
+	    !param->val_bits || param->val_bits > 32 ||
+	    param->max_register == UINT32_MAX)
+		return -EINVAL;
+
+	desc = (struct no_os_regmap *)no_os_calloc(1, sizeof(*desc));
+	if (!desc)
+		return -ENOMEM;
+
+	desc->bus_ops = ops;
+	desc->bus = param->bus;
+	desc->reg_bits = param->reg_bits;
+	desc->val_bits = param->val_bits;
+	desc->val_bytes = NO_OS_DIV_ROUND_UP(param->val_bits, 8);
+	desc->read_flag_mask = param->read_flag_mask;
+	desc->write_flag_mask = param->write_flag_mask;
+	desc->max_register = param->max_register;
+	desc->burst = param->burst;
+	desc->rd_table = param->rd_table;
+	desc->wr_table = param->wr_table;
+	desc->volatile_table = param->volatile_table;
+	desc->cache_type = param->cache_type;
+
+	if (desc->cache_type == NO_OS_REGMAP_CACHE_FLAT) {
+		nb_regs = desc->max_register + 1;
+		stride = desc->val_bytes == 3 ? 4 : desc->val_bytes;
+		desc->cache = no_os_calloc(nb_regs, stride);
+		if (!desc->cache)
+			goto error;
+
+		/* cache_valid and cache_dirty share one allocation */
+		words = NO_OS_BITS_TO_WORDS(nb_regs);
+		desc->cache_valid = no_os_calloc(2 * words, sizeof(uint32_t));
+		if (!desc->cache_valid)
+			goto error;
+		desc->cache_dirty = desc->cache_valid + words;
+
+		for (i = 0; i < param->nb_reg_defaults; i++) {
+			if (param->reg_defaults[i].reg > desc->max_register ||
+			    !no_os_regmap_cacheable(desc, param->reg_defaults[i].reg))
+				continue;
+
+			no_os_regmap_cache_set(desc, param->reg_defaults[i].reg,
+					       param->reg_defaults[i].val, false);
+		}
+	}
+
+	*map = desc;
+
+	return 0;
+
+error:
+	no_os_free(desc->cache);
+	no_os_free(desc);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free the resources allocated by no_os_regmap_init().
+ * @param map - The register map.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_remove(struct no_os_regmap *map)
+{
+	if (!map)
+		return -EINVAL;
+
+	no_os_free(map->cache_valid);
+	no_os_free(map->cache);
+	no_os_free(map);
+
+	return 0;
+}
+
+/**
+ * @brief Read a register. Cached registers are read from the device only the
+ * first time.
+ * @param map - The register map.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_read(struct no_os_regmap *map, uint32_t reg, uint32_t *val)
+{
+	bool cacheable;
+	int ret;
+
+	if (!map || !val || !no_os_regmap_readable(map, reg))
+		return -EINVAL;
+
+	cacheable = no_os_regmap_cacheable(map, reg);
+	if (cacheable && no_os_regmap_bit(map->cache_valid, reg)) {
+		*val = no_os_regmap_cache_get(map, reg);
+		return 0;
+	}
+
+	if (map->cache_only)
+		return -EBUSY;
+
+	ret = no_os_regmap_bus_read(map, reg, val, 1);
+	if (ret)
+		return ret;
+
+	if (cacheable)
+		no_os_regmap_cache_set(map, reg, *val, false);
+
+	return 0;
+}
+
+/**
+ * @brief Write a register. In cache only mode, the value is only stored in
+ * the cache.
+ * @param map - The register map.
+ * @param reg - The register address.
+ * @param val - The register value.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_write(struct no_os_regmap *map, uint32_t reg, uint32_t val)
+{
+	return no_os_regmap_bulk_write(map, reg, &val, 1);
+}
+
+/**
+ * @brief Update the bits of mask of a register. Cached registers cost one
+ * bus write, and none if the value doesn't change.
+ * @param map - The register map.
+ * @param reg - The register address.
+ * @param mask - Bits to be updated.
+ * @param val - New value of the bits, already shifted in position.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_update_bits(struct no_os_regmap *map, uint32_t reg,
+			     uint32_t mask, uint32_t val)
+{
+	uint32_t orig, tmp;
+	int ret;
+
+	ret = no_os_regmap_read(map, reg, &orig);
+	if (ret)
+		return ret;
+
+	tmp = (orig & ~mask) | (val & mask);
+	if (tmp == orig)
+		return 0;
+
+	return no_os_regmap_write(map, reg, tmp);
+}
+
+/**
+ * @brief Read consecutive registers. The registers not found in the cache are
+ * read from the device in bursts when the map supports it.
+ * @param map - The register map.
+ * @param reg - Address of the first register.
+ * @param vals - The register values.
+ * @param count - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_bulk_read(struct no_os_regmap *map, uint32_t reg,
+			   uint32_t *vals, uint32_t count)
+{
+	bool cached = true;
+	uint32_t i;
+	int ret;
+
+	if (!map || !vals || !count || count - 1 > UINT32_MAX - reg)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		if (!no_os_regmap_readable(map, reg + i))
+			return -EINVAL;
+		if (!no_os_regmap_cacheable(map, reg + i) ||
+		    !no_os_regmap_bit(map->cache_valid, reg + i))
+			cached = false;
+	}
+
+	if (!cached) {
+		if (map->cache_only)
+			return -EBUSY;
+
+		ret = no_os_regmap_bus_read(map, reg, vals, count);
+		if (ret)
+			return ret;
+	}
+
+	/* The cache is up to date, or newer for the dirty registers */
+	for (i = 0; i < count; i++) {
+		if (!no_os_regmap_cacheable(map, reg + i))
+			continue;
+		if (no_os_regmap_bit(map->cache_valid, reg + i))
+			vals[i] = no_os_regmap_cache_get(map, reg + i);
+		else
+			no_os_regmap_cache_set(map, reg + i, vals[i], false);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write consecutive registers, in bursts when the map supports it.
+ * @param map - The register map.
+ * @param reg - Address of the first register.
+ * @param vals - The register values.
+ * @param count - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_bulk_write(struct no_os_regmap *map, uint32_t reg,
+			    const uint32_t *vals, uint32_t count)
+{
+	uint32_t i;
+	int ret;
+
+	if (!map || !vals || !count || count - 1 > UINT32_MAX - reg)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		if (!no_os_regmap_writeable(map, reg + i))
+			return -EINVAL;
+		if (map->cache_only && !no_os_regmap_cacheable(map, reg + i))
+			return -EBUSY;
+	}
+
+	if (!map->cache_only) {
+		ret = no_os_regmap_bus_write(map, reg, vals, count);
+		if (ret)
+			return ret;
+	}
+
+	for (i = 0; i < count; i++)
+		if (no_os_regmap_cacheable(map, reg + i))
+			no_os_regmap_cache_set(map, reg + i, vals[i],
+					       map->cache_only);
+
+	return 0;
+}
+
+/**
+ * @brief Write a sequence of registers, in order. Runs of consecutive
+ * addresses are written in bursts when the map supports it.
+ * @param map - The register map.
+ * @param seq - The registers and their values.
+ * @param count - Number of entries in seq.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_multi_reg_write(struct no_os_regmap *map,
+				 const struct no_os_regmap_reg_seq *seq,
+				 uint32_t count)
+{
+	uint32_t vals[NO_OS_REGMAP_BURST_MAX];
+	uint32_t burst, n, i;
+	int ret;
+
+	if (!map || !seq)
+		return -EINVAL;
+
+	burst = no_os_regmap_burst_len(map);
+	for (i = 0; i < count; i += n) {
+		vals[0] = seq[i].val;
+		for (n = 1; n < burst && i + n < count; n++) {
+			if (seq[i + n].reg != seq[i].reg + n)
+				break;
+			vals[n] = seq[i + n].val;
+		}
+
+		ret = no_os_regmap_bulk_write(map, seq[i].reg, vals, n);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Enable or disable the cache only mode. While enabled, writes only
+ * update the cache and reads not served by the cache fail with -EBUSY. Useful
+ * while the device is powered down or in reset.
+ * @param map - The register map.
+ * @param enable - New mode.
+ * @return None.
+ */
+void no_os_regmap_cache_only(struct no_os_regmap *map, bool enable)
+{
+	if (map && map->cache_type != NO_OS_REGMAP_CACHE_NONE)
+		map->cache_only = enable;
+}
+
+/**
+ * @brief Mark all the cached writeable registers as dirty, so that
+ * no_os_regmap_sync writes them again. To be called after the device was
+ * reset, to restore its configuration.
+ * @param map - The register map.
+ * @return None.
+ */
+void no_os_regmap_mark_dirty(struct no_os_regmap *map)
+{
+	uint32_t reg;
+
+	if (!map || map->cache_type == NO_OS_REGMAP_CACHE_NONE)
+		return;
+
+	no_os_for_each_set_bit(reg, map->cache_valid, map->max_register + 1)
+		if (no_os_regmap_writeable(map, reg))
+			no_os_regmap_assign_bit(map->cache_dirty, reg, true);
+}
+
+/**
+ * @brief Forget all the cached values, including the ones not yet written.
+ * To be called after the device was reset, when its configuration is not to
+ * be restored.
+ * @param map - The register map.
+ * @return None.
+ */
+void no_os_regmap_cache_drop(struct no_os_regmap *map)
+{
+	uint32_t words;
+
+	if (!map || map->cache_type == NO_OS_REGMAP_CACHE_NONE)
+		return;
+
+	words = NO_OS_BITS_TO_WORDS(map->max_register + 1);
+	memset(map->cache_valid, 0, 2 * words * sizeof(uint32_t));
+}
+
+/**
+ * @brief Write the dirty registers to the device, in increasing address
+ * order. Runs of consecutive dirty registers are written in bursts when the
+ * map supports it.
+ * @param map - The register map.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_regmap_sync(struct no_os_regmap *map)
+{
+	uint32_t vals[NO_OS_REGMAP_BURST_MAX];
+	uint32_t nb_regs, burst, reg, n;
+	int ret;
+
+	if (!map)
+		return -EINVAL;
+
+	if (map->cache_type == NO_OS_REGMAP_CACHE_NONE)
+		return 0;
+
+	if (map->cache_only)
+		return -EBUSY;
+
+	nb_regs = map->max_register + 1;
+	burst = no_os_regmap_burst_len(map);
+	reg = no_os_find_next_set_bit(map->cache_dirty, nb_regs, 0);
+	while (reg < nb_regs) {
+		n = 0;
+		do {
+			vals[n] = no_os_regmap_cache_get(map, reg + n);
+			n++;
+		} while (n < burst && reg + n < nb_regs &&
+			 no_os_regmap_bit(map->cache_dirty, reg + n));
+
+		ret = no_os_regmap_bus_write(map, reg, vals, n);
+		if (ret)
+			return ret;
+
+		for (; n > 0; n--, reg++)
+			no_os_regmap_assign_bit(map->cache_dirty, reg, false);
+
+		reg = no_os_find_next_set_bit(map->cache_dirty, nb_regs, reg);
+	}
+
+	return 0;
+}
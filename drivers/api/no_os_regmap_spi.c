@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ *   @file   no_os_regmap_spi.c
+ *   @brief  Register map access over SPI.
+********************************************************************************
+ *   @copyright
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <string.h>
+#include "no_os_spi.h"
+#include "no_os_regmap.h"
+#include "no_os_error.h"
+
+/**
+ * @brief Register map read: the address followed by the values, in one SPI
+ * transaction.
+ * @param map - The register map, whose bus is a SPI descriptor.
+ * @param reg - Address of the first register.
+ * @param data - The raw register values.
+ * @param count - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int no_os_regmap_spi_read(struct no_os_regmap *map, uint32_t reg,
+				 uint8_t *data, uint32_t count)
+{
+	uint8_t buf[4 + NO_OS_REGMAP_BURST_MAX];
+	uint32_t len = count * map->val_bytes;
+	uint8_t n;
+	int32_t ret;
+
+	if (len > NO_OS_REGMAP_BURST_MAX)
+		return -EINVAL;
+
+	n = no_os_regmap_format_reg(map, reg, map->read_flag_mask, buf);
+	memset(&buf[n], 0, len);
+	ret = no_os_spi_write_and_read(map->bus, buf, n + len);
+	if (ret)
+		return ret;
+
+	memcpy(data, &buf[n], len);
+
+	return 0;
+}
+
+/**
+ * @brief Register map write: the address followed by the values, in one SPI
+ * transaction.
+ * @param map - The register map, whose bus is a SPI descriptor.
+ * @param reg - Address of the first register.
+ * @param data - The raw register values.
+ * @param count - Number of registers.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int no_os_regmap_spi_write(struct no_os_regmap *map, uint32_t reg,
+				  const uint8_t *data, uint32_t count)
+{
+	uint8_t buf[4 + NO_OS_REGMAP_BURST_MAX];
+	uint32_t len = count * map->val_bytes;
+	uint8_t n;
+
+	if (len > NO_OS_REGMAP_BURST_MAX)
+		return -EINVAL;
+
+	n = no_os_regmap_format_reg(map, reg, map->write_flag_mask, buf);
+	memcpy(&buf[n], data, len);
+
+	return no_os_spi_write_and_read(map->bus, buf, n + len);
+}
+
+const struct no_os_regmap_bus_ops no_os_regmap_spi_ops = {
+	.bulk_read = no_os_regmap_spi_read,
+	.bulk_write = no_os_regmap_spi_write,
+};
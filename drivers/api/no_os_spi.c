@@ -31,9 +31,13 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
+#define NO_OS_ALLOC_TAG		NO_OS_ALLOC_TAG_SPI
+
 #include <inttypes.h>
 #include "no_os_spi.h"
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 #include "no_os_error.h"
 #include "no_os_mutex.h"
 #include "no_os_alloc.h"
@@ -43,6 +47,26 @@
 */
 static void *spi_table[SPI_MAX_BUS_NUMBER + 1];
 
+/**
+ * @struct no_os_spi_batch
+ * @brief Transactions appended between no_os_spi_batch_begin() and
+ * no_os_spi_batch_commit()
+ */
+struct no_os_spi_batch {
+	/** Messages of the transactions, their data is stored in buf */
+	struct no_os_spi_msg	msgs[NO_OS_SPI_BATCH_MSGS];
+	/** Where to copy the bytes received by each message, may be NULL */
+	uint8_t			*rx[NO_OS_SPI_BATCH_MSGS];
+	/** Transmitted bytes, replaced by the received ones */
+	uint8_t			buf[NO_OS_SPI_BATCH_BYTES];
+	/** Number of messages */
+	uint32_t		len;
+	/** Number of bytes used in buf */
+	uint32_t		used;
+	/** Set between no_os_spi_batch_begin() and no_os_spi_batch_commit() */
+	bool			open;
+};
+
 /**
  * @brief Initialize the SPI communication peripheral.
  * @param desc - The SPI descriptor.
@@ -76,6 +100,7 @@ int32_t no_os_spi_init(struct no_os_spi_desc **desc,
 	(*desc)->platform_ops = param->platform_ops;
 	(*desc)->parent = param->parent;
 	(*desc)->platform_delays = param->platform_delays;
+	(*desc)->batch = NULL;
 
 	return 0;
 }
@@ -121,6 +146,9 @@ int32_t no_os_spi_remove(struct no_os_spi_desc *desc)
 	if (desc->bus)
 		no_os_spibus_remove(desc->bus->device_id);
 
+	no_os_free(desc->batch);
+	desc->batch = NULL;
+
 	if (!desc->platform_ops->remove)
 		return -ENOSYS;
 	return desc->platform_ops->remove(desc);
@@ -195,6 +223,9 @@ int32_t no_os_spi_transfer(struct no_os_spi_desc *desc,
 	if (desc->platform_ops->transfer)
 		return desc->platform_ops->transfer(desc, msgs, len);
 
+	if (!desc->platform_ops->write_and_read)
+		return -ENOSYS;
+
 	no_os_mutex_lock(desc->bus->mutex);
 
 	for (i = 0; i < len; i++) {
@@ -202,8 +233,9 @@ int32_t no_os_spi_transfer(struct no_os_spi_desc *desc,
 			ret = -EINVAL;
 			goto out;
 		}
-		ret = no_os_spi_write_and_read(desc, msgs[i].rx_buff,
-					       msgs[i].bytes_number);
+		/* The bus mutex is already held */
+		ret = desc->platform_ops->write_and_read(desc, msgs[i].rx_buff,
+				msgs[i].bytes_number);
 		if (NO_OS_IS_ERR_VALUE(ret)) {
 			goto out;
 		}
@@ -276,3 +308,340 @@ int32_t no_os_spi_transfer_abort(struct no_os_spi_desc *desc)
 
 	return desc->platform_ops->transfer_abort(desc);
 }
+
+/**
+ * @brief Move the next requests of the queue in the bus batch. Consecutive
+ * requests of the same device are merged while their messages fit in
+ * queue_msgs.
+ * @param bus - The SPI bus descriptor.
+ * @param msgs - Messages of the batch.
+ * @param len - Number of messages of the batch.
+ * @return The device of the batch, NULL if the queue is empty.
+ */
+static struct no_os_spi_desc *no_os_spi_queue_batch(struct no_os_spibus_desc
+		*bus, struct no_os_spi_msg **msgs, uint32_t *len)
+{
+	struct no_os_spi_request *newest;
+	struct no_os_spi_request *last;
+	struct no_os_spi_request *req;
+	struct no_os_spi_request *next;
+	uint32_t nb;
+	uint32_t i;
+
+	/* Move the submitted requests to the end of the queue, in order */
+	req = __atomic_exchange_n(&bus->queue_in, NULL, __ATOMIC_ACQUIRE);
+	newest = req;
+	last = NULL;
+	while (req) {
+		next = req->next;
+		req->next = last;
+		last = req;
+		req = next;
+	}
+	if (last) {
+		if (bus->queue_tail)
+			bus->queue_tail->next = last;
+		else
+			bus->queue_head = last;
+		bus->queue_tail = newest;
+	}
+
+	last = bus->queue_head;
+	if (!last)
+		return NULL;
+
+	nb = last->len;
+	while (last->next && last->next->desc == last->desc &&
+	       nb + last->next->len <= NO_OS_SPI_QUEUE_MSGS) {
+		last = last->next;
+		nb += last->len;
+	}
+
+	bus->queue_batch = bus->queue_head;
+	bus->queue_head = last->next;
+	if (!bus->queue_head)
+		bus->queue_tail = NULL;
+	last->next = NULL;
+
+	/* A single request is transferred from its own array */
+	if (bus->queue_batch == last) {
+		*msgs = last->msgs;
+		*len = last->len;
+
+		return last->desc;
+	}
+
+	nb = 0;
+	for (req = bus->queue_batch; req; req = req->next) {
+		for (i = 0; i < req->len; i++)
+			bus->queue_msgs[nb++] = req->msgs[i];
+		/* Release the chip select between the merged requests */
+		if (req->next)
+			bus->queue_msgs[nb - 1].cs_change = 1;
+	}
+
+	*msgs = bus->queue_msgs;
+	*len = nb;
+
+	return last->desc;
+}
+
+/**
+ * @brief Invoke the callbacks of the requests in the bus batch.
+ * @param bus - The SPI bus descriptor.
+ * @param ret - Result of the transfer.
+ */
+static void no_os_spi_queue_complete(struct no_os_spibus_desc *bus,
+				     int32_t ret)
+{
+	struct no_os_spi_request *req;
+	struct no_os_spi_request *next;
+
+	req = bus->queue_batch;
+	bus->queue_batch = NULL;
+	while (req) {
+		/* The callback may submit the request again */
+		next = req->next;
+		if (req->callback)
+			req->callback(req, ret);
+		req = next;
+	}
+}
+
+/**
+ * @brief Transfer the queued requests of a bus. Returns when the queue is
+ * empty or when a DMA transfer was started, in which case the DMA callback
+ * continues with the rest of the queue. Only the context that set queue_busy
+ * may call it, so the queue is processed without the bus mutex and it can
+ * run from the DMA callback.
+ * @param bus - The SPI bus descriptor.
+ */
+static void no_os_spi_queue_process(struct no_os_spibus_desc *bus);
+
+/**
+ * @brief Callback of the DMA transfer of a batch.
+ * @param ctx - The SPI bus descriptor.
+ */
+static void no_os_spi_queue_dma_done(void *ctx)
+{
+	struct no_os_spibus_desc *bus = ctx;
+
+	no_os_spi_queue_complete(bus, bus->queue_batch->desc->dma_async_ret);
+	no_os_spi_queue_process(bus);
+}
+
+static void no_os_spi_queue_process(struct no_os_spibus_desc *bus)
+{
+	struct no_os_spi_desc *desc;
+	struct no_os_spi_msg *msgs;
+	uint32_t len;
+	int32_t ret;
+
+	while (true) {
+		desc = no_os_spi_queue_batch(bus, &msgs, &len);
+		if (!desc) {
+			__atomic_store_n(&bus->queue_busy, false, __ATOMIC_SEQ_CST);
+			/*
+			 * A request submitted before the flag was cleared found
+			 * the queue busy, so it must be processed here, unless
+			 * its submitter got the queue in the meantime.
+			 */
+			if (!__atomic_load_n(&bus->queue_in, __ATOMIC_SEQ_CST) ||
+			    __atomic_exchange_n(&bus->queue_busy, true,
+						__ATOMIC_SEQ_CST))
+				return;
+			continue;
+		}
+
+		if (desc->platform_ops->transfer_dma_async) {
+			desc->dma_async_ret = 0;
+			ret = desc->platform_ops->transfer_dma_async(desc, msgs, len,
+					no_os_spi_queue_dma_done, bus);
+			if (!ret)
+				return;
+		} else {
+			ret = no_os_spi_transfer(desc, msgs, len);
+		}
+
+		no_os_spi_queue_complete(bus, ret);
+	}
+}
+
+/**
+ * @brief Queue a request on the SPI bus of a device. The requests of a bus are
+ * transferred in order. Consecutive requests of the same device are merged in
+ * a single transfer. The platform transfer_dma_async operation is used when
+ * available, otherwise the requests are transferred synchronously by the
+ * context that finds the queue idle.
+ * @param desc - The SPI descriptor.
+ * @param req - The request. It must stay valid until its callback is called.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_submit(struct no_os_spi_desc *desc,
+			 struct no_os_spi_request *req)
+{
+	struct no_os_spibus_desc *bus;
+
+	if (!desc || !desc->platform_ops || !desc->bus || !req || !req->msgs ||
+	    !req->len)
+		return -EINVAL;
+
+	if (!desc->platform_ops->transfer_dma_async &&
+	    !desc->platform_ops->transfer && !desc->platform_ops->write_and_read)
+		return -ENOSYS;
+
+	bus = desc->bus;
+	req->desc = desc;
+
+	req->next = __atomic_load_n(&bus->queue_in, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&bus->queue_in, &req->next, req,
+					    true, __ATOMIC_SEQ_CST,
+					    __ATOMIC_RELAXED))
+		;
+
+	/* Process the queue if no other context is doing it */
+	if (!__atomic_exchange_n(&bus->queue_busy, true, __ATOMIC_SEQ_CST))
+		no_os_spi_queue_process(bus);
+
+	return 0;
+}
+
+/**
+ * @brief Start collecting transactions to be sent in a single transfer.
+ * no_os_spi_batch_append() adds the transactions to the batch instead of
+ * sending them, until no_os_spi_batch_commit() is called. On platforms
+ * implementing the transfer operation, like Linux, the batch is a single
+ * call to the driver (one SPI_IOC_MESSAGE ioctl) instead of one per
+ * transaction.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_batch_begin(struct no_os_spi_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	if (!desc->batch) {
+		desc->batch = no_os_calloc(1, sizeof(*desc->batch));
+		if (!desc->batch)
+			return -ENOMEM;
+	}
+
+	if (desc->batch->open)
+		return -EBUSY;
+
+	desc->batch->open = true;
+	desc->batch->len = 0;
+	desc->batch->used = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Send the transactions appended to the batch and copy the received
+ * bytes to their destination.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t no_os_spi_batch_flush(struct no_os_spi_desc *desc)
+{
+	struct no_os_spi_batch *batch = desc->batch;
+	int32_t ret;
+	uint32_t i;
+
+	if (!batch->len)
+		return 0;
+
+	ret = no_os_spi_transfer(desc, batch->msgs, batch->len);
+	if (!ret)
+		for (i = 0; i < batch->len; i++)
+			if (batch->rx[i])
+				memcpy(batch->rx[i], batch->msgs[i].rx_buff,
+				       batch->msgs[i].bytes_number);
+
+	batch->len = 0;
+	batch->used = 0;
+
+	return ret;
+}
+
+/**
+ * @brief Add a transaction to the batch. The transmitted bytes are copied, so
+ * tx can be reused after the call. The chip select is deasserted after each
+ * transaction. If no batch was started, the transaction is sent right away.
+ * When the batch is full, the transactions already in it are sent first.
+ * @param desc - The SPI descriptor.
+ * @param tx - The bytes to transmit.
+ * @param rx - Where to store the received bytes, NULL to discard them. When
+ * batching, it is written by no_os_spi_batch_commit() and must be valid until
+ * then.
+ * @param bytes_number - Number of bytes of the transaction.
+ * @return 0 in case of success, negative error code otherwise. On error the
+ * batch is discarded and closed.
+ */
+int32_t no_os_spi_batch_append(struct no_os_spi_desc *desc,
+			       const uint8_t *tx, uint8_t *rx,
+			       uint16_t bytes_number)
+{
+	uint8_t buf[NO_OS_SPI_BATCH_BYTES];
+	struct no_os_spi_batch *batch;
+	struct no_os_spi_msg *msg;
+	int32_t ret;
+
+	if (!desc || !tx || !bytes_number ||
+	    bytes_number > NO_OS_SPI_BATCH_BYTES)
+		return -EINVAL;
+
+	if (!desc->batch || !desc->batch->open) {
+		if (rx) {
+			memmove(rx, tx, bytes_number);
+			return no_os_spi_write_and_read(desc, rx, bytes_number);
+		}
+
+		memcpy(buf, tx, bytes_number);
+
+		return no_os_spi_write_and_read(desc, buf, bytes_number);
+	}
+
+	batch = desc->batch;
+	if (batch->len == NO_OS_SPI_BATCH_MSGS ||
+	    batch->used + bytes_number > NO_OS_SPI_BATCH_BYTES) {
+		ret = no_os_spi_batch_flush(desc);
+		if (ret) {
+			batch->open = false;
+			return ret;
+		}
+	}
+
+	msg = &batch->msgs[batch->len];
+	memset(msg, 0, sizeof(*msg));
+	msg->tx_buff = &batch->buf[batch->used];
+	msg->rx_buff = msg->tx_buff;
+	msg->bytes_number = bytes_number;
+	msg->cs_change = 1;
+	memcpy(msg->tx_buff, tx, bytes_number);
+	batch->rx[batch->len] = rx;
+
+	batch->len++;
+	batch->used += bytes_number;
+
+	return 0;
+}
+
+/**
+ * @brief Send the transactions of the batch and close it.
+ * @param desc - The SPI descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spi_batch_commit(struct no_os_spi_desc *desc)
+{
+	int32_t ret;
+
+	if (!desc || !desc->batch || !desc->batch->open)
+		return -EINVAL;
+
+	ret = no_os_spi_batch_flush(desc);
+	desc->batch->open = false;
+
+	return ret;
+}
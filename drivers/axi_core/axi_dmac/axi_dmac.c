@@ -366,6 +366,23 @@ int32_t axi_dmac_remove(struct axi_dmac *dmac)
 	return 0;
 }
 
+/*******************************************************************************
+ * @brief Enable the DMA if not already enabled.
+ *
+ * @param dmac - DMAC istance.
+*******************************************************************************/
+static void axi_dmac_enable(struct axi_dmac *dmac)
+{
+	uint32_t reg_val;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
+	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
+		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
+		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
+	}
+}
+
 /*******************************************************************************
  * @brief Start a DMA transfer.
  *
@@ -387,6 +404,8 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 	dmac->transfer.cyclic = dma_transfer->cyclic;
 	dmac->transfer.dest_addr = dma_transfer->dest_addr;
 	dmac->transfer.src_addr = dma_transfer->src_addr;
+	/* Set again by the ISR once the whole transfer completes */
+	dmac->transfer.transfer_done = false;
 
 	dmac->remaining_size = dma_transfer->size;
 	dmac->next_dest_addr = dma_transfer->dest_addr;
@@ -422,13 +441,7 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, reg_val);
 	}
 
-	/* Enable DMA if not already enabled. */
-	axi_dmac_read(dmac, AXI_DMAC_REG_CTRL, &reg_val);
-	if (!(reg_val & AXI_DMAC_CTRL_ENABLE)) {
-		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, 0x0);
-		axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_ENABLE);
-		axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_MASK, 0x0);
-	}
+	axi_dmac_enable(dmac);
 
 	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT, &reg_val);
 	/* If we don't have a start of transfer then start compute
@@ -555,4 +568,220 @@ int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
 void axi_dmac_transfer_stop(struct axi_dmac *dmac)
 {
 	axi_dmac_write(dmac, AXI_DMAC_REG_CTRL, AXI_DMAC_CTRL_DISABLE);
+
+	/* Disabling the DMA drops the transfers queued in hardware */
+	dmac->queue_head = 0;
+	dmac->queue_len = 0;
+}
+
+/*******************************************************************************
+ * @brief Queue a block in the hardware transfer queue. It starts as soon as the
+ *			previous queued block completes, so a stream of blocks has
+ *			no gaps as long as the queue is not empty.
+ *
+ * @param dmac - DMAC istance.
+ * @param block - The block. It must stay valid until its done callback is
+ *			called.
+ *
+ * @return 0 for success, -EBUSY if the queue is full, negative error code
+ *			otherwise.
+*******************************************************************************/
+int32_t axi_dmac_queue_block(struct axi_dmac *dmac,
+			     struct axi_dmac_block *block)
+{
+	uint32_t reg_val;
+
+	if (!dmac || !block || !block->size || block->size - 1 > dmac->max_length)
+		return -EINVAL;
+
+	switch (dmac->direction) {
+	case DMA_DEV_TO_MEM:
+		if (block->addr % dmac->width_dst)
+			return -EINVAL;
+		break;
+	case DMA_MEM_TO_DEV:
+		if (block->addr % dmac->width_src)
+			return -EINVAL;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	if (dmac->queue_len == AXI_DMAC_QUEUE_SIZE)
+		return -EBUSY;
+
+	axi_dmac_enable(dmac);
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT, &reg_val);
+	if (reg_val & AXI_DMAC_QUEUE_FULL)
+		return -EBUSY;
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_FLAGS, &reg_val);
+	if (reg_val & DMA_CYCLIC)
+		axi_dmac_write(dmac, AXI_DMAC_REG_FLAGS, reg_val & ~DMA_CYCLIC);
+
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_ID, &block->id);
+	block->id %= AXI_DMAC_QUEUE_SIZE;
+
+	if (dmac->direction == DMA_DEV_TO_MEM) {
+		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_ADDRESS, block->addr);
+		axi_dmac_write(dmac, AXI_DMAC_REG_DEST_STRIDE, 0x0);
+	} else {
+		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_ADDRESS, block->addr);
+		axi_dmac_write(dmac, AXI_DMAC_REG_SRC_STRIDE, 0x0);
+	}
+	axi_dmac_write(dmac, AXI_DMAC_REG_X_LENGTH, block->size - 1);
+	axi_dmac_write(dmac, AXI_DMAC_REG_Y_LENGTH, 0x0);
+
+	dmac->queue[(dmac->queue_head + dmac->queue_len) % AXI_DMAC_QUEUE_SIZE] =
+		block;
+	dmac->queue_len++;
+
+	axi_dmac_write(dmac, AXI_DMAC_REG_TRANSFER_SUBMIT, AXI_DMAC_TRANSFER_SUBMIT);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * @brief Call the done callback of the queued blocks that completed, in the
+ *			order they were queued. Blocks can be queued again from the
+ *			callback.
+ *
+ * @param dmac - DMAC istance.
+ *
+ * @return Number of completed blocks.
+*******************************************************************************/
+int32_t axi_dmac_queue_process(struct axi_dmac *dmac)
+{
+	struct axi_dmac_block *block;
+	uint32_t queued = dmac->queue_len;
+	uint32_t done;
+	int32_t nb = 0;
+
+	/* A bit is set when the transfer with that id completes */
+	axi_dmac_read(dmac, AXI_DMAC_REG_TRANSFER_DONE, &done);
+
+	/* Blocks queued by the callbacks are checked on the next call */
+	while (queued--) {
+		block = dmac->queue[dmac->queue_head];
+		if (!(done & NO_OS_BIT(block->id)))
+			break;
+
+		dmac->queue_head = (dmac->queue_head + 1) % AXI_DMAC_QUEUE_SIZE;
+		dmac->queue_len--;
+		nb++;
+
+		if (block->done)
+			block->done(block, block->ctx);
+	}
+
+	return nb;
+}
+
+/*******************************************************************************
+ * @brief ISR for queued transfers. Calls the done callback of the completed
+ *			blocks.
+ *
+ * @param instance - the instance that triggered the ISR.
+*******************************************************************************/
+void axi_dmac_queue_isr(void *instance)
+{
+	struct axi_dmac *dmac = (struct axi_dmac *)instance;
+	uint32_t reg_val;
+
+	/* Get interrupt sources and clear interrupts. */
+	axi_dmac_read(dmac, AXI_DMAC_REG_IRQ_PENDING, &reg_val);
+	axi_dmac_write(dmac, AXI_DMAC_REG_IRQ_PENDING, reg_val);
+
+	if (reg_val & AXI_DMAC_IRQ_EOT)
+		axi_dmac_queue_process(dmac);
+}
+
+/*******************************************************************************
+ * @brief Do a transfer of any size through the hardware queue, keeping it
+ *			filled with blocks of at most max_length + 1 bytes, so there
+ *			are no gaps between them. Doesn't need the DMA interrupt.
+ *			When the DMAC uses interrupts, the transfer is done by
+ *			axi_dmac_transfer_start() instead, chained and completed by
+ *			the registered ISR, so the caller sleeps until it is done.
+ *
+ * @param dmac - DMAC istance.
+ * @param dma_transfer - Structure containing transfer details. Cyclic
+ *			transfers are not supported.
+ * @param timeout_ms - Number of ms to wait for completion of transfer.
+ *
+ * @return 0 for success, negative error code otherwise.
+*******************************************************************************/
+int32_t axi_dmac_transfer_queued(struct axi_dmac *dmac,
+				 struct axi_dma_transfer *dma_transfer,
+				 uint32_t timeout_ms)
+{
+	struct axi_dmac_block blocks[AXI_DMAC_QUEUE_SIZE];
+	struct axi_dmac_block *block;
+	uint32_t elapsed_us = 0;
+	uint32_t remaining;
+	uint32_t addr;
+	uint32_t i = 0;
+	int32_t ret;
+
+	if (!dmac || !dma_transfer || dma_transfer->cyclic == CYCLIC)
+		return -EINVAL;
+
+	/* Blocks of an aborted transfer must not be left in the queue */
+	if (dmac->queue_len)
+		return -EBUSY;
+
+	if (dmac->irq_option == IRQ_ENABLED) {
+		ret = axi_dmac_transfer_start(dmac, dma_transfer);
+		if (ret)
+			return ret;
+
+		return axi_dmac_transfer_wait_completion(dmac, timeout_ms);
+	}
+
+	/* Nothing left for axi_dmac_transfer_start() chaining in the ISRs */
+	dmac->remaining_size = 0;
+	dmac->next_dest_addr = 0;
+	dmac->next_src_addr = 0;
+
+	remaining = dma_transfer->size;
+	addr = dmac->direction == DMA_DEV_TO_MEM ? dma_transfer->dest_addr :
+	       dma_transfer->src_addr;
+
+	while (remaining || dmac->queue_len) {
+		/* Blocks complete in order, so the slot of the oldest is free */
+		while (remaining && dmac->queue_len < AXI_DMAC_QUEUE_SIZE) {
+			block = &blocks[i % AXI_DMAC_QUEUE_SIZE];
+			block->addr = addr;
+			block->size = no_os_min(remaining, dmac->max_length + 1);
+			block->done = NULL;
+
+			ret = axi_dmac_queue_block(dmac, block);
+			if (ret == -EBUSY)
+				break;
+			if (ret)
+				goto stop;
+
+			addr += block->size;
+			remaining -= block->size;
+			i++;
+		}
+
+		if (axi_dmac_queue_process(dmac))
+			continue;
+
+		if (elapsed_us >= timeout_ms * 1000) {
+			ret = -ETIMEDOUT;
+			goto stop;
+		}
+		no_os_udelay(10);
+		elapsed_us += 10;
+	}
+
+	return 0;
+
+stop:
+	axi_dmac_transfer_stop(dmac);
+
+	return ret;
 }
@@ -66,6 +66,9 @@
 #define AXI_DMAC_REG_SRC_STRIDE			0x424
 #define AXI_DMAC_REG_TRANSFER_DONE		0x428
 
+/* Number of transfers the controller can queue, one per transfer id */
+#define AXI_DMAC_QUEUE_SIZE		4
+
 enum use_irq {
 	IRQ_DISABLED = 0,
 	IRQ_ENABLED = 1
@@ -98,6 +101,20 @@ struct axi_dma_transfer {
 	uint32_t dest_addr;
 };
 
+/* Block of a queued transfer, see axi_dmac_queue_block() */
+struct axi_dmac_block {
+	/* Memory address: destination for DEV_TO_MEM, source for MEM_TO_DEV */
+	uint32_t addr;
+	/* Size in bytes, at most max_length + 1 */
+	uint32_t size;
+	/* Called from axi_dmac_queue_process() once the block is complete */
+	void (*done)(struct axi_dmac_block *block, void *ctx);
+	/* Parameter passed to done */
+	void *ctx;
+	/* Transfer id assigned by the controller when queued */
+	uint32_t id;
+};
+
 struct axi_dmac {
 	const char *name;
 	uint32_t base;
@@ -113,6 +130,10 @@ struct axi_dmac {
 	uint32_t remaining_size;
 	uint32_t next_src_addr;
 	uint32_t next_dest_addr;
+	//Blocks queued in hardware, oldest first
+	struct axi_dmac_block *queue[AXI_DMAC_QUEUE_SIZE];
+	uint32_t queue_head;
+	uint32_t queue_len;
 };
 
 struct axi_dmac_init {
@@ -125,6 +146,7 @@ void axi_dmac_dev_to_mem_isr(void *instance);
 void axi_dmac_mem_to_dev_isr(void *instance);
 void axi_dmac_mem_to_mem_isr(void *instance);
 void axi_dmac_write_isr(void *instance);
+void axi_dmac_queue_isr(void *instance);
 int32_t axi_dmac_read(struct axi_dmac *dmac, uint32_t reg_addr,
 		      uint32_t *reg_data);
 int32_t axi_dmac_write(struct axi_dmac *dmac, uint32_t reg_addr,
@@ -138,5 +160,11 @@ int32_t axi_dmac_transfer_start(struct axi_dmac *dmac,
 int32_t axi_dmac_transfer_wait_completion(struct axi_dmac *dmac,
 		uint32_t timeout_ms);
 void axi_dmac_transfer_stop(struct axi_dmac *dmac);
+int32_t axi_dmac_queue_block(struct axi_dmac *dmac,
+			     struct axi_dmac_block *block);
+int32_t axi_dmac_queue_process(struct axi_dmac *dmac);
+int32_t axi_dmac_transfer_queued(struct axi_dmac *dmac,
+				 struct axi_dma_transfer *dma_transfer,
+				 uint32_t timeout_ms);
 
 #endif
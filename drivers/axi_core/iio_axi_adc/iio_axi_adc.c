@@ -355,13 +355,11 @@ int32_t	iio_axi_adc_read_dev(void *dev, void *buff, uint32_t nb_samples)
 		// Address of data source
 		.src_addr = 0,
 		// Address of data destination
-		.dest_addr = (uintptr_t)buff
+		.dest_addr = iio_adc->virt_to_phys ?
+		iio_adc->virt_to_phys(buff) : (uintptr_t)buff
 	};
-	ret = axi_dmac_transfer_start(iio_adc->dmac, &transfer);
-	if (ret < 0)
-		return ret;
-	/* Wait until transfer finishes */
-	ret = axi_dmac_transfer_wait_completion(iio_adc->dmac, 500);
+	/* Chained through the hardware queue, without gaps between blocks */
+	ret = axi_dmac_transfer_queued(iio_adc->dmac, &transfer, 500);
 	if (ret)
 		return ret;
 
@@ -493,6 +491,7 @@ int32_t iio_axi_adc_init(struct iio_axi_adc_desc **desc,
 	if (init->rx_dmac) {
 		iio_axi_adc_inst->dmac = init->rx_dmac;
 		iio_axi_adc_inst->dcache_invalidate_range = init->dcache_invalidate_range;
+		iio_axi_adc_inst->virt_to_phys = init->virt_to_phys;
 	}
 	iio_axi_adc_inst->get_sampling_frequency = init->get_sampling_frequency;
 
@@ -51,6 +51,8 @@ struct iio_axi_adc_desc {
 	struct axi_dmac *dmac;
 	/** Invalidate cache memory function pointer */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/** Buffer address to DMA address translation function pointer */
+	uintptr_t (*virt_to_phys)(void *addr);
 	/** Custom implementation for get sampling frequency */
 	int (*get_sampling_frequency)(struct axi_adc *dev, uint32_t chan,
 				      uint64_t *sampling_freq_hz);
@@ -73,6 +75,11 @@ struct iio_axi_adc_init_param {
 	struct axi_dmac *rx_dmac;
 	/** Invalidate the Data cache for the given address range */
 	void (*dcache_invalidate_range)(uint32_t address, uint32_t bytes_count);
+	/**
+	 * Translate a buffer address to the address used by the DMA. Optional,
+	 * needed when the buffer is not identity mapped (e.g. Linux userspace)
+	 */
+	uintptr_t (*virt_to_phys)(void *addr);
 	/** Custom sampling frequency getter */
 	int (*get_sampling_frequency)(struct axi_adc *dev, uint32_t chan,
 				      uint64_t *sampling_freq_hz);
@@ -505,7 +505,8 @@ int32_t iio_axi_dac_write_data(void *dev, void *buff, uint32_t nb_samples)
 		// Signal transfer mode
 		.cyclic = CYCLIC,
 		// Address of data source
-		.src_addr = (uintptr_t)buff,
+		.src_addr = iio_dac->virt_to_phys ?
+		iio_dac->virt_to_phys(buff) : (uintptr_t)buff,
 		// Address of data destination
 		.dest_addr = 0
 	};
@@ -669,6 +670,7 @@ int32_t iio_axi_dac_init(struct iio_axi_dac_desc **desc,
 	if (init->tx_dmac) {
 		iio_axi_dac_inst->dmac = init->tx_dmac;
 		iio_axi_dac_inst->dcache_flush_range = init->dcache_flush_range;
+		iio_axi_dac_inst->virt_to_phys = init->virt_to_phys;
 	}
 
 	status = iio_axi_dac_create_device_descriptor(iio_axi_dac_inst,
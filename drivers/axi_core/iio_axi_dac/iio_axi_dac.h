@@ -50,6 +50,8 @@ struct iio_axi_dac_desc {
 	uint32_t mask;
 	/** flush contents of instruction and/or data cache */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/** Buffer address to DMA address translation function pointer */
+	uintptr_t (*virt_to_phys)(void *addr);
 	/** iio device descriptor */
 	struct iio_device dev_descriptor;
 	/** Channel names */
@@ -67,6 +69,11 @@ struct iio_axi_dac_init_param {
 	struct axi_dmac *tx_dmac;
 	/** Function pointer to flush the data cache for the given address range */
 	void (*dcache_flush_range)(uint32_t address, uint32_t bytes_count);
+	/**
+	 * Translate a buffer address to the address used by the DMA. Optional,
+	 * needed when the buffer is not identity mapped (e.g. Linux userspace)
+	 */
+	uintptr_t (*virt_to_phys)(void *addr);
 };
 
 /* Init application. */
@@ -149,7 +149,7 @@ static int jesd204_no_os_clk_init(struct no_os_clk_desc **desc,
 
 	return 0;
 error:
-	free(*desc);
+	no_os_free(*desc);
 	return -ENOMEM;
 }
 
@@ -169,7 +169,7 @@ static int jesd204_no_os_clk_remove(struct no_os_clk_desc *desc)
 	if (!jesd204_clk_dev)
 		return -ENODEV;
 
-	free(desc);
+	no_os_free(desc);
 
 	return 0;
 }
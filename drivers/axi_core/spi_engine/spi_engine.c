@@ -35,6 +35,9 @@
 /* In debug mode the printf function used in displaying the messages is causing
 significant delays */
 //#define DEBUG_LEVEL 2
+
+#define NO_OS_ALLOC_TAG		NO_OS_ALLOC_TAG_SPI
+
 #include "spi_engine.h"
 
 #ifndef USE_STANDARD_SPI
@@ -42,6 +45,7 @@ significant delays */
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "no_os_delay.h"
 #include <inttypes.h>
 
@@ -337,6 +341,13 @@ static int32_t spi_engine_write_cmd_reg(struct spi_engine_desc *desc,
 {
 	int32_t ret;
 
+	/* Store the command in the program that is being compiled */
+	if (desc->compile_prog) {
+		desc->compile_prog->cmds[desc->compile_prog->no_cmds++] = cmd;
+
+		return 0;
+	}
+
 	/* Check if offload is enabled */
 	if (desc->offload_config & (OFFLOAD_TX_EN | OFFLOAD_RX_EN)) {
 		ret = spi_engine_write(desc,
@@ -630,7 +641,7 @@ int32_t spi_engine_init(struct no_os_spi_desc **desc,
 		return -1;
 	}
 
-	eng_desc = (struct spi_engine_desc*)no_os_malloc(sizeof(*eng_desc));
+	eng_desc = (struct spi_engine_desc*)no_os_calloc(1, sizeof(*eng_desc));
 
 	if (!eng_desc)
 		return -1;
@@ -771,15 +782,24 @@ int32_t spi_engine_offload_init(struct no_os_spi_desc *desc,
 			eng_desc->cyclic = NO;
 	}
 
+	/* The DMACs are kept if the offload is initialized again with them */
 	dmac_init.irq_option = IRQ_DISABLED;
-	if (param->offload_config & OFFLOAD_TX_EN) {
+	if ((param->offload_config & OFFLOAD_TX_EN) &&
+	    (!eng_desc->offload_tx_dma ||
+	     eng_desc->offload_tx_dma->base != param->tx_dma_baseaddr)) {
+		if (eng_desc->offload_tx_dma)
+			axi_dmac_remove(eng_desc->offload_tx_dma);
 		dmac_init.name = "DAC DMAC";
 		dmac_init.base = param->tx_dma_baseaddr;
 		axi_dmac_init(&eng_desc->offload_tx_dma, &dmac_init);
 		if (!eng_desc->offload_tx_dma)
 			return -1;
 	}
-	if (param->offload_config & OFFLOAD_RX_EN) {
+	if ((param->offload_config & OFFLOAD_RX_EN) &&
+	    (!eng_desc->offload_rx_dma ||
+	     eng_desc->offload_rx_dma->base != param->rx_dma_baseaddr)) {
+		if (eng_desc->offload_rx_dma)
+			axi_dmac_remove(eng_desc->offload_rx_dma);
 		dmac_init.name = "ADC DMAC";
 		dmac_init.base = param->rx_dma_baseaddr;
 		axi_dmac_init(&eng_desc->offload_rx_dma, &dmac_init);
@@ -791,78 +811,189 @@ int32_t spi_engine_offload_init(struct no_os_spi_desc *desc,
 }
 
 /**
- * @brief Initiate a SPI transfer in offload mode
+ * @brief Compile an offload message in a program
+ *
+ * The commands are expanded and completed with the configuration of the
+ * device only once, so the program can be run many times without the message
+ * queue allocations and the register writes done by
+ * spi_engine_offload_transfer().
  *
  * @param desc Decriptor containing SPI interface parameters
- * @param msg Offload message that get's to be transferred
- * @param no_samples Number of time the messages will be transferred
- * @return int32_t This function allways returns 0
+ * @param msg Offload message that gets compiled. The commands and their data
+ * are copied, so they can be freed after the call.
+ * @param prog Compiled program, to be freed with
+ * spi_engine_offload_program_remove()
+ * @return int32_t - 0 if the message was compiled
+ *		   - negative error code otherwise
  */
-int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
-				    struct spi_engine_offload_message msg,
-				    uint32_t no_samples)
+int32_t spi_engine_offload_compile(struct no_os_spi_desc *desc,
+				   struct spi_engine_offload_message *msg,
+				   struct spi_engine_offload_program **prog)
 {
-	struct spi_engine_msg	transfer;
-	struct spi_engine_desc	*eng_desc;
-	uint32_t 		i;
-	int32_t			ret;
+	struct spi_engine_offload_program	*program;
+	struct spi_engine_desc			*eng_desc;
+	struct spi_engine_msg			transfer;
+	uint32_t				data;
+	uint32_t				i;
+	int32_t					ret;
+
+	if (!desc || !msg || !prog || !msg->commands || !msg->no_commands)
+		return -EINVAL;
 
 	eng_desc = desc->extra;
 
-	/* Check if offload is disabled */
-	if (!((eng_desc->offload_config & OFFLOAD_TX_EN) |
-	      (eng_desc->offload_config & OFFLOAD_RX_EN)))
-		return -1;
+	program = (struct spi_engine_offload_program *)no_os_calloc(1,
+			sizeof(*program));
+	if (!program)
+		return -ENOMEM;
+
+	/* Each command is expanded in one engine command, plus 3 CONFIG and a
+	 * SYNC added by spi_engine_compile_message() */
+	program->cmds = (uint32_t *)no_os_calloc(msg->no_commands + 4,
+			sizeof(*program->cmds));
+	if (!program->cmds) {
+		ret = -ENOMEM;
+		goto error_prog;
+	}
+
+	ret = spi_engine_queue_new_cmd(&transfer.cmds, msg->commands[0]);
+	if (ret) {
+		ret = -ENOMEM;
+		goto error_cmds;
+	}
+	for (i = 1; i < msg->no_commands; i++)
+		spi_engine_queue_add_cmd(&transfer.cmds, msg->commands[i]);
+
+	spi_engine_compile_message(desc, &transfer);
+
+	eng_desc->offload_tx_len = 0;
+	eng_desc->compile_prog = program;
+	while (transfer.cmds != NULL) {
+		spi_engine_queue_get_cmd(&transfer.cmds, &data);
+		ret = spi_engine_write_cmd(desc, data);
+		if (ret) {
+			ret = -EINVAL;
+			break;
+		}
+	}
+	eng_desc->compile_prog = NULL;
+	spi_engine_queue_no_os_free(&transfer.cmds);
+	if (ret)
+		goto error_cmds;
+
+	program->len = eng_desc->offload_tx_len;
+	if (program->len && msg->commands_data) {
+		program->sdo = (uint32_t *)no_os_calloc(program->len,
+							sizeof(*program->sdo));
+		if (!program->sdo) {
+			ret = -ENOMEM;
+			goto error_cmds;
+		}
+		memcpy(program->sdo, msg->commands_data,
+		       program->len * sizeof(*program->sdo));
+	}
+
+	*prog = program;
+
+	return 0;
+
+error_cmds:
+	no_os_free(program->cmds);
+error_prog:
+	no_os_free(program);
+
+	return ret;
+}
+
+/**
+ * @brief Write a compiled program in the offload memory
+ *
+ * @param eng_desc Decriptor containing SPI Engine's parameters
+ * @param prog Program to be loaded
+ */
+static void spi_engine_offload_load(struct spi_engine_desc *eng_desc,
+				    struct spi_engine_offload_program *prog)
+{
+	uint32_t i;
 
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 1);
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_RESET(0), 0);
 
-	eng_desc->offload_tx_len = 0;
-	eng_desc->offload_rx_len = 0;
+	for (i = 0; i < prog->no_cmds; i++)
+		spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CMD_MEM(0),
+				 prog->cmds[i]);
 
-	transfer.cmds = (spi_engine_cmd_queue*)no_os_malloc(sizeof(*transfer.cmds));
+	if (prog->sdo)
+		for (i = 0; i < prog->len; i++)
+			spi_engine_write(eng_desc,
+					 SPI_ENGINE_REG_OFFLOAD_SDO_MEM(0),
+					 prog->sdo[i]);
 
-	if (!transfer.cmds)
-		return -1;
+	eng_desc->offload_prog = prog;
+}
+
+/**
+ * @brief Run a compiled program in offload mode
+ *
+ * The program is written in the offload memory only if it is not the one
+ * already loaded, otherwise only the DMA transfers are started again.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param prog Program compiled by spi_engine_offload_compile()
+ * @param tx_addr The address where the data that will be transmitted is
+ * situated
+ * @param rx_addr The address where the data that will be received is situated
+ * @param no_samples Number of time the program will be run
+ * @return int32_t - 0 if the transfer finished
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_offload_run(struct no_os_spi_desc *desc,
+			       struct spi_engine_offload_program *prog,
+			       uint32_t tx_addr, uint32_t rx_addr,
+			       uint32_t no_samples)
+{
+	struct spi_engine_desc	*eng_desc;
+	int32_t			ret;
 
-	transfer.tx_buf = msg.commands_data;
+	if (!desc || !prog)
+		return -EINVAL;
 
-	/* Load the commands into the message */
-	transfer.cmds->next = NULL;
-	transfer.cmds->cmd = msg.commands[0];
-	i = 1;
-	while (i < msg.no_commands) {
-		spi_engine_queue_add_cmd(&transfer.cmds, msg.commands[i++]);
+	eng_desc = desc->extra;
 
-	}
+	/* Check if offload is disabled */
+	if (!((eng_desc->offload_config & OFFLOAD_TX_EN) |
+	      (eng_desc->offload_config & OFFLOAD_RX_EN)))
+		return -EINVAL;
 
-	ret = 0;
-	spi_engine_transfer_message(desc, &transfer);
+	if (eng_desc->offload_prog != prog)
+		spi_engine_offload_load(eng_desc, prog);
+
+	eng_desc->offload_tx_len = prog->len;
 
 	/* Start transfer */
 	spi_engine_write(eng_desc, SPI_ENGINE_REG_OFFLOAD_CTRL(0), 0x0001);
 	if (eng_desc->offload_config & OFFLOAD_TX_EN) {
 		struct axi_dma_transfer tx_transfer = {
 			// Number of bytes to write/read
-			.size = eng_desc->offload_tx_dma->width_src * eng_desc->offload_tx_len * no_samples,
+			.size = eng_desc->offload_tx_dma->width_src * prog->len * no_samples,
 			// Transfer done flag
 			.transfer_done = 0,
 			// Signal transfer mode
 			.cyclic = eng_desc->cyclic,
 			// Address of data source
-			.src_addr = (uintptr_t)msg.tx_addr,
+			.src_addr = (uintptr_t)tx_addr,
 			// Address of data destination
 			.dest_addr = 0
 		};
 		ret = axi_dmac_transfer_start(eng_desc->offload_tx_dma, &tx_transfer);
 		if (ret)
-			goto error;
+			return ret;
 	}
 
 	if (eng_desc->offload_config & OFFLOAD_RX_EN) {
 		struct axi_dma_transfer rx_transfer = {
 			// Number of bytes to write/read
-			.size = eng_desc->offload_rx_dma->width_src * eng_desc->offload_tx_len * no_samples,
+			.size = eng_desc->offload_rx_dma->width_src * prog->len * no_samples,
 			// Transfer done flag
 			.transfer_done = 0,
 			// Signal transfer mode
@@ -870,20 +1001,78 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 			// Address of data source
 			.src_addr = 0,
 			// Address of data destination
-			.dest_addr = (uintptr_t)msg.rx_addr
+			.dest_addr = (uintptr_t)rx_addr
 		};
 		ret = axi_dmac_transfer_start(eng_desc->offload_rx_dma, &rx_transfer);
 		if (ret)
-			goto error;
+			return ret;
 		ret = axi_dmac_transfer_wait_completion(eng_desc->offload_rx_dma, 500);
 		if (ret)
-			goto error;
+			return ret;
 	}
 
-	no_os_udelay(1000);
+	return 0;
+}
 
-error:
-	spi_engine_queue_no_os_free(&transfer.cmds);
+/**
+ * @brief Free a program compiled by spi_engine_offload_compile()
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param prog Program to be freed
+ * @return int32_t - 0 if the program was freed
+ *		   - -EINVAL if the parameters are invalid
+ */
+int32_t spi_engine_offload_program_remove(struct no_os_spi_desc *desc,
+		struct spi_engine_offload_program *prog)
+{
+	struct spi_engine_desc	*eng_desc;
+
+	if (!desc || !prog)
+		return -EINVAL;
+
+	eng_desc = desc->extra;
+
+	/* A new program may be allocated at the same address */
+	if (eng_desc->offload_prog == prog)
+		eng_desc->offload_prog = NULL;
+
+	no_os_free(prog->sdo);
+	no_os_free(prog->cmds);
+	no_os_free(prog);
+
+	return 0;
+}
+
+/**
+ * @brief Initiate a SPI transfer in offload mode
+ *
+ * The message is compiled and loaded in the offload memory on each call. Use
+ * spi_engine_offload_compile() and spi_engine_offload_run() when the same
+ * message is transferred more than once.
+ *
+ * @param desc Decriptor containing SPI interface parameters
+ * @param msg Offload message that get's to be transferred
+ * @param no_samples Number of time the messages will be transferred
+ * @return int32_t - 0 if the transfer finished
+ *		   - negative error code otherwise
+ */
+int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
+				    struct spi_engine_offload_message msg,
+				    uint32_t no_samples)
+{
+	struct spi_engine_offload_program	*prog;
+	int32_t					ret;
+
+	ret = spi_engine_offload_compile(desc, &msg, &prog);
+	if (ret)
+		return ret;
+
+	ret = spi_engine_offload_run(desc, prog, msg.tx_addr, msg.rx_addr,
+				     no_samples);
+	if (!ret)
+		no_os_udelay(1000);
+
+	spi_engine_offload_program_remove(desc, prog);
 
 	return ret;
 }
@@ -900,9 +1089,9 @@ int32_t spi_engine_remove(struct no_os_spi_desc *desc)
 
 	eng_desc = desc->extra;
 
-	if (eng_desc->offload_config & OFFLOAD_TX_EN)
+	if (eng_desc->offload_tx_dma)
 		axi_dmac_remove(eng_desc->offload_tx_dma);
-	if (eng_desc->offload_config & OFFLOAD_RX_EN)
+	if (eng_desc->offload_rx_dma)
 		axi_dmac_remove(eng_desc->offload_rx_dma);
 	no_os_free(desc->extra);
 	no_os_free(desc);
@@ -956,6 +1145,27 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 	return 0;
 }
 
+int32_t spi_engine_offload_compile(struct no_os_spi_desc *desc,
+				   struct spi_engine_offload_message *msg,
+				   struct spi_engine_offload_program **prog)
+{
+	return 0;
+}
+
+int32_t spi_engine_offload_run(struct no_os_spi_desc *desc,
+			       struct spi_engine_offload_program *prog,
+			       uint32_t tx_addr, uint32_t rx_addr,
+			       uint32_t no_samples)
+{
+	return 0;
+}
+
+int32_t spi_engine_offload_program_remove(struct no_os_spi_desc *desc,
+		struct spi_engine_offload_program *prog)
+{
+	return 0;
+}
+
 int32_t spi_engine_set_transfer_width(struct no_os_spi_desc *desc,
 				      uint8_t data_wdith)
 {
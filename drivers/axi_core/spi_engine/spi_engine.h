@@ -117,6 +117,10 @@ struct spi_engine_desc {
 	uint8_t 		max_data_width;
 	/**  output of SDO when CS is inactive or read-only transfers */
 	uint8_t			sdo_idle_state;
+	/** Program being compiled, commands are stored in it instead */
+	struct spi_engine_offload_program *compile_prog;
+	/** Program currently loaded in the offload memory */
+	struct spi_engine_offload_program *offload_prog;
 };
 
 
@@ -155,6 +159,25 @@ struct spi_engine_offload_message {
 	uint32_t rx_addr;
 };
 
+/**
+ * @struct spi_engine_offload_program
+ * @brief  Offload message compiled by spi_engine_offload_compile(). It is
+ * written in the offload memory by its first spi_engine_offload_run() and
+ * stays there until an other program is run. The clock divider, word width
+ * and mode of the device are part of the program, so it must be compiled
+ * again after changing them.
+ */
+struct spi_engine_offload_program {
+	/** Engine commands, including the configuration and sync ones */
+	uint32_t	*cmds;
+	/** Number of engine commands */
+	uint32_t	no_cmds;
+	/** Data words sent on SDO */
+	uint32_t	*sdo;
+	/** Number of words transferred each time the program runs */
+	uint8_t		len;
+};
+
 /**
  * @brief Spi engine platform specific SPI platform ops structure
  */
@@ -190,6 +213,21 @@ int32_t spi_engine_offload_transfer(struct no_os_spi_desc *desc,
 				    struct spi_engine_offload_message msg,
 				    uint32_t no_samples);
 
+/* Compile an offload message in a program that can be run many times */
+int32_t spi_engine_offload_compile(struct no_os_spi_desc *desc,
+				   struct spi_engine_offload_message *msg,
+				   struct spi_engine_offload_program **prog);
+
+/* Run a compiled program no_samples times, loading it only if needed */
+int32_t spi_engine_offload_run(struct no_os_spi_desc *desc,
+			       struct spi_engine_offload_program *prog,
+			       uint32_t tx_addr, uint32_t rx_addr,
+			       uint32_t no_samples);
+
+/* Free a program compiled by spi_engine_offload_compile() */
+int32_t spi_engine_offload_program_remove(struct no_os_spi_desc *desc,
+		struct spi_engine_offload_program *prog);
+
 /* Set SPI transfer width */
 int32_t spi_engine_set_transfer_width(struct no_os_spi_desc *desc,
 				      uint8_t data_wdith);
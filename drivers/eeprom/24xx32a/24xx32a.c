@@ -102,33 +102,26 @@ error_eeprom_dev:
 int32_t eeprom_24xx32a_read(struct no_os_eeprom_desc *desc, uint32_t address,
 			    uint8_t *data, uint16_t bytes)
 {
-	int32_t ret;
-	uint16_t indx;
 	uint8_t buff[2];
-	uint32_t curr_address = address;
 	struct eeprom_24xx32a_dev *eeprom_dev;
+	struct no_os_i2c_msg msgs[2] = {
+		{ .buf = buff, .len = sizeof(buff), .flags = 0 },
+		{ .buf = data, .len = bytes, .flags = NO_OS_I2C_M_RD },
+	};
 
 	if (!desc || !desc->extra || !data)
 		return -EINVAL;
 
-	eeprom_dev = desc->extra;
-
-	/* Perform byte by byte read */
-	for (indx = 0; indx < bytes; indx++) {
-		no_os_put_unaligned_be16(curr_address, buff);
+	if (!bytes)
+		return 0;
 
-		ret = no_os_i2c_write(eeprom_dev->i2c_desc, buff, sizeof(buff), 1);
-		if (ret)
-			return ret;
-
-		ret = no_os_i2c_read(eeprom_dev->i2c_desc, &data[indx], 1, 1);
-		if (ret)
-			return ret;
+	eeprom_dev = desc->extra;
 
-		curr_address++;
-	}
+	/* Sequential read: address write, repeated start, then all bytes */
+	no_os_put_unaligned_be16(address, buff);
 
-	return 0;
+	return no_os_i2c_transfer(eeprom_dev->i2c_desc, msgs,
+				  NO_OS_ARRAY_SIZE(msgs));
 }
 
 /**
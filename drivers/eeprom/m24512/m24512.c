@@ -186,6 +186,7 @@ int32_t m24512_read_data(struct no_os_eeprom_desc *desc, uint32_t address,
 			 uint8_t *data, uint16_t len)
 {
 	uint16_t addr = (uint16_t)address;
+	struct no_os_i2c_msg msgs[2];
 	struct m24512_dev *dev;
 	uint8_t addr_buf[2];
 	int ret;
@@ -207,13 +208,15 @@ int32_t m24512_read_data(struct no_os_eeprom_desc *desc, uint32_t address,
 	addr_buf[0] = M24512_ADDR_HIGH_BYTE(addr);
 	addr_buf[1] = M24512_ADDR_LOW_BYTE(addr);
 
-	// Write address, then read data
-	ret = no_os_i2c_write(dev->i2c_desc, addr_buf, 2, 0);
-	if (ret)
-		return ret;
+	// Write address, then read data after a repeated start
+	msgs[0].buf = addr_buf;
+	msgs[0].len = 2;
+	msgs[0].flags = 0;
+	msgs[1].buf = data;
+	msgs[1].len = len;
+	msgs[1].flags = NO_OS_I2C_M_RD;
 
-	ret = no_os_i2c_read(dev->i2c_desc, data, len, 1);
-	return ret;
+	return no_os_i2c_transfer(dev->i2c_desc, msgs, 2);
 }
 
 /**
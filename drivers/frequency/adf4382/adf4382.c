@@ -38,6 +38,7 @@
 #include "no_os_error.h"
 #include "no_os_print_log.h"
 #include "no_os_util.h"
+#include "no_os_regmap.h"
 
 /* Charge pump current values expressed in uA */
 static const int adf4382_ci_ua[] = {
@@ -59,21 +60,50 @@ static const int adf4382_ci_ua[] = {
 	11100
 };
 
+/* Registers implemented by the device, the gaps between them are reserved */
+static const struct no_os_regmap_range adf4382_rd_ranges[] = {
+	{ 0x000, 0x067 },
+	{ 0x100, 0x111 },
+	{ 0x200, ADF4382_MAX_REG },
+};
+
+static const struct no_os_regmap_table adf4382_rd_table = {
+	.ranges = adf4382_rd_ranges,
+	.nb_ranges = NO_OS_ARRAY_SIZE(adf4382_rd_ranges),
+};
+
+/* Registers changed by the device, which are never cached */
+static const struct no_os_regmap_range adf4382_volatile_ranges[] = {
+	/* Soft reset, self clearing */
+	{ 0x000, 0x000 },
+	/* Scratchpad, written and read back to check the SPI link */
+	{ 0x00A, 0x00A },
+	/* PHASE_ADJ, self clearing */
+	{ 0x034, 0x034 },
+	/* Status and readback */
+	{ 0x058, 0x067 },
+};
+
+static const struct no_os_regmap_table adf4382_volatile_table = {
+	.ranges = adf4382_volatile_ranges,
+	.nb_ranges = NO_OS_ARRAY_SIZE(adf4382_volatile_ranges),
+};
+
 /**
- * @brief Writes data to ADF4382 over SPI.
- * @param dev	   - The device structure.
+ * @brief Writes a register of the ADF4382 over SPI. Used by the register
+ * map.
+ * @param map	   - The register map, whose bus is the device structure.
  * @param reg_addr - The register address.
  * @param data 	   - Data value to write.
  * @return 	   - 0 in case of success or negative error code otherwise.
  */
-int adf4382_spi_write(struct adf4382_dev *dev, uint16_t reg_addr, uint8_t data)
+static int adf4382_bus_write(struct no_os_regmap *map, uint32_t reg_addr,
+			     uint32_t data)
 {
+	struct adf4382_dev *dev = map->bus;
 	uint8_t buff[ADF4382_BUFF_SIZE_BYTES];
 	uint16_t cmd;
 
-	if (!dev)
-		return -EINVAL;
-
 	cmd = ADF4382_SPI_WRITE_CMD | reg_addr;
 	if (dev->spi_desc->bit_order) {
 		buff[0] = no_os_bit_swap_constant_8(cmd & 0xFF);
@@ -90,20 +120,19 @@ int adf4382_spi_write(struct adf4382_dev *dev, uint16_t reg_addr, uint8_t data)
 }
 
 /**
- * @brief Reads data from ADF4382 over SPI.
- * @param dev 	   - The device structure.
+ * @brief Reads a register of the ADF4382 over SPI. Used by the register map.
+ * @param map	   - The register map, whose bus is the device structure.
  * @param reg_addr - The register address.
  * @param data	   - Data read from the device.
  * @return	   - 0 in case of success or negative error code otherwise.
  */
-int adf4382_spi_read(struct adf4382_dev *dev, uint16_t reg_addr, uint8_t *data)
+static int adf4382_bus_read(struct no_os_regmap *map, uint32_t reg_addr,
+			    uint32_t *data)
 {
-	int ret;
+	struct adf4382_dev *dev = map->bus;
 	uint8_t buff[ADF4382_BUFF_SIZE_BYTES];
 	uint16_t cmd;
-
-	if (!dev)
-		return -EINVAL;
+	int ret;
 
 	cmd = ADF4382_SPI_READ_CMD | reg_addr;
 	if (dev->spi_desc->bit_order) {
@@ -126,33 +155,69 @@ int adf4382_spi_read(struct adf4382_dev *dev, uint16_t reg_addr, uint8_t *data)
 	return 0;
 }
 
+static const struct no_os_regmap_bus_ops adf4382_bus_ops = {
+	.reg_read = adf4382_bus_read,
+	.reg_write = adf4382_bus_write,
+};
+
 /**
- * @brief Updates the values of the ADF4382 register.
+ * @brief Writes data to ADF4382 over SPI.
+ * @param dev	   - The device structure.
+ * @param reg_addr - The register address.
+ * @param data 	   - Data value to write.
+ * @return 	   - 0 in case of success or negative error code otherwise.
+ */
+int adf4382_spi_write(struct adf4382_dev *dev, uint16_t reg_addr, uint8_t data)
+{
+	if (!dev)
+		return -EINVAL;
+
+	return no_os_regmap_write(dev->regmap, reg_addr, data);
+}
+
+/**
+ * @brief Reads data from ADF4382 over SPI. Registers which are not volatile
+ * are read from the register cache.
  * @param dev 	   - The device structure.
  * @param reg_addr - The register address.
- * @param mask 	   - Bits to be updated.
- * @param data 	   - Update value for the mask.
+ * @param data	   - Data read from the device.
  * @return	   - 0 in case of success or negative error code otherwise.
  */
-int adf4382_spi_update_bits(struct adf4382_dev *dev, uint16_t reg_addr,
-			    uint8_t mask, uint8_t data)
+int adf4382_spi_read(struct adf4382_dev *dev, uint16_t reg_addr, uint8_t *data)
 {
-	uint8_t tmp, orig;
+	uint32_t val;
 	int ret;
 
-	ret = adf4382_spi_read(dev, reg_addr, &orig);
+	if (!dev)
+		return -EINVAL;
+
+	ret = no_os_regmap_read(dev->regmap, reg_addr, &val);
 	if (ret)
 		return ret;
 
-	tmp = orig & ~mask;
-	tmp |= data & mask;
-
-	if (tmp != orig)
-		return adf4382_spi_write(dev, reg_addr, tmp);
+	*data = val;
 
 	return 0;
 }
 
+/**
+ * @brief Updates the values of the ADF4382 register. Only the write goes on
+ * the bus for cached registers.
+ * @param dev 	   - The device structure.
+ * @param reg_addr - The register address.
+ * @param mask 	   - Bits to be updated.
+ * @param data 	   - Update value for the mask.
+ * @return	   - 0 in case of success or negative error code otherwise.
+ */
+int adf4382_spi_update_bits(struct adf4382_dev *dev, uint16_t reg_addr,
+			    uint8_t mask, uint8_t data)
+{
+	if (!dev)
+		return -EINVAL;
+
+	return no_os_regmap_update_bits(dev->regmap, reg_addr, mask, data);
+}
+
 /**
  * @brief Will output on the terminal the values of all the ADF4382 registers.
  * @param dev 	- The device structure.
@@ -1989,6 +2054,15 @@ static int adf4383_update_core_bias_table(struct adf4382_dev *dev)
 int adf4382_init(struct adf4382_dev **dev,
 		 struct adf4382_init_param *init_param)
 {
+	struct no_os_regmap_init_param regmap_ip = {
+		.bus_ops = &adf4382_bus_ops,
+		.reg_bits = 16,
+		.val_bits = 8,
+		.max_register = ADF4382_MAX_REG,
+		.rd_table = &adf4382_rd_table,
+		.volatile_table = &adf4382_volatile_table,
+		.cache_type = NO_OS_REGMAP_CACHE_FLAT,
+	};
 	struct adf4382_dev *device;
 	bool en = true;
 	uint8_t i;
@@ -2002,6 +2076,11 @@ int adf4382_init(struct adf4382_dev **dev,
 	if (ret)
 		goto error_dev;
 
+	regmap_ip.bus = device;
+	ret = no_os_regmap_init(&device->regmap, &regmap_ip);
+	if (ret)
+		goto error_spi;
+
 	device->spi_3wire_en = init_param->spi_3wire_en;
 	device->cmos_3v3 = init_param->cmos_3v3;
 	device->ref_freq_hz = init_param->ref_freq_hz;
@@ -2096,6 +2175,7 @@ int adf4382_init(struct adf4382_dev **dev,
 
 	return ret;
 error_spi:
+	no_os_regmap_remove(device->regmap);
 	no_os_spi_remove(device->spi_desc);
 error_dev:
 	no_os_free(device);
@@ -2111,6 +2191,7 @@ int adf4382_remove(struct adf4382_dev *dev)
 {
 	int ret;
 
+	no_os_regmap_remove(dev->regmap);
 	ret = no_os_spi_remove(dev->spi_desc);
 	if (ret)
 		no_os_free(dev);
@@ -39,6 +39,7 @@
 #include "no_os_units.h"
 #include "no_os_util.h"
 #include "no_os_spi.h"
+#include "no_os_regmap.h"
 
 /* ADF4382 REG0000 Map */
 #define ADF4382_SOFT_RESET_R_MSK		NO_OS_BIT(7)
@@ -461,6 +462,7 @@
 #define ADF4382_SPI_READ_CMD			0x8000
 #define ADF4382_SPI_DUMMY_DATA			0x00
 #define ADF4382_BUFF_SIZE_BYTES			3
+#define ADF4382_MAX_REG				0x273
 #define ADF4382_VCO_FREQ_MIN			11000000000U	// 11GHz
 #define ADF4382_VCO_FREQ_MAX			22000000000U	// 22GHz
 #define ADF4383_VCO_FREQ_MIN			10000000000U	// 10GHz
@@ -551,6 +553,8 @@ struct adf4382_init_param {
 struct adf4382_dev {
 	/** SPI Descriptor */
 	struct no_os_spi_desc		*spi_desc;
+	/** Register map, caching the configuration registers */
+	struct no_os_regmap		*regmap;
 	bool				spi_3wire_en;
 	bool				cmos_3v3;
 	uint64_t			ref_freq_hz;
@@ -287,7 +287,9 @@ static int hmc7044_write(struct hmc7044_dev *dev,
 	buf[1] = cmd & 0xFF;
 	buf[2] = val;
 
-	return no_os_spi_write_and_read(dev->spi_desc, buf, NO_OS_ARRAY_SIZE(buf));
+	/* Sent right away unless a batch was started */
+	return no_os_spi_batch_append(dev->spi_desc, buf, NULL,
+				      NO_OS_ARRAY_SIZE(buf));
 }
 
 /**
@@ -649,6 +651,11 @@ static int32_t hmc7044_setup(struct hmc7044_dev *dev)
 
 	hmc7044_read_write_check(dev);
 
+	/* Send the register writes below in as few transfers as possible */
+	ret = no_os_spi_batch_begin(dev->spi_desc);
+	if (ret)
+		return ret;
+
 	/* Disable all channels */
 	for (i = 0; i < HMC7044_NUM_CHAN; i++) {
 		ret = hmc7044_write(dev, HMC7044_REG_CH_OUT_CRTL_0(i), 0);
@@ -844,8 +851,16 @@ static int32_t hmc7044_setup(struct hmc7044_dev *dev)
 			return ret;
 	}
 
+	ret = no_os_spi_batch_commit(dev->spi_desc);
+	if (ret)
+		return ret;
+
 	no_os_mdelay(10);
 
+	ret = no_os_spi_batch_begin(dev->spi_desc);
+	if (ret)
+		return ret;
+
 	/* Program the output channels */
 	for (i = 0; i < dev->num_channels; i++) {
 		chan = &dev->channels[i];
@@ -891,6 +906,11 @@ static int32_t hmc7044_setup(struct hmc7044_dev *dev)
 		if (ret)
 			return ret;
 	}
+
+	ret = no_os_spi_batch_commit(dev->spi_desc);
+	if (ret)
+		return ret;
+
 	no_os_mdelay(10);
 
 	/* Do a restart to reset the system and initiate calibration */
@@ -848,7 +848,7 @@ int max22516_init(struct max22516_dev **device,
 	return 0;
 
 error_dev:
-	free(dev);
+	no_os_free(dev);
 
 	return ret;
 }
@@ -866,7 +866,7 @@ int max22516_remove(struct max22516_dev *dev)
 	if (ret)
 		return ret;
 
-	free(dev);
+	no_os_free(dev);
 
 	return ret;
 }
@@ -43,7 +43,7 @@
 #include "no_os_print_log.h"
 
 NO_OS_DECLARE_CRC8_TABLE(ade9113_crc8);
-NO_OS_DECLARE_CRC16_TABLE(ade9113_crc16);
+NO_OS_DECLARE_CRC16_SLICE_TABLE(ade9113_crc16);
 
 /**
  * @brief Read device register.
@@ -123,8 +123,9 @@ int ade9113_read(struct ade9113_dev *dev, uint8_t reg_addr, uint8_t *reg_data,
 
 	/* check received CRC, if enabled */
 	if (dev->crc_en) {
-		crc16 = no_os_crc16(ade9113_crc16, &buff[position], no_of_read_bytes - 2,
-				    ADE9113_CRC16_INIT_VAL);
+		crc16 = no_os_crc16_slice(ade9113_crc16, &buff[position],
+					  no_of_read_bytes - 2,
+					  ADE9113_CRC16_INIT_VAL);
 
 		recv_crc = no_os_get_unaligned_le16(&buff[position + no_of_read_bytes - 2]);
 
@@ -231,8 +232,8 @@ int ade9113_read_dc(struct ade9113_dev *dev, uint8_t reg_addr,
 	/* check received CRC, if enabled */
 	if (dev->crc_en) {
 		for (i = 0; i < dev->no_devs; i++) {
-			crc16 = no_os_crc16(ade9113_crc16, &buff[i * 16], 16 - 2,
-					    ADE9113_CRC16_INIT_VAL);
+			crc16 = no_os_crc16_slice(ade9113_crc16, &buff[i * 16], 16 - 2,
+						  ADE9113_CRC16_INIT_VAL);
 
 			recv_crc = no_os_get_unaligned_le16(&buff[(i + 1) * 16 - 2]);
 
@@ -497,7 +498,7 @@ int ade9113_init(struct ade9113_dev **device,
 	no_os_crc8_populate_msb(ade9113_crc8, ADE9113_CRC8_POLY);
 
 	/* Create the CRC-16 lookup table for polynomial ADE9113_CRC8_POLY */
-	no_os_crc16_populate_msb(ade9113_crc16, ADE9113_CRC16_POLY);
+	no_os_crc16_populate_msb_slice(ade9113_crc16, ADE9113_CRC16_POLY);
 
 	/* CRC enabled by default */
 	dev->crc_en = 1;
@@ -76,7 +76,7 @@ free_mdio:
 free_reset:
 	no_os_gpio_remove(d->reset_gpio);
 free_d:
-	free(d);
+	no_os_free(d);
 	return ret;
 }
 
@@ -113,7 +113,7 @@ int adin1300_remove(struct adin1300_desc *dev)
 {
 	no_os_mdio_remove(dev->mdio);
 	no_os_gpio_remove(dev->reset_gpio);
-	free(dev);
+	no_os_free(dev);
 	return 0;
 }
 
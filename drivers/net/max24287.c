@@ -74,7 +74,7 @@ free_mdio:
 free_reset:
 	no_os_gpio_remove(d->reset_gpio);
 free_d:
-	free(d);
+	no_os_free(d);
 	return ret;
 }
 
@@ -200,7 +200,6 @@ static int32_t aducm3029_i2c_write(struct no_os_i2c_desc *desc,
 	ADI_I2C_TRANSACTION trans[1];
 	uint32_t errors;
 	int32_t ret;
-	uint8_t *temp_ptr = NULL;
 
 	ret = set_transmission_configuration(desc);
 	if (ret < 0)
@@ -215,18 +214,11 @@ static int32_t aducm3029_i2c_write(struct no_os_i2c_desc *desc,
 
 	if (stop_bit == 0) {
 		aducm_i2c->prologue_size = bytes_number;
-		if (aducm_i2c->prologue_data) {
-			temp_ptr = realloc(aducm_i2c->prologue_data, bytes_number);
-			if (!temp_ptr) {
-				no_os_free(aducm_i2c->prologue_data);
-				return -1;
-			}
-			aducm_i2c->prologue_data = temp_ptr;
-		} else {
-			aducm_i2c->prologue_data = no_os_malloc(bytes_number);
-			if (!aducm_i2c->prologue_data)
-				return -1;
-		}
+		/* The previous prologue is replaced, not extended */
+		no_os_free(aducm_i2c->prologue_data);
+		aducm_i2c->prologue_data = no_os_malloc(bytes_number);
+		if (!aducm_i2c->prologue_data)
+			return -1;
 		memcpy(aducm_i2c->prologue_data, data, bytes_number);
 
 		return 0;
@@ -63,3 +63,40 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	return 0;
 }
 
+/**
+ * @brief AXI IO Altera specific read of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - variable where returned data is stored
+ * @param len - number of 32 bit registers to read
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			       uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		data[i] = IORD_32DIRECT(base, offset + i * 4);
+
+	return 0;
+}
+
+/**
+ * @brief AXI IO Altera specific write of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - data to be written
+ * @param len - number of 32 bit registers to write
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_bulk(uint32_t base, uint32_t offset,
+				const uint32_t *data, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		IOWR_32DIRECT(base, offset + i * 4, data[i]);
+
+	return 0;
+}
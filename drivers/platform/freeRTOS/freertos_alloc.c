@@ -37,6 +37,34 @@
 #include "portable.h"
 #include <string.h>
 
+#ifdef NO_OS_ALLOC_STATS
+
+/*
+ * no_os_malloc/no_os_calloc/no_os_free are implemented by util/no_os_alloc.c
+ * to keep the statistics, the FreeRTOS heap is its heap backend.
+ */
+
+/**
+ * @brief Allocate memory from the FreeRTOS heap.
+ * @param size - Size of the memory block, in bytes.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_alloc_heap_malloc(size_t size)
+{
+	return pvPortMalloc(size);
+}
+
+/**
+ * @brief Deallocate memory allocated by no_os_alloc_heap_malloc().
+ * @param ptr - Pointer to the memory block.
+ */
+void no_os_alloc_heap_free(void *ptr)
+{
+	vPortFree(ptr);
+}
+
+#else
+
 /**
  * @brief Allocate memory and return a pointer to it.
  * @param size - Size of the memory block, in bytes.
@@ -75,3 +103,5 @@ void no_os_free(void *ptr)
 {
 	vPortFree(ptr);
 }
+
+#endif
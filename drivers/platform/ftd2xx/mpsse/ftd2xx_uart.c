@@ -59,7 +59,7 @@ static int ftd2xx_uart_init(struct no_os_uart_desc **desc,
  */
 static int ftd2xx_uart_remove(struct no_os_uart_desc *desc)
 {
-	free(desc);
+	no_os_free(desc);
 
 	return 0;
 };
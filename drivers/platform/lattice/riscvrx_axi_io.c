@@ -74,3 +74,41 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 	reg_32b_write(base + offset, data);
 	return 0;
 }
+
+/**
+ * @brief AXI IO Lattice specific read of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - variable where returned data is stored
+ * @param len - number of 32 bit registers to read
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			       uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		reg_32b_read(base + offset + i * 4, &data[i]);
+
+	return 0;
+}
+
+/**
+ * @brief AXI IO Lattice specific write of consecutive registers.
+ * @param base - Base address
+ * @param offset - Address offset of the first register
+ * @param data - data to be written
+ * @param len - number of 32 bit registers to write
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_bulk(uint32_t base, uint32_t offset,
+				const uint32_t *data, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		reg_32b_write(base + offset + i * 4, data[i]);
+
+	return 0;
+}
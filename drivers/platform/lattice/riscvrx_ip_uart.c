@@ -329,8 +329,6 @@ static int32_t latt_ip_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 {
 	struct latt_ip_uart_desc *latt_uart;
 	volatile struct uart_dev *dev;
-
-	int ret;
 	uint32_t i;
 
 	if (!desc || !desc->extra || !data)
@@ -346,10 +344,7 @@ static int32_t latt_ip_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 	dev = (volatile struct uart_dev *)(latt_uart->uart_instance->base);
 
 	if (desc->rx_fifo) {
-		for (i = 0; i < bytes_number; i++) {
-			ret = lf256fifo_read(desc->rx_fifo, &data[i]);
-			if (ret) break;
-		}
+		i = lf256fifo_read_bulk(desc->rx_fifo, data, bytes_number);
 		if (i) {
 			dev->ier |= UART_IER_RX_INT_MASK;
 			return (int32_t)i;
@@ -33,69 +33,172 @@
 
 #include <fcntl.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include "no_os_alloc.h"
 #include "no_os_error.h"
 #include "no_os_axi_io.h"
+#include "no_os_util.h"
+
+/* Highest UIO index (/dev/uioX) that can be mapped, plus one */
+#define LINUX_AXI_IO_MAX_UIO	64
 
 /**
- * @brief AXI IO through UIO read/write function.
+ * @struct linux_uio_map
+ * @brief Register window of a UIO device, mapped on first access and kept
+ * for the life of the process. It is never changed once published.
+ */
+struct linux_uio_map {
+	/** Start of the mapping */
+	void *addr;
+	/** Size of the mapping in bytes */
+	size_t size;
+};
+
+/*
+ * Current window of each UIO device, NULL if not mapped yet. Read without
+ * locking, replaced under uio_maps_lock when a larger window is needed.
+ */
+static struct linux_uio_map *uio_maps[LINUX_AXI_IO_MAX_UIO];
+static pthread_mutex_t uio_maps_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Get the size of the first memory region of a UIO device.
+ * @param base - UIO index (/dev/uioX).
+ * @return Size in bytes, 0 if it can't be read from sysfs.
+ */
+static size_t uio_map_size(uint32_t base)
+{
+	unsigned long size;
+	char buf[64];
+	FILE *f;
+	int ret;
+
+	sprintf(buf, "/sys/class/uio/uio%"PRIu32"/maps/map0/size", base);
+
+	f = fopen(buf, "r");
+	if (!f)
+		return 0;
+
+	ret = fscanf(f, "%lx", &size);
+	fclose(f);
+
+	return ret == 1 ? size : 0;
+}
+
+/**
+ * @brief Get a pointer to the registers of a UIO device, mapping them if
+ * they are not already mapped.
  * @param base - UIO index (/dev/uioX).
  * @param offset - Address offset.
- * @param read - Location where read data will be stored.
- * @param write - Data to be written.
- * @return 0 in case of success, -1 otherwise.
+ * @param len - Number of bytes that will be accessed starting at offset.
+ * @return Pointer to the register at offset, NULL in case of error.
  */
-static int32_t uio_read_write(uint32_t base, uint32_t offset, uint32_t *read,
-			      uint32_t *write)
+static volatile uint32_t *uio_map(uint32_t base, uint32_t offset,
+				  uint32_t len)
 {
+	struct linux_uio_map *map, *new_map;
+	volatile uint32_t *reg = NULL;
+	size_t size, end;
 	char buf[32];
-	int ret;
+	void *addr;
 	int uio_fd;
-	int32_t status = 0;
-	void *uio_addr;
+
+	if (base >= LINUX_AXI_IO_MAX_UIO) {
+		printf("%s: Invalid UIO index %"PRIu32"\n\r", __func__, base);
+		return NULL;
+	}
+
+	end = (size_t)offset + len;
+	map = __atomic_load_n(&uio_maps[base], __ATOMIC_ACQUIRE);
+	if (map && end <= map->size)
+		return (volatile uint32_t *)((uintptr_t)map->addr + offset);
+
+	pthread_mutex_lock(&uio_maps_lock);
+
+	/* Another thread may have mapped it in the meantime */
+	map = uio_maps[base];
+	if (map && end <= map->size) {
+		reg = (volatile uint32_t *)((uintptr_t)map->addr + offset);
+		goto unlock;
+	}
+
+	/*
+	 * Map the whole region when its size is known, so this happens only
+	 * once. Otherwise grow the mapping up to the highest offset accessed.
+	 */
+	size = uio_map_size(base);
+	size = no_os_max(size, end);
+
+	new_map = no_os_malloc(sizeof(*new_map));
+	if (!new_map)
+		goto unlock;
 
 	sprintf(buf, "/dev/uio%"PRIu32"", base);
 
 	uio_fd = open(buf, O_RDWR);
 	if (uio_fd < 0) {
 		printf("%s: Can't open %s\n\r", __func__, buf);
-		return -1;
+		goto free_map;
 	}
 
-	uio_addr = mmap(NULL,
-			offset + sizeof(*read),
-			PROT_READ | PROT_WRITE,
-			MAP_SHARED,
-			uio_fd,
-			0);
-	if (uio_addr == MAP_FAILED) {
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, uio_fd, 0);
+	/* The mapping is kept after the file is closed */
+	close(uio_fd);
+	if (addr == MAP_FAILED) {
 		printf("%s: mmap() failed\n\r", __func__);
-		status = -1;
-		goto close;
+		goto free_map;
 	}
 
-	if (read)
-		*read = *(uint32_t *)((uintptr_t)uio_addr + offset);
-	if (write)
-		*(uint32_t *)((uintptr_t)uio_addr + offset) = *write;
+	new_map->addr = addr;
+	new_map->size = size;
+	/*
+	 * A smaller window being replaced is left mapped, other threads may
+	 * still be accessing registers through it.
+	 */
+	__atomic_store_n(&uio_maps[base], new_map, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&uio_maps_lock);
 
-	ret = munmap(uio_addr, offset + sizeof(*read));
-	if (ret < 0) {
-		printf("%s: munmap() failed\n\r", __func__);
-		status = -1;
-	}
+	return (volatile uint32_t *)((uintptr_t)addr + offset);
 
-close:
-	ret = close(uio_fd);
-	if (ret < 0) {
-		printf("%s: Can't close %s\n\r", __func__, buf);
-		status = -1;
+free_map:
+	no_os_free(new_map);
+unlock:
+	pthread_mutex_unlock(&uio_maps_lock);
+
+	return reg;
+}
+
+/**
+ * @brief AXI IO through UIO read/write function.
+ * @param base - UIO index (/dev/uioX).
+ * @param offset - Address offset.
+ * @param read - Location where read data will be stored.
+ * @param write - Data to be written.
+ * @param len - Number of consecutive 32 bit registers to access.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t uio_read_write(uint32_t base, uint32_t offset, uint32_t *read,
+			      const uint32_t *write, uint32_t len)
+{
+	volatile uint32_t *reg;
+	uint32_t i;
+
+	reg = uio_map(base, offset, len * sizeof(*reg));
+	if (!reg)
+		return -1;
+
+	for (i = 0; i < len; i++) {
+		if (read)
+			read[i] = reg[i];
+		else
+			reg[i] = write[i];
 	}
 
-	return status;
+	return 0;
 }
 
 #ifdef DEVMEM
@@ -158,7 +261,7 @@ int32_t no_os_axi_io_read(uint32_t base, uint32_t offset, uint32_t *data)
 #ifdef DEVMEM
 	return devmem_read_write(base, offset, data, NULL);
 #else
-	return uio_read_write(base, offset, data, NULL);
+	return uio_read_write(base, offset, data, NULL, 1);
 #endif
 }
 
@@ -174,6 +277,57 @@ int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data)
 #ifdef DEVMEM
 	return devmem_read_write(base, offset, NULL, &data);
 #else
-	return uio_read_write(base, offset, NULL, &data);
+	return uio_read_write(base, offset, NULL, &data, 1);
+#endif
+}
+
+/**
+ * @brief AXI IO through UIO/devmem read of consecutive registers.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Location where read data will be stored.
+ * @param len - Number of 32 bit registers to read.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			       uint32_t len)
+{
+#ifdef DEVMEM
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		if (devmem_read_write(base, offset + i * 4, &data[i], NULL))
+			return -1;
+
+	return 0;
+#else
+	return uio_read_write(base, offset, data, NULL, len);
+#endif
+}
+
+/**
+ * @brief AXI IO through UIO/devmem write of consecutive registers.
+ * @param base - UIO index (/dev/uioX)/base address.
+ * @param offset - Address offset of the first register.
+ * @param data - Data to be written.
+ * @param len - Number of 32 bit registers to write.
+ * @return 0 in case of success, -1 otherwise.
+ */
+int32_t no_os_axi_io_write_bulk(uint32_t base, uint32_t offset,
+				const uint32_t *data, uint32_t len)
+{
+#ifdef DEVMEM
+	uint32_t i;
+	uint32_t val;
+
+	for (i = 0; i < len; i++) {
+		val = data[i];
+		if (devmem_read_write(base, offset + i * 4, NULL, &val))
+			return -1;
+	}
+
+	return 0;
+#else
+	return uio_read_write(base, offset, NULL, data, len);
 #endif
 }
@@ -0,0 +1,395 @@
+/***************************************************************************//**
+ *   @file   linux/linux_dma.c
+ *   @brief  Allocator of DMA capable memory using u-dma-buf and a DMA
+ *           platform doing the transfers with the CPU.
+********************************************************************************
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_list.h"
+#include "no_os_util.h"
+#include "linux_dma.h"
+
+/* Regions initialized with linux_dma_mem_init() */
+static struct linux_dma_mem *linux_dma_regions;
+
+/**
+ * @brief Read a numeric attribute of a u-dma-buf device.
+ * @param name - Name of the device.
+ * @param attr - Name of the attribute.
+ * @param val - The value of the attribute.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_dma_read_attr(const char *name, const char *attr,
+			       unsigned long long *val)
+{
+	char path[128];
+	FILE *f;
+	int ret;
+
+	snprintf(path, sizeof(path), "/sys/class/u-dma-buf/%s/%s", name, attr);
+
+	f = fopen(path, "r");
+	if (!f) {
+		printf("%s: Can't open %s\n\r", __func__, path);
+		return -errno;
+	}
+
+	/* phys_addr is printed in hex with a 0x prefix, size in decimal */
+	ret = fscanf(f, "%lli", val);
+	fclose(f);
+
+	return ret == 1 ? 0 : -EIO;
+}
+
+/**
+ * @brief Map a region of DMA capable memory.
+ * @param mem - The region.
+ * @param param - Parameters of the region.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int linux_dma_mem_init(struct linux_dma_mem **mem,
+		       const struct linux_dma_mem_init_param *param)
+{
+	struct linux_dma_mem *region;
+	unsigned long long phys = 0;
+	unsigned long long size;
+	char path[64];
+	void *virt;
+	int ret;
+	int fd;
+
+	if (!mem || !param || !param->name)
+		return -EINVAL;
+
+	if (param->size) {
+		size = param->size;
+		fd = open(param->name, O_RDWR | O_CREAT, 0600);
+		if (fd >= 0 && ftruncate(fd, size)) {
+			close(fd);
+			fd = -1;
+		}
+	} else {
+		ret = linux_dma_read_attr(param->name, "phys_addr", &phys);
+		if (ret)
+			return ret;
+
+		ret = linux_dma_read_attr(param->name, "size", &size);
+		if (ret)
+			return ret;
+
+		snprintf(path, sizeof(path), "/dev/%s", param->name);
+		/* O_SYNC makes the mapping uncached, no cache maintenance needed */
+		fd = open(path, O_RDWR | O_SYNC);
+	}
+	if (fd < 0) {
+		printf("%s: Can't open %s\n\r", __func__, param->name);
+		return -errno;
+	}
+
+	virt = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (virt == MAP_FAILED) {
+		printf("%s: mmap() failed\n\r", __func__);
+		return -ENOMEM;
+	}
+
+	region = no_os_calloc(1, sizeof(*region));
+	if (!region) {
+		munmap(virt, size);
+		return -ENOMEM;
+	}
+
+	region->virt = virt;
+	region->phys = param->size ? (uintptr_t)virt : (uintptr_t)phys;
+	region->size = size;
+	region->next = linux_dma_regions;
+	linux_dma_regions = region;
+
+	*mem = region;
+
+	return 0;
+}
+
+/**
+ * @brief Unmap a region. Buffers allocated from it must no longer be used.
+ * @param mem - The region.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int linux_dma_mem_remove(struct linux_dma_mem *mem)
+{
+	struct linux_dma_mem **it;
+
+	if (!mem)
+		return -EINVAL;
+
+	for (it = &linux_dma_regions; *it; it = &(*it)->next) {
+		if (*it == mem) {
+			*it = mem->next;
+			break;
+		}
+	}
+
+	munmap(mem->virt, mem->size);
+	no_os_free(mem);
+
+	return 0;
+}
+
+/**
+ * @brief Allocate a buffer from a region. Buffers are released only when the
+ * region is removed, so this is meant for buffers allocated at init.
+ * @param mem - The region.
+ * @param size - Size of the buffer in bytes.
+ * @param phys - If not NULL, set to the physical address of the buffer.
+ * @return The buffer, aligned to LINUX_DMA_ALIGN, or NULL if the region has
+ * no room left.
+ */
+void *linux_dma_alloc(struct linux_dma_mem *mem, uint32_t size,
+		      uintptr_t *phys)
+{
+	uint32_t start;
+
+	if (!mem || !size)
+		return NULL;
+
+	start = no_os_align(mem->used, LINUX_DMA_ALIGN);
+	if (start > mem->size || size > mem->size - start)
+		return NULL;
+
+	mem->used = start + size;
+	if (phys)
+		*phys = mem->phys + start;
+
+	return mem->virt + start;
+}
+
+/**
+ * @brief Get the physical address of a buffer allocated with
+ * linux_dma_alloc(). Can be used as the virt_to_phys callback of the AXI IIO
+ * drivers.
+ * @param addr - Address inside a buffer.
+ * @return The physical address, 0 if addr is not inside a region.
+ */
+uintptr_t linux_dma_virt_to_phys(void *addr)
+{
+	struct linux_dma_mem *mem;
+	uintptr_t offset;
+
+	for (mem = linux_dma_regions; mem; mem = mem->next) {
+		offset = (uintptr_t)addr - (uintptr_t)mem->virt;
+		if ((uintptr_t)addr >= (uintptr_t)mem->virt && offset < mem->size)
+			return mem->phys + offset;
+	}
+
+	printf("%s: %p is not DMA capable memory\n\r", __func__, addr);
+
+	return 0;
+}
+
+/**
+ * @brief Initialize the DMA controller.
+ * @param desc - The DMA controller descriptor.
+ * @param param - Initialization parameter for the DMA controller.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_dma_init(struct no_os_dma_desc **desc,
+			  struct no_os_dma_init_param *param)
+{
+	struct no_os_dma_desc *descriptor;
+	uint32_t i;
+
+	if (!desc || !param || !param->num_ch)
+		return -EINVAL;
+
+	descriptor = no_os_calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	descriptor->channels = no_os_calloc(param->num_ch,
+					    sizeof(*descriptor->channels));
+	if (!descriptor->channels) {
+		no_os_free(descriptor);
+		return -ENOMEM;
+	}
+
+	descriptor->id = param->id;
+	descriptor->num_ch = param->num_ch;
+	descriptor->sg_handler = param->sg_handler;
+	descriptor->extra = param->extra;
+
+	for (i = 0; i < param->num_ch; i++) {
+		descriptor->channels[i].id = i;
+		descriptor->channels[i].free = true;
+	}
+
+	*desc = descriptor;
+
+	return 0;
+}
+
+/**
+ * @brief Free the resources allocated by linux_dma_init().
+ * @param desc - The DMA controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_dma_remove(struct no_os_dma_desc *desc)
+{
+	if (!desc)
+		return -EINVAL;
+
+	no_os_free(desc->channels);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Get a free channel and mark it as busy.
+ * @param desc - The DMA controller descriptor.
+ * @param ch_num - The number of the acquired channel.
+ * @return 0 in case of success, -EBUSY if all channels are busy.
+ */
+static int linux_dma_acquire_ch(struct no_os_dma_desc *desc, uint32_t *ch_num)
+{
+	uint32_t i;
+
+	for (i = 0; i < desc->num_ch; i++) {
+		if (desc->channels[i].free && !desc->channels[i].sync_lock) {
+			desc->channels[i].free = false;
+			*ch_num = i;
+			return 0;
+		}
+	}
+
+	return -EBUSY;
+}
+
+/**
+ * @brief Mark a channel as free.
+ * @param desc - The DMA controller descriptor.
+ * @param ch_num - The number of the channel.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_dma_release_ch(struct no_os_dma_desc *desc, uint32_t ch_num)
+{
+	if (ch_num >= desc->num_ch)
+		return -EINVAL;
+
+	desc->channels[ch_num].free = true;
+
+	return 0;
+}
+
+/**
+ * @brief Nothing to configure, the transfers are read from the channel's
+ * list when started.
+ * @param ch - The DMA channel.
+ * @param xfer - The transfer.
+ * @return 0
+ */
+static int linux_dma_config_xfer(struct no_os_dma_ch *ch,
+				 struct no_os_dma_xfer_desc *xfer)
+{
+	return 0;
+}
+
+/**
+ * @brief Do all the transfers of a channel's list and call their complete
+ * callbacks. The channel is free when this returns.
+ * @param desc - The DMA controller descriptor.
+ * @param ch - The DMA channel.
+ * @return 0 in case of success, -ENOTSUP if the list has transfers other than
+ * memory to memory, in which case none of them is done.
+ */
+static int linux_dma_xfer_start(struct no_os_dma_desc *desc,
+				struct no_os_dma_ch *ch)
+{
+	struct no_os_dma_xfer_desc *next;
+	struct no_os_dma_xfer_desc *xfer;
+	struct no_os_list_node *node;
+
+	no_os_list_node_for_each(node, &ch->sg_list) {
+		xfer = no_os_list_entry(node, struct no_os_dma_xfer_desc, node);
+		if (xfer->xfer_type != MEM_TO_MEM) {
+			while (no_os_list_node_pop_first(&ch->sg_list))
+				;
+			ch->free = true;
+
+			return -ENOTSUP;
+		}
+	}
+
+	while ((node = no_os_list_node_pop_first(&ch->sg_list))) {
+		xfer = no_os_list_entry(node, struct no_os_dma_xfer_desc, node);
+		memcpy(xfer->dst, xfer->src, xfer->length);
+
+		node = no_os_list_node_first(&ch->sg_list);
+		next = node ? no_os_list_entry(node, struct no_os_dma_xfer_desc,
+					       node) : NULL;
+		if (xfer->xfer_complete_cb)
+			xfer->xfer_complete_cb(xfer, next, xfer->xfer_complete_ctx);
+	}
+
+	ch->free = true;
+
+	return 0;
+}
+
+/**
+ * @brief Transfers are done synchronously, there is nothing to abort.
+ * @param desc - The DMA controller descriptor.
+ * @param ch - The DMA channel.
+ * @return 0
+ */
+static int linux_dma_xfer_abort(struct no_os_dma_desc *desc,
+				struct no_os_dma_ch *ch)
+{
+	return 0;
+}
+
+/**
+ * @brief Linux DMA platform ops, memory to memory transfers done by the CPU.
+ */
+const struct no_os_dma_platform_ops linux_dma_ops = {
+	.dma_init = linux_dma_init,
+	.dma_remove = linux_dma_remove,
+	.dma_acquire_ch = linux_dma_acquire_ch,
+	.dma_release_ch = linux_dma_release_ch,
+	.dma_config_xfer = linux_dma_config_xfer,
+	.dma_xfer_start = linux_dma_xfer_start,
+	.dma_xfer_abort = linux_dma_xfer_abort,
+};
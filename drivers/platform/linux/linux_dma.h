@@ -0,0 +1,96 @@
+/***************************************************************************//**
+ *   @file   linux/linux_dma.h
+ *   @brief  Header file of the Linux DMA memory allocator and DMA platform.
+********************************************************************************
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef LINUX_DMA_H_
+#define LINUX_DMA_H_
+
+#include <stdint.h>
+#include "no_os_dma.h"
+
+/* Alignment of the buffers returned by linux_dma_alloc() */
+#define LINUX_DMA_ALIGN		64
+
+/**
+ * @struct linux_dma_mem_init_param
+ * @brief Parameters of a region of DMA capable memory.
+ */
+struct linux_dma_mem_init_param {
+	/**
+	 * Name of a u-dma-buf device (/dev/name). Its physical address and
+	 * size are read from /sys/class/u-dma-buf/name.
+	 * If size is not 0, path of a file backing a fake region instead, for
+	 * tests without DMA hardware. The physical addresses of a fake region
+	 * are its virtual addresses.
+	 */
+	const char *name;
+	/** Size of the file backed region, 0 for a u-dma-buf device */
+	uint32_t size;
+};
+
+/**
+ * @struct linux_dma_mem
+ * @brief Region of DMA capable memory mapped in the process.
+ */
+struct linux_dma_mem {
+	/** Start of the mapping */
+	uint8_t *virt;
+	/** Physical address of the start of the region */
+	uintptr_t phys;
+	/** Size of the region in bytes */
+	uint32_t size;
+	/** Bytes already allocated from the start of the region */
+	uint32_t used;
+	/** Next initialized region */
+	struct linux_dma_mem *next;
+};
+
+/* Map a region of DMA capable memory. */
+int linux_dma_mem_init(struct linux_dma_mem **mem,
+		       const struct linux_dma_mem_init_param *param);
+
+/* Unmap a region. Buffers allocated from it must no longer be used. */
+int linux_dma_mem_remove(struct linux_dma_mem *mem);
+
+/* Allocate a buffer from a region, for the life of the region. */
+void *linux_dma_alloc(struct linux_dma_mem *mem, uint32_t size,
+		      uintptr_t *phys);
+
+/* Physical address of a buffer allocated from any region, 0 if not found. */
+uintptr_t linux_dma_virt_to_phys(void *addr);
+
+/**
+ * @brief Linux DMA platform ops, memory to memory transfers done by the CPU.
+ * Stand-in for DMA controllers without a Linux userspace driver.
+ */
+extern const struct no_os_dma_platform_ops linux_dma_ops;
+
+#endif // LINUX_DMA_H_
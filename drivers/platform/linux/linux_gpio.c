@@ -334,6 +334,212 @@ int32_t linux_gpio_get_direction(struct no_os_gpio_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Obtain a GPIO group descriptor backed by one multi-line request.
+ * @param desc - The GPIO group descriptor.
+ * @param param - GPIO group initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_group_get(struct no_os_gpio_group_desc **desc,
+			     const struct no_os_gpio_group_init_param *param)
+{
+	struct linux_gpio_desc *linux_desc;
+	struct no_os_gpio_group_desc *descriptor;
+	struct gpio_v2_line_request line_request = {0};
+	char path[64];
+	int timeout;
+	uint32_t i;
+	int ret;
+
+	if (param->num > GPIO_V2_LINES_MAX)
+		return -EINVAL;
+
+	descriptor = no_os_calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	linux_desc = no_os_calloc(1, sizeof(*linux_desc));
+	if (!linux_desc) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	sprintf(path, "/dev/gpiochip%d", param->port);
+	timeout = GPIO_TIMEOUT_MS;
+	while (--timeout) {
+		linux_desc->chip_fd = open(path, O_RDONLY);
+		if (linux_desc->chip_fd >= 0)
+			break;
+		no_os_mdelay(1);
+	}
+	if (linux_desc->chip_fd < 0) {
+		ret = -errno;
+		printf("%s: Can't open %s\n\r", __func__, path);
+		goto free_linux_desc;
+	}
+
+	for (i = 0; i < param->num; i++) {
+		line_request.offsets[i] = param->numbers[i];
+		descriptor->numbers[i] = param->numbers[i];
+	}
+	line_request.num_lines = param->num;
+	ret = ioctl(linux_desc->chip_fd, GPIO_V2_GET_LINE_IOCTL, &line_request);
+	if (ret < 0) {
+		ret = -errno;
+		printf("%s: Can't get line request\n\r", __func__);
+		goto close_chip;
+	}
+	linux_desc->line_fd = line_request.fd;
+
+	descriptor->port = param->port;
+	descriptor->num = param->num;
+	descriptor->pull = param->pull;
+	descriptor->extra = linux_desc;
+	*desc = descriptor;
+
+	return 0;
+
+close_chip:
+	close(linux_desc->chip_fd);
+free_linux_desc:
+	no_os_free(linux_desc);
+free_desc:
+	no_os_free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by linux_gpio_group_get().
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_group_remove(struct no_os_gpio_group_desc *desc)
+{
+	struct linux_gpio_desc *linux_desc = desc->extra;
+	int ret = 0;
+
+	if (close(linux_desc->line_fd) < 0)
+		ret = -errno;
+	if (close(linux_desc->chip_fd) < 0 && !ret)
+		ret = -errno;
+
+	no_os_free(linux_desc);
+	no_os_free(desc);
+
+	return ret;
+}
+
+/**
+ * @brief Configure all the lines of a group with a single ioctl.
+ * @param desc - The GPIO group descriptor.
+ * @param flags - GPIO_V2_LINE_FLAG_INPUT or GPIO_V2_LINE_FLAG_OUTPUT.
+ * @param values - Initial output values, used only for outputs.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_gpio_group_config(struct no_os_gpio_group_desc *desc,
+				       uint64_t flags, uint32_t values)
+{
+	struct linux_gpio_desc *linux_desc = desc->extra;
+	struct gpio_v2_line_config line_config = {0};
+	int ret;
+
+	line_config.flags = flags;
+	if (flags & GPIO_V2_LINE_FLAG_OUTPUT) {
+		/* Lines start driving the requested values, without glitches */
+		line_config.num_attrs = 1;
+		line_config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		line_config.attrs[0].attr.values = values;
+		line_config.attrs[0].mask = (1ULL << desc->num) - 1;
+	}
+
+	ret = ioctl(linux_desc->line_fd, GPIO_V2_LINE_SET_CONFIG_IOCTL,
+		    &line_config);
+	if (ret < 0) {
+		ret = -errno;
+		printf("%s: Can't config lines\n\r", __func__);
+		return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Enable the input direction of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_group_direction_input(struct no_os_gpio_group_desc *desc)
+{
+	return linux_gpio_group_config(desc, GPIO_V2_LINE_FLAG_INPUT, 0);
+}
+
+/**
+ * @brief Enable the output direction of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Initial output values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_group_direction_output(struct no_os_gpio_group_desc *desc,
+		uint32_t values)
+{
+	return linux_gpio_group_config(desc, GPIO_V2_LINE_FLAG_OUTPUT, values);
+}
+
+/**
+ * @brief Set the GPIOs of the group selected by mask with a single ioctl.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - GPIOs to be updated, bit n for GPIO n of the group.
+ * @param values - New values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_group_set_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t values)
+{
+	struct linux_gpio_desc *linux_desc = desc->extra;
+	struct gpio_v2_line_values line_values = {0};
+	int ret;
+
+	line_values.bits = values;
+	line_values.mask = mask;
+	ret = ioctl(linux_desc->line_fd, GPIO_V2_LINE_SET_VALUES_IOCTL,
+		    &line_values);
+	if (ret < 0) {
+		ret = -errno;
+		printf("%s: Can't set line values\n\r", __func__);
+		return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of all the GPIOs of the group with a single ioctl.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Read values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t linux_gpio_group_get_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t *values)
+{
+	struct linux_gpio_desc *linux_desc = desc->extra;
+	struct gpio_v2_line_values line_values = {0};
+	int ret;
+
+	line_values.mask = (1ULL << desc->num) - 1;
+	ret = ioctl(linux_desc->line_fd, GPIO_V2_LINE_GET_VALUES_IOCTL,
+		    &line_values);
+	if (ret < 0) {
+		ret = -errno;
+		printf("%s: Can't get line values\n\r", __func__);
+		return ret;
+	}
+
+	*values = line_values.bits;
+
+	return 0;
+}
+
 /**
  * @brief Linux platform specific GPIO platform ops structure
  */
@@ -346,4 +552,10 @@ const struct no_os_gpio_platform_ops linux_gpio_ops = {
 	.gpio_ops_get_direction = &linux_gpio_get_direction,
 	.gpio_ops_set_value = &linux_gpio_set_value,
 	.gpio_ops_get_value = &linux_gpio_get_value,
+	.gpio_ops_group_get = &linux_gpio_group_get,
+	.gpio_ops_group_remove = &linux_gpio_group_remove,
+	.gpio_ops_group_direction_input = &linux_gpio_group_direction_input,
+	.gpio_ops_group_direction_output = &linux_gpio_group_direction_output,
+	.gpio_ops_group_set_values = &linux_gpio_group_set_values,
+	.gpio_ops_group_get_values = &linux_gpio_group_get_values,
 };
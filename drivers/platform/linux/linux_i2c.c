@@ -40,6 +40,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <linux/i2c.h>
@@ -72,8 +73,7 @@ int linux_i2c_add_msg(struct no_os_i2c_desc *desc,
 		      uint8_t read)
 {
 	struct linux_i2c_desc *linux_desc;
-	struct i2c_msg msg;
-	void *ptr;
+	struct i2c_msg msg, *msgs;
 
 	linux_desc = desc->extra;
 
@@ -87,18 +87,19 @@ int linux_i2c_add_msg(struct no_os_i2c_desc *desc,
 		msg.flags = 0;  // Write
 
 
-	if (linux_desc->messages) {
-		ptr = realloc(linux_desc->messages, sizeof(struct i2c_msg) *
-			      (linux_desc->len_messages + 1));
-		if (!ptr)
-			return -ENOMEM;
-		linux_desc->messages = ptr;
-	} else {
-		linux_desc->messages = no_os_malloc(sizeof(struct i2c_msg));
+	if (!linux_desc->messages)
 		linux_desc->len_messages = 0;
-		if (!linux_desc->messages)
-			return -ENOMEM;
-	}
+
+	/* Not realloc(), no_os_malloc memory may not come from the C library */
+	msgs = no_os_malloc(sizeof(*msgs) * (linux_desc->len_messages + 1));
+	if (!msgs)
+		return -ENOMEM;
+
+	if (linux_desc->messages)
+		memcpy(msgs, linux_desc->messages,
+		       sizeof(*msgs) * linux_desc->len_messages);
+	no_os_free(linux_desc->messages);
+	linux_desc->messages = msgs;
 
 	linux_desc->messages[linux_desc->len_messages] = msg;
 	linux_desc->len_messages++;
@@ -151,7 +152,7 @@ int linux_i2c_init(struct no_os_i2c_desc **desc,
 	if (!descriptor)
 		return -1;
 
-	linux_desc = (struct linux_i2c_desc*) no_os_malloc(sizeof(
+	linux_desc = (struct linux_i2c_desc*) no_os_calloc(1, sizeof(
 				struct linux_i2c_desc));
 	if (!linux_desc)
 		goto free_desc;
@@ -273,6 +274,62 @@ int linux_i2c_read(struct no_os_i2c_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Send messages as one combined transaction with a single I2C_RDWR
+ * ioctl.
+ * @param desc - The I2C descriptor.
+ * @param msgs - Array of messages.
+ * @param nb_msgs - Number of messages in the array.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int linux_i2c_transfer(struct no_os_i2c_desc *desc,
+		       struct no_os_i2c_msg *msgs,
+		       uint32_t nb_msgs)
+{
+	struct linux_i2c_desc *linux_desc;
+	struct i2c_rdwr_ioctl_data packets;
+	struct i2c_msg *i2c_msgs;
+	uint32_t i;
+	int ret;
+
+	if (nb_msgs > I2C_RDWR_IOCTL_MAX_MSGS)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	i2c_msgs = no_os_calloc(nb_msgs, sizeof(*i2c_msgs));
+	if (!i2c_msgs)
+		return -ENOMEM;
+
+	for (i = 0; i < nb_msgs; i++) {
+		/* i2c_msg.len is 16 bits wide */
+		if (msgs[i].len > UINT16_MAX) {
+			ret = -EINVAL;
+			goto out;
+		}
+		i2c_msgs[i].addr = desc->slave_address;
+		i2c_msgs[i].flags = (msgs[i].flags & NO_OS_I2C_M_RD) ? I2C_M_RD : 0;
+		i2c_msgs[i].len = msgs[i].len;
+		i2c_msgs[i].buf = msgs[i].buf;
+	}
+
+	packets.msgs = i2c_msgs;
+	packets.nmsgs = nb_msgs;
+
+	ret = ioctl(linux_desc->fd, I2C_RDWR, &packets);
+	if (ret < 0) {
+		printf("%s: Can't send i2c messages (%d)\n\r", __func__, errno);
+		ret = -errno;
+	} else {
+		ret = 0;
+	}
+
+out:
+	no_os_free(i2c_msgs);
+
+	return ret;
+}
+
 /**
  * @brief Linux platform specific I2C platform ops structure
  */
@@ -280,5 +337,6 @@ const struct no_os_i2c_platform_ops linux_i2c_ops = {
 	.i2c_ops_init = &linux_i2c_init,
 	.i2c_ops_write = &linux_i2c_write,
 	.i2c_ops_read = &linux_i2c_read,
-	.i2c_ops_remove = &linux_i2c_remove
+	.i2c_ops_remove = &linux_i2c_remove,
+	.i2c_ops_transfer = &linux_i2c_transfer
 };
@@ -0,0 +1,767 @@
+/***************************************************************************//**
+ *   @file   linux/linux_irq.c
+ *   @brief  Implementation of interrupt controllers using UIO and GPIO line
+ *           events, dispatched from a thread.
+********************************************************************************
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include "no_os_error.h"
+#include "no_os_alloc.h"
+#include "no_os_irq.h"
+#include "linux_irq.h"
+
+/**
+ * @struct linux_irq_action
+ * @brief Interrupt registered on a controller.
+ */
+struct linux_irq_action {
+	/** UIO index or GPIO line offset */
+	uint32_t irq_id;
+	/** File descriptor signalling the interrupt, -1 if not open */
+	int fd;
+	/** Interrupt enabled with no_os_irq_enable() */
+	bool enabled;
+	/** Trigger of GPIO interrupts */
+	enum no_os_irq_trig_level level;
+	/** Callback to be called when the interrupt occurs */
+	void (*callback)(void *context);
+	/** Parameter passed to the callback */
+	void *ctx;
+};
+
+/**
+ * @struct linux_irq_desc
+ * @brief Linux platform specific interrupt controller descriptor.
+ */
+struct linux_irq_desc {
+	/** GPIO lines of /dev/gpiochipX instead of UIO devices */
+	bool gpio;
+	/** GPIO chip file descriptor */
+	int chip_fd;
+	/** Interrupts are dispatched only while globally enabled */
+	bool global_enabled;
+	/** Cleared to stop the dispatcher thread */
+	bool running;
+	/** Pipe used to wake up the dispatcher when the polled fds change */
+	int wake_fd[2];
+	/** Dispatcher thread */
+	pthread_t thread;
+	/** Protects the fields above and the actions */
+	pthread_mutex_t lock;
+	/** Number of registered interrupts */
+	uint32_t nb_actions;
+	/** Registered interrupts */
+	struct linux_irq_action *actions[LINUX_IRQ_MAX_NB];
+};
+
+/**
+ * @brief Wake up the dispatcher so it polls the updated set of interrupts.
+ * @param ldesc - Linux interrupt controller descriptor.
+ */
+static void linux_irq_wake(struct linux_irq_desc *ldesc)
+{
+	uint8_t c = 0;
+
+	if (write(ldesc->wake_fd[1], &c, 1) < 0)
+		printf("%s: Can't wake the dispatcher\n\r", __func__);
+}
+
+/**
+ * @brief Find a registered interrupt. Must be called with the lock held.
+ * @param ldesc - Linux interrupt controller descriptor.
+ * @param irq_id - UIO index or GPIO line offset.
+ * @return The interrupt, NULL if not registered.
+ */
+static struct linux_irq_action *linux_irq_find(struct linux_irq_desc *ldesc,
+		uint32_t irq_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < ldesc->nb_actions; i++)
+		if (ldesc->actions[i]->irq_id == irq_id)
+			return ldesc->actions[i];
+
+	return NULL;
+}
+
+/**
+ * @brief Check if an interrupt is still registered. Must be called with the
+ * lock held.
+ * @param ldesc - Linux interrupt controller descriptor.
+ * @param action - The interrupt.
+ * @return true if the interrupt is registered, false otherwise.
+ */
+static bool linux_irq_registered(struct linux_irq_desc *ldesc,
+				 struct linux_irq_action *action)
+{
+	uint32_t i;
+
+	for (i = 0; i < ldesc->nb_actions; i++)
+		if (ldesc->actions[i] == action)
+			return true;
+
+	return false;
+}
+
+/**
+ * @brief Enable or disable the interrupt of a UIO device.
+ * @param action - The interrupt.
+ * @param enable - true to enable the interrupt, false to disable it.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_uio_control(struct linux_irq_action *action, bool enable)
+{
+	int32_t val = enable;
+
+	if (write(action->fd, &val, sizeof(val)) != sizeof(val))
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * @brief Request a GPIO line with edge detection.
+ * @param ldesc - Linux interrupt controller descriptor.
+ * @param action - The interrupt.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_gpio_request(struct linux_irq_desc *ldesc,
+				  struct linux_irq_action *action)
+{
+	struct gpio_v2_line_request req = {0};
+	int ret;
+
+	req.offsets[0] = action->irq_id;
+	req.num_lines = 1;
+	req.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+	if (action->level != NO_OS_IRQ_EDGE_FALLING)
+		req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+	if (action->level != NO_OS_IRQ_EDGE_RISING)
+		req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+	strcpy(req.consumer, "no-OS irq");
+
+	ret = ioctl(ldesc->chip_fd, GPIO_V2_GET_LINE_IOCTL, &req);
+	if (ret < 0) {
+		printf("%s: Can't request line %"PRIu32"\n\r", __func__,
+		       action->irq_id);
+		return -errno;
+	}
+
+	fcntl(req.fd, F_SETFL, O_NONBLOCK);
+	action->fd = req.fd;
+
+	return 0;
+}
+
+/**
+ * @brief Read the event of an interrupt and call its callback.
+ * @param ldesc - Linux interrupt controller descriptor.
+ * @param action - The interrupt that was polled.
+ */
+static void linux_irq_handle(struct linux_irq_desc *ldesc,
+			     struct linux_irq_action *action)
+{
+	struct gpio_v2_line_event event;
+	void (*callback)(void *context);
+	uint32_t count;
+	void *ctx;
+	int ret;
+
+	pthread_mutex_lock(&ldesc->lock);
+	/* Unregistered or disabled since it was polled */
+	if (!linux_irq_registered(ldesc, action) || !action->enabled ||
+	    action->fd < 0) {
+		pthread_mutex_unlock(&ldesc->lock);
+		return;
+	}
+
+	/*
+	 * The fd is non-blocking, so if the line was requested again since it
+	 * was polled, there is no event to read yet.
+	 */
+	if (ldesc->gpio)
+		ret = read(action->fd, &event, sizeof(event));
+	else
+		ret = read(action->fd, &count, sizeof(count));
+	callback = action->callback;
+	ctx = action->ctx;
+	pthread_mutex_unlock(&ldesc->lock);
+
+	if (ret <= 0)
+		return;
+
+	if (callback)
+		callback(ctx);
+
+	if (ldesc->gpio)
+		return;
+
+	/* UIO interrupts are disabled by the kernel until re-enabled */
+	pthread_mutex_lock(&ldesc->lock);
+	if (linux_irq_registered(ldesc, action) && action->enabled)
+		linux_irq_uio_control(action, true);
+	pthread_mutex_unlock(&ldesc->lock);
+}
+
+/**
+ * @brief Dispatcher thread, calls the callbacks of the interrupts that
+ * occurred.
+ * @param arg - Linux interrupt controller descriptor.
+ * @return NULL
+ */
+static void *linux_irq_dispatcher(void *arg)
+{
+	struct linux_irq_desc *ldesc = arg;
+	struct pollfd fds[LINUX_IRQ_MAX_NB + 1];
+	struct linux_irq_action *polled[LINUX_IRQ_MAX_NB];
+	uint8_t buf[16];
+	uint32_t nfds;
+	uint32_t i;
+	int ret;
+
+	while (true) {
+		pthread_mutex_lock(&ldesc->lock);
+		if (!ldesc->running) {
+			pthread_mutex_unlock(&ldesc->lock);
+			break;
+		}
+
+		fds[0].fd = ldesc->wake_fd[0];
+		fds[0].events = POLLIN;
+		nfds = 1;
+		for (i = 0; i < ldesc->nb_actions && ldesc->global_enabled; i++) {
+			if (!ldesc->actions[i]->enabled || ldesc->actions[i]->fd < 0)
+				continue;
+			fds[nfds].fd = ldesc->actions[i]->fd;
+			fds[nfds].events = POLLIN;
+			polled[nfds - 1] = ldesc->actions[i];
+			nfds++;
+		}
+		pthread_mutex_unlock(&ldesc->lock);
+
+		ret = poll(fds, nfds, -1);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			printf("%s: poll() failed\n\r", __func__);
+			break;
+		}
+
+		if (fds[0].revents & POLLIN)
+			while (read(ldesc->wake_fd[0], buf, sizeof(buf)) > 0)
+				;
+
+		for (i = 1; i < nfds; i++)
+			if (fds[i].revents & POLLIN)
+				linux_irq_handle(ldesc, polled[i - 1]);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Initialize an interrupt controller and start its dispatcher.
+ * @param desc - The interrupt controller descriptor.
+ * @param param - The structure that contains the controller parameters.
+ * @param gpio - true for a GPIO chip, false for UIO devices.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_init(struct no_os_irq_ctrl_desc **desc,
+			  const struct no_os_irq_init_param *param, bool gpio)
+{
+	struct no_os_irq_ctrl_desc *descriptor;
+	struct linux_irq_desc *ldesc;
+	char path[64];
+	int ret;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	descriptor = no_os_calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	ldesc = no_os_calloc(1, sizeof(*ldesc));
+	if (!ldesc) {
+		ret = -ENOMEM;
+		goto free_desc;
+	}
+
+	ldesc->gpio = gpio;
+	ldesc->chip_fd = -1;
+	ldesc->global_enabled = true;
+	ldesc->running = true;
+
+	if (gpio) {
+		sprintf(path, "/dev/gpiochip%"PRIu32"", param->irq_ctrl_id);
+		ldesc->chip_fd = open(path, O_RDONLY);
+		if (ldesc->chip_fd < 0) {
+			printf("%s: Can't open %s\n\r", __func__, path);
+			ret = -errno;
+			goto free_ldesc;
+		}
+	}
+
+	if (pipe(ldesc->wake_fd)) {
+		ret = -errno;
+		goto close_chip;
+	}
+	fcntl(ldesc->wake_fd[0], F_SETFL, O_NONBLOCK);
+	fcntl(ldesc->wake_fd[1], F_SETFL, O_NONBLOCK);
+
+	ret = pthread_mutex_init(&ldesc->lock, NULL);
+	if (ret) {
+		ret = -ret;
+		goto close_pipe;
+	}
+
+	ret = pthread_create(&ldesc->thread, NULL, linux_irq_dispatcher, ldesc);
+	if (ret) {
+		ret = -ret;
+		goto destroy_lock;
+	}
+
+	descriptor->irq_ctrl_id = param->irq_ctrl_id;
+	descriptor->platform_ops = param->platform_ops;
+	descriptor->extra = ldesc;
+	*desc = descriptor;
+
+	return 0;
+
+destroy_lock:
+	pthread_mutex_destroy(&ldesc->lock);
+close_pipe:
+	close(ldesc->wake_fd[0]);
+	close(ldesc->wake_fd[1]);
+close_chip:
+	if (ldesc->chip_fd >= 0)
+		close(ldesc->chip_fd);
+free_ldesc:
+	no_os_free(ldesc);
+free_desc:
+	no_os_free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Initialize a UIO interrupt controller.
+ * @param desc - The interrupt controller descriptor.
+ * @param param - The structure that contains the controller parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_ctrl_init(struct no_os_irq_ctrl_desc **desc,
+			       const struct no_os_irq_init_param *param)
+{
+	return linux_irq_init(desc, param, false);
+}
+
+/**
+ * @brief Initialize a GPIO interrupt controller.
+ * @param desc - The interrupt controller descriptor.
+ * @param param - The structure that contains the controller parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_gpio_irq_ctrl_init(struct no_os_irq_ctrl_desc **desc,
+				    const struct no_os_irq_init_param *param)
+{
+	return linux_irq_init(desc, param, true);
+}
+
+/**
+ * @brief Stop the dispatcher and free the resources allocated by
+ * linux_irq_init().
+ * @param desc - The interrupt controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_ctrl_remove(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_irq_desc *ldesc;
+	uint32_t i;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	ldesc->running = false;
+	pthread_mutex_unlock(&ldesc->lock);
+	linux_irq_wake(ldesc);
+	pthread_join(ldesc->thread, NULL);
+
+	for (i = 0; i < ldesc->nb_actions; i++) {
+		if (ldesc->actions[i]->fd >= 0) {
+			if (!ldesc->gpio)
+				linux_irq_uio_control(ldesc->actions[i], false);
+			close(ldesc->actions[i]->fd);
+		}
+		no_os_free(ldesc->actions[i]);
+	}
+
+	pthread_mutex_destroy(&ldesc->lock);
+	close(ldesc->wake_fd[0]);
+	close(ldesc->wake_fd[1]);
+	if (ldesc->chip_fd >= 0)
+		close(ldesc->chip_fd);
+	no_os_free(ldesc);
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Register a callback for an interrupt. The interrupt must then be
+ * enabled with no_os_irq_enable().
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - UIO index or GPIO line offset.
+ * @param cb - Descriptor of the callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
+				       uint32_t irq_id,
+				       struct no_os_callback_desc *cb)
+{
+	struct linux_irq_action *action;
+	struct linux_irq_desc *ldesc;
+	char path[32];
+	int ret = 0;
+
+	if (!desc || !desc->extra || !cb)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	action = linux_irq_find(ldesc, irq_id);
+	if (!action) {
+		if (ldesc->nb_actions == LINUX_IRQ_MAX_NB) {
+			ret = -ENOMEM;
+			goto unlock;
+		}
+
+		action = no_os_calloc(1, sizeof(*action));
+		if (!action) {
+			ret = -ENOMEM;
+			goto unlock;
+		}
+
+		action->irq_id = irq_id;
+		action->fd = -1;
+		action->enabled = false;
+		action->level = NO_OS_IRQ_EDGE_RISING;
+
+		if (!ldesc->gpio) {
+			sprintf(path, "/dev/uio%"PRIu32"", irq_id);
+			action->fd = open(path, O_RDWR | O_NONBLOCK);
+			if (action->fd < 0) {
+				printf("%s: Can't open %s\n\r", __func__, path);
+				ret = -errno;
+				no_os_free(action);
+				goto unlock;
+			}
+		}
+
+		ldesc->actions[ldesc->nb_actions++] = action;
+	}
+
+	action->callback = cb->callback;
+	action->ctx = cb->ctx;
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+
+	return ret;
+}
+
+/**
+ * @brief Unregister the callback of an interrupt and disable it.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - UIO index or GPIO line offset.
+ * @param cb - Descriptor of the callback, must match the registered one.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_unregister_callback(struct no_os_irq_ctrl_desc *desc,
+		uint32_t irq_id,
+		struct no_os_callback_desc *cb)
+{
+	struct linux_irq_action *action;
+	struct linux_irq_desc *ldesc;
+	uint32_t i;
+
+	if (!desc || !desc->extra || !cb)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	action = linux_irq_find(ldesc, irq_id);
+	if (!action) {
+		pthread_mutex_unlock(&ldesc->lock);
+		return -ENODEV;
+	}
+
+	if (action->callback != cb->callback || action->ctx != cb->ctx) {
+		pthread_mutex_unlock(&ldesc->lock);
+		return -EINVAL;
+	}
+
+	if (action->fd >= 0) {
+		if (!ldesc->gpio)
+			linux_irq_uio_control(action, false);
+		close(action->fd);
+	}
+
+	for (i = 0; ldesc->actions[i] != action; i++)
+		;
+	ldesc->actions[i] = ldesc->actions[--ldesc->nb_actions];
+	no_os_free(action);
+	pthread_mutex_unlock(&ldesc->lock);
+
+	linux_irq_wake(ldesc);
+
+	return 0;
+}
+
+/**
+ * @brief Resume dispatching the enabled interrupts.
+ * @param desc - The interrupt controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_global_enable(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_irq_desc *ldesc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	ldesc->global_enabled = true;
+	pthread_mutex_unlock(&ldesc->lock);
+	linux_irq_wake(ldesc);
+
+	return 0;
+}
+
+/**
+ * @brief Stop dispatching interrupts. Interrupts that occur in the meantime
+ * stay pending.
+ * @param desc - The interrupt controller descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_global_disable(struct no_os_irq_ctrl_desc *desc)
+{
+	struct linux_irq_desc *ldesc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	ldesc->global_enabled = false;
+	pthread_mutex_unlock(&ldesc->lock);
+	linux_irq_wake(ldesc);
+
+	return 0;
+}
+
+/**
+ * @brief Set the trigger of a GPIO interrupt. Level triggers are not
+ * supported by GPIO line events, the trigger of UIO interrupts is set in the
+ * device tree.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - GPIO line offset.
+ * @param trig - The trigger condition.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_trigger_level_set(struct no_os_irq_ctrl_desc *desc,
+				       uint32_t irq_id,
+				       enum no_os_irq_trig_level trig)
+{
+	struct linux_irq_action *action;
+	struct linux_irq_desc *ldesc;
+	int ret = 0;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+	if (!ldesc->gpio)
+		return -ENOSYS;
+
+	if (trig != NO_OS_IRQ_EDGE_FALLING && trig != NO_OS_IRQ_EDGE_RISING &&
+	    trig != NO_OS_IRQ_EDGE_BOTH)
+		return -EINVAL;
+
+	pthread_mutex_lock(&ldesc->lock);
+	action = linux_irq_find(ldesc, irq_id);
+	if (!action) {
+		ret = -ENODEV;
+		goto unlock;
+	}
+
+	action->level = trig;
+	/* The edges are set when the line is requested */
+	if (action->fd >= 0) {
+		close(action->fd);
+		action->fd = -1;
+		ret = linux_irq_gpio_request(ldesc, action);
+		if (ret)
+			action->enabled = false;
+	}
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+	linux_irq_wake(ldesc);
+
+	return ret;
+}
+
+/**
+ * @brief Enable an interrupt.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - UIO index or GPIO line offset.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_enable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_action *action;
+	struct linux_irq_desc *ldesc;
+	int ret;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	action = linux_irq_find(ldesc, irq_id);
+	if (!action) {
+		ret = -ENODEV;
+		goto unlock;
+	}
+
+	if (ldesc->gpio)
+		ret = action->fd < 0 ? linux_irq_gpio_request(ldesc, action) : 0;
+	else
+		ret = linux_irq_uio_control(action, true);
+	if (!ret)
+		action->enabled = true;
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+	linux_irq_wake(ldesc);
+
+	return ret;
+}
+
+/**
+ * @brief Disable an interrupt.
+ * @param desc - The interrupt controller descriptor.
+ * @param irq_id - UIO index or GPIO line offset.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int linux_irq_disable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	struct linux_irq_action *action;
+	struct linux_irq_desc *ldesc;
+	int ret = 0;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	ldesc = desc->extra;
+
+	pthread_mutex_lock(&ldesc->lock);
+	action = linux_irq_find(ldesc, irq_id);
+	if (!action) {
+		ret = -ENODEV;
+		goto unlock;
+	}
+
+	action->enabled = false;
+	if (ldesc->gpio) {
+		/* Edges are not recorded while the line is released */
+		if (action->fd >= 0)
+			close(action->fd);
+		action->fd = -1;
+	} else {
+		ret = linux_irq_uio_control(action, false);
+	}
+
+unlock:
+	pthread_mutex_unlock(&ldesc->lock);
+	linux_irq_wake(ldesc);
+
+	return ret;
+}
+
+/**
+ * @brief Linux UIO interrupt controller platform ops.
+ */
+const struct no_os_irq_platform_ops linux_irq_ops = {
+	.init = &linux_irq_ctrl_init,
+	.register_callback = &linux_irq_register_callback,
+	.unregister_callback = &linux_irq_unregister_callback,
+	.global_enable = &linux_irq_global_enable,
+	.global_disable = &linux_irq_global_disable,
+	.trigger_level_set = &linux_irq_trigger_level_set,
+	.enable = &linux_irq_enable,
+	.disable = &linux_irq_disable,
+	.remove = &linux_irq_ctrl_remove
+};
+
+/**
+ * @brief Linux GPIO interrupt controller platform ops.
+ */
+const struct no_os_irq_platform_ops linux_gpio_irq_ops = {
+	.init = &linux_gpio_irq_ctrl_init,
+	.register_callback = &linux_irq_register_callback,
+	.unregister_callback = &linux_irq_unregister_callback,
+	.global_enable = &linux_irq_global_enable,
+	.global_disable = &linux_irq_global_disable,
+	.trigger_level_set = &linux_irq_trigger_level_set,
+	.enable = &linux_irq_enable,
+	.disable = &linux_irq_disable,
+	.remove = &linux_irq_ctrl_remove
+};
@@ -0,0 +1,57 @@
+/***************************************************************************//**
+ *   @file   linux/linux_irq.h
+ *   @brief  Header file of the Linux UIO and GPIO interrupt controllers.
+********************************************************************************
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef LINUX_IRQ_H_
+#define LINUX_IRQ_H_
+
+#include "no_os_irq.h"
+
+/* Maximum number of interrupts registered on a controller */
+#define LINUX_IRQ_MAX_NB	32
+
+/**
+ * @brief Linux UIO interrupt controller platform ops.
+ * irq_id is the UIO index (/dev/uioX) of the device raising the interrupt.
+ * The UIO driver must support re-enabling the interrupt by writing 1 to the
+ * device, as uio_pdrv_genirq does.
+ */
+extern const struct no_os_irq_platform_ops linux_irq_ops;
+
+/**
+ * @brief Linux GPIO interrupt controller platform ops.
+ * irq_ctrl_id is the GPIO chip index (/dev/gpiochipX) and irq_id the line
+ * offset. The line is requested as input by the controller, so it can't be
+ * requested with no_os_gpio_get() at the same time.
+ */
+extern const struct no_os_irq_platform_ops linux_gpio_irq_ops;
+
+#endif // LINUX_IRQ_H_
@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ *   @file   linux/linux_mutex.c
+ *   @brief  Implementation of no-OS mutex functionality using pthreads.
+********************************************************************************
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <pthread.h>
+#include "no_os_mutex.h"
+#include "no_os_alloc.h"
+
+/**
+ * @brief Initialize mutex.
+ * @param mutex - Pointer toward the mutex. Left unchanged if already set.
+ */
+void no_os_mutex_init(void **mutex)
+{
+	pthread_mutex_t *m;
+
+	if (!mutex || *mutex)
+		return;
+
+	m = no_os_malloc(sizeof(*m));
+	if (!m)
+		return;
+
+	if (pthread_mutex_init(m, NULL)) {
+		no_os_free(m);
+		return;
+	}
+
+	*mutex = m;
+}
+
+/**
+ * @brief Lock mutex.
+ * @param mutex - The mutex.
+ */
+void no_os_mutex_lock(void *mutex)
+{
+	if (mutex)
+		pthread_mutex_lock(mutex);
+}
+
+/**
+ * @brief Unlock mutex.
+ * @param mutex - The mutex.
+ */
+void no_os_mutex_unlock(void *mutex)
+{
+	if (mutex)
+		pthread_mutex_unlock(mutex);
+}
+
+/**
+ * @brief Remove mutex.
+ * @param mutex - The mutex.
+ */
+void no_os_mutex_remove(void *mutex)
+{
+	if (!mutex)
+		return;
+
+	pthread_mutex_destroy(mutex);
+	no_os_free(mutex);
+}
@@ -37,6 +37,8 @@
 #include "linux_spi.h"
 
 #include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/ioctl.h>
@@ -52,8 +54,23 @@
 struct linux_spi_desc {
 	/** /dev/spidev"device_id"."chip_select" file descriptor */
 	int spidev_fd;
+	/** Thread running the asynchronous transfers, started on first use */
+	pthread_t worker;
+	bool worker_started;
+	bool worker_stop;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	/** Pending asynchronous transfer */
+	struct no_os_spi_msg *msgs;
+	uint32_t len;
+	void (*callback)(void *);
+	void *ctx;
 };
 
+static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
+				  struct no_os_spi_msg *msgs,
+				  uint32_t len);
+
 /**
  * @brief Initialize the SPI communication peripheral.
  * @param desc - The SPI descriptor.
@@ -73,7 +90,7 @@ int32_t linux_spi_init(struct no_os_spi_desc **desc,
 	if (!descriptor)
 		return -1;
 
-	linux_desc = (struct linux_spi_desc*) no_os_malloc(sizeof(
+	linux_desc = (struct linux_spi_desc*) no_os_calloc(1, sizeof(
 				struct linux_spi_desc));
 	if (!linux_desc)
 		goto free_desc;
@@ -151,6 +168,97 @@ int32_t linux_spi_write_and_read(struct no_os_spi_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Thread doing the asynchronous transfers of a SPI device.
+ * @param arg - The SPI descriptor.
+ * @return NULL
+ */
+static void *linux_spi_worker(void *arg)
+{
+	struct no_os_spi_desc *desc = arg;
+	struct linux_spi_desc *linux_desc = desc->extra;
+	struct no_os_spi_msg *msgs;
+	void (*callback)(void *);
+	void *ctx;
+	uint32_t len;
+
+	while (true) {
+		pthread_mutex_lock(&linux_desc->lock);
+		while (!linux_desc->msgs && !linux_desc->worker_stop)
+			pthread_cond_wait(&linux_desc->cond, &linux_desc->lock);
+		if (!linux_desc->msgs) {
+			pthread_mutex_unlock(&linux_desc->lock);
+			return NULL;
+		}
+		msgs = linux_desc->msgs;
+		len = linux_desc->len;
+		callback = linux_desc->callback;
+		ctx = linux_desc->ctx;
+		pthread_mutex_unlock(&linux_desc->lock);
+
+		desc->dma_async_ret = linux_spi_transfer(desc, msgs, len);
+
+		/* The callback may start the next transfer */
+		pthread_mutex_lock(&linux_desc->lock);
+		linux_desc->msgs = NULL;
+		pthread_mutex_unlock(&linux_desc->lock);
+
+		if (callback)
+			callback(ctx);
+	}
+}
+
+/**
+ * @brief Transfer a list of messages on the worker thread of the device.
+ * The result of the transfer is stored in dma_async_ret of the descriptor
+ * before the callback is called.
+ * @param desc - The SPI descriptor.
+ * @param msgs - Array of messages.
+ * @param len - Number of messages in the array.
+ * @param callback - Called by the worker thread after the transfer.
+ * @param ctx - Parameter of the callback.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_spi_transfer_dma_async(struct no_os_spi_desc *desc,
+		struct no_os_spi_msg *msgs,
+		uint32_t len,
+		void (*callback)(void *),
+		void *ctx)
+{
+	struct linux_spi_desc *linux_desc;
+	int32_t ret = 0;
+
+	linux_desc = desc->extra;
+
+	if (!linux_desc->worker_started) {
+		pthread_mutex_init(&linux_desc->lock, NULL);
+		pthread_cond_init(&linux_desc->cond, NULL);
+		linux_desc->worker_stop = false;
+		ret = pthread_create(&linux_desc->worker, NULL,
+				     linux_spi_worker, desc);
+		if (ret) {
+			pthread_cond_destroy(&linux_desc->cond);
+			pthread_mutex_destroy(&linux_desc->lock);
+			return -ret;
+		}
+		linux_desc->worker_started = true;
+	}
+
+	pthread_mutex_lock(&linux_desc->lock);
+	if (linux_desc->msgs) {
+		ret = -EBUSY;
+	} else {
+		linux_desc->msgs = msgs;
+		linux_desc->len = len;
+		linux_desc->callback = callback;
+		linux_desc->ctx = ctx;
+		pthread_cond_signal(&linux_desc->cond);
+	}
+	pthread_mutex_unlock(&linux_desc->lock);
+
+	return ret;
+}
+
 /**
  * @brief Free the resources allocated by linux_spi_init().
  * @param desc - The SPI descriptor.
@@ -163,6 +271,16 @@ int32_t linux_spi_remove(struct no_os_spi_desc *desc)
 
 	linux_desc = desc->extra;
 
+	if (linux_desc->worker_started) {
+		pthread_mutex_lock(&linux_desc->lock);
+		linux_desc->worker_stop = true;
+		pthread_cond_signal(&linux_desc->cond);
+		pthread_mutex_unlock(&linux_desc->lock);
+		pthread_join(linux_desc->worker, NULL);
+		pthread_cond_destroy(&linux_desc->cond);
+		pthread_mutex_destroy(&linux_desc->lock);
+	}
+
 	ret = close(linux_desc->spidev_fd);
 	if (ret < 0) {
 		printf("%s: Can't close device\n\r", __func__);
@@ -195,7 +313,14 @@ static int32_t linux_spi_transfer(struct no_os_spi_desc *desc,
 		tr[i].tx_buf = (unsigned long) msgs[i].tx_buff;
 		tr[i].rx_buf = (unsigned long) msgs[i].rx_buff;
 		tr[i].len = msgs[i].bytes_number;
-		tr[i].cs_change = msgs[i].cs_change;
+		/*
+		 * spidev toggles CS between transfers when cs_change is set,
+		 * but keeps it asserted after the last one when it is set.
+		 */
+		if (i == len - 1)
+			tr[i].cs_change = !msgs[i].cs_change;
+		else
+			tr[i].cs_change = msgs[i].cs_change;
 		tr[i].word_delay_usecs = msgs[i].cs_change_delay;
 	}
 
@@ -217,5 +342,6 @@ const struct no_os_spi_platform_ops linux_spi_ops = {
 	.init = &linux_spi_init,
 	.write_and_read = &linux_spi_write_and_read,
 	.remove = &linux_spi_remove,
-	.transfer = &linux_spi_transfer
+	.transfer = &linux_spi_transfer,
+	.transfer_dma_async = &linux_spi_transfer_dma_async
 };
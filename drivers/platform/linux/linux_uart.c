@@ -36,11 +36,13 @@
 #include "linux_uart.h"
 
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <termios.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/serial.h>
 
 /**
  * @struct linux_uart_desc
@@ -53,6 +55,49 @@ struct linux_uart_desc {
 	struct termios *terminal;
 };
 
+/**
+ * @brief Ask the serial driver to push received bytes without delay. USB
+ * serial adapters (FTDI) otherwise buffer them for up to 16 ms. Not all
+ * drivers support it, so errors are ignored.
+ * @param fd - The UART file descriptor.
+ */
+static void linux_uart_low_latency(int fd)
+{
+	struct serial_struct serial;
+
+	if (ioctl(fd, TIOCGSERIAL, &serial) < 0)
+		return;
+
+	serial.flags |= ASYNC_LOW_LATENCY;
+	ioctl(fd, TIOCSSERIAL, &serial);
+}
+
+/**
+ * @brief Wait until the UART can be read or written.
+ * @param fd - The UART file descriptor.
+ * @param events - POLLIN or POLLOUT.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t linux_uart_wait(int fd, short events)
+{
+	struct pollfd pfd = {
+		.fd = fd,
+		.events = events
+	};
+	int ret;
+
+	do {
+		ret = poll(&pfd, 1, -1);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret < 0)
+		return -errno;
+	if (pfd.revents & (POLLERR | POLLNVAL))
+		return -EIO;
+
+	return 0;
+}
+
 /**
  * @brief Initialize the UART communication peripheral.
  * @param desc - The UART descriptor.
@@ -152,6 +197,33 @@ static int32_t linux_uart_init(struct no_os_uart_desc **desc,
 	case 38400:
 		speed = B38400;
 		break;
+	case 57600:
+		speed = B57600;
+		break;
+	case 115200:
+		speed = B115200;
+		break;
+	case 230400:
+		speed = B230400;
+		break;
+	case 460800:
+		speed = B460800;
+		break;
+	case 921600:
+		speed = B921600;
+		break;
+	case 1000000:
+		speed = B1000000;
+		break;
+	case 2000000:
+		speed = B2000000;
+		break;
+	case 3000000:
+		speed = B3000000;
+		break;
+	case 4000000:
+		speed = B4000000;
+		break;
 	default:
 		ret = -EINVAL;
 		goto free;
@@ -199,10 +271,19 @@ static int32_t linux_uart_init(struct no_os_uart_desc **desc,
 	else
 		linux_desc->terminal->c_cflag |= CSTOPB;
 
-	linux_desc->terminal->c_cflag |= CREAD;
+	linux_desc->terminal->c_cflag |= CREAD | CLOCAL;
+
+	/*
+	 * The fd is non-blocking and waited with poll(), so read() returns
+	 * whatever was received instead of waiting for a minimum count.
+	 */
+	linux_desc->terminal->c_cc[VMIN] = 0;
+	linux_desc->terminal->c_cc[VTIME] = 0;
 
 	tcsetattr(linux_desc->fd, TCSANOW, linux_desc->terminal);
 
+	linux_uart_low_latency(linux_desc->fd);
+
 	tcflush(linux_desc->fd, TCIOFLUSH);
 
 	*desc = descriptor;
@@ -237,6 +318,7 @@ static int32_t linux_uart_remove(struct no_os_uart_desc *desc)
 	if (ret < 0)
 		printf("%s: Can't close device\n\r", __func__);
 
+	no_os_free(linux_desc->terminal);
 	no_os_free(desc->extra);
 	no_os_free(desc);
 
@@ -244,11 +326,59 @@ static int32_t linux_uart_remove(struct no_os_uart_desc *desc)
 };
 
 /**
- * @brief Write data to UART device.
+ * @brief Write data to UART device without blocking.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
- * @param bytes_number - Number of bytes to read.
- * @return 0 in case of success, -1 otherwise.
+ * @param bytes_number - Number of bytes to write.
+ * @return Number of bytes written, that can be 0, or negative error code.
+ */
+static int32_t linux_uart_write_nonblocking(struct no_os_uart_desc *desc,
+		const uint8_t *data,
+		uint32_t bytes_number)
+{
+	struct linux_uart_desc *linux_desc;
+	ssize_t ret;
+
+	linux_desc = desc->extra;
+
+	ret = write(linux_desc->fd, data, bytes_number);
+	if (ret < 0)
+		return (errno == EAGAIN || errno == EINTR) ? 0 : -errno;
+
+	return ret;
+}
+
+/**
+ * @brief Read data from UART device without blocking.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Maximum number of bytes to read.
+ * @return Number of bytes read, that can be 0, or negative error code.
+ */
+static int32_t linux_uart_read_nonblocking(struct no_os_uart_desc *desc,
+		uint8_t *data,
+		uint32_t bytes_number)
+{
+	struct linux_uart_desc *linux_desc;
+	ssize_t ret;
+
+	linux_desc = desc->extra;
+
+	ret = read(linux_desc->fd, data, bytes_number);
+	if (ret < 0)
+		return (errno == EAGAIN || errno == EINTR) ? 0 : -errno;
+
+	return ret;
+}
+
+/**
+ * @brief Write data to UART device. Sleeps in poll() while the output
+ * buffer is full.
+ * @param desc - Instance of UART.
+ * @param data - Pointer to buffer containing data.
+ * @param bytes_number - Number of bytes to write.
+ * @return Number of bytes written in case of success, negative error code
+ * otherwise.
  */
 static int32_t linux_uart_write(struct no_os_uart_desc *desc,
 				const uint8_t *data,
@@ -261,39 +391,75 @@ static int32_t linux_uart_write(struct no_os_uart_desc *desc,
 	linux_desc = desc->extra;
 
 	while (count < bytes_number) {
-		ret = write(linux_desc->fd, data, bytes_number);
-		if (ret > 0)
-			count += ret;
+		ret = linux_uart_write_nonblocking(desc, &data[count],
+						   bytes_number - count);
+		if (ret < 0)
+			return ret;
+		count += ret;
+		if (count == bytes_number)
+			break;
+
+		ret = linux_uart_wait(linux_desc->fd, POLLOUT);
+		if (ret)
+			return ret;
 	}
 
-	return 0;
+	return count;
 };
 
 /**
- * @brief Read data from UART device.
+ * @brief Read data from UART device. Sleeps in poll() until all the bytes
+ * are received.
  * @param desc - Instance of UART.
  * @param data - Pointer to buffer containing data.
  * @param bytes_number - Number of bytes to read.
- * @return 0 in case of success, -1 otherwise.
+ * @return Number of bytes read in case of success, negative error code
+ * otherwise.
  */
 static int32_t linux_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 			       uint32_t bytes_number)
 {
 	struct linux_uart_desc *linux_desc;
 	uint32_t count = 0;
-	int ret;
+	int32_t ret;
 
 	linux_desc = desc->extra;
 
 	while (count < bytes_number) {
-		ret = read(linux_desc->fd, &data[count], bytes_number - count);
-		if (ret > 0)
-			count += ret;
+		ret = linux_uart_read_nonblocking(desc, &data[count],
+						  bytes_number - count);
+		if (ret < 0)
+			return ret;
+		count += ret;
+		if (count == bytes_number)
+			break;
+
+		ret = linux_uart_wait(linux_desc->fd, POLLIN);
+		if (ret)
+			return ret;
 	}
 
-	return 0;
+	return count;
 };
 
+/**
+ * @brief Get the file descriptor of the UART, to wait for received data with
+ * poll() or epoll alongside other files.
+ * @param desc - Instance of UART.
+ * @return The file descriptor, negative error code if desc is invalid.
+ */
+int linux_uart_get_fd(struct no_os_uart_desc *desc)
+{
+	struct linux_uart_desc *linux_desc;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	linux_desc = desc->extra;
+
+	return linux_desc->fd;
+}
+
 /**
  * @brief Linux platform specific UART platform ops structure
  */
@@ -301,5 +467,7 @@ const struct no_os_uart_platform_ops linux_uart_ops = {
 	.init = &linux_uart_init,
 	.read = &linux_uart_read,
 	.write = &linux_uart_write,
+	.read_nonblocking = &linux_uart_read_nonblocking,
+	.write_nonblocking = &linux_uart_write_nonblocking,
 	.remove = &linux_uart_remove
 };
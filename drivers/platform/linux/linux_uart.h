@@ -50,4 +50,7 @@ struct linux_uart_init_param {
  */
 extern const struct no_os_uart_platform_ops linux_uart_ops;
 
+/* Get the file descriptor of the UART, to wait for data with poll/epoll */
+int linux_uart_get_fd(struct no_os_uart_desc *desc);
+
 #endif // LINUX_UART_H_
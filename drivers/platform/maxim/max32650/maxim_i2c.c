@@ -228,7 +228,6 @@ static int32_t max_i2c_write(struct no_os_i2c_desc *desc,
 	mxc_i2c_regs_t *i2c_regs;
 	mxc_i2c_req_t req;
 	struct max_i2c_extra *max_i2c_desc;
-	void *ptr;
 
 	if (!desc || !desc->extra)
 		return -EINVAL;
@@ -238,14 +237,11 @@ static int32_t max_i2c_write(struct no_os_i2c_desc *desc,
 
 	if (stop_bit == 0) {
 		max_i2c_desc->prologue_size = bytes_number;
-		if (max_i2c_desc->prologue_data) {
-			ptr = realloc(max_i2c_desc->prologue_data, bytes_number);
-			max_i2c_desc->prologue_data = ptr;
-		} else {
-			max_i2c_desc->prologue_data = no_os_malloc(bytes_number);
-			if (!max_i2c_desc->prologue_data)
-				return -ENOMEM;
-		}
+		/* The previous prologue is replaced, not extended */
+		no_os_free(max_i2c_desc->prologue_data);
+		max_i2c_desc->prologue_data = no_os_malloc(bytes_number);
+		if (!max_i2c_desc->prologue_data)
+			return -ENOMEM;
 		memcpy(max_i2c_desc->prologue_data, data, bytes_number);
 
 		return 0;
@@ -37,14 +37,14 @@
 
 #include "no_os_error.h"
 #include "no_os_util.h"
-#include "no_os_list.h"
 #include "no_os_irq.h"
 #include "no_os_gpio.h"
 #include "maxim_gpio_irq.h"
 #include "maxim_irq.h"
 #include "no_os_alloc.h"
 
-static struct no_os_list_desc *actions[MXC_CFG_GPIO_INSTANCES];
+/* Callback of each pin, so the interrupt dispatch needs no lookup */
+static struct irq_action actions[MXC_CFG_GPIO_INSTANCES][MXC_CFG_GPIO_PINS_PORT];
 
 /**
  * @brief GPIO callback function that sets the event and further calls
@@ -53,16 +53,7 @@ static struct no_os_list_desc *actions[MXC_CFG_GPIO_INSTANCES];
  */
 static void gpio_irq_callback(void *cbdata)
 {
-	int ret;
-	struct irq_action *action;
-	struct irq_action *key = cbdata;
-
-	/* key->handle is the address of the GPIO port */
-	uint32_t id = MXC_GPIO_GET_IDX(key->handle);
-
-	ret = no_os_list_read_find(actions[id], (void **)&action, key);
-	if (ret)
-		return;
+	struct irq_action *action = cbdata;
 
 	if (action->callback)
 		action->callback(action->ctx);
@@ -110,10 +101,9 @@ void GPIO4_IRQHandler()
 static int max_gpio_irq_ctrl_init(struct no_os_irq_ctrl_desc **desc,
 				  const struct no_os_irq_init_param *param)
 {
-	int ret;
 	struct no_os_irq_ctrl_desc *descriptor;
 
-	if (!param)
+	if (!param || param->irq_ctrl_id >= MXC_CFG_GPIO_INSTANCES)
 		return -EINVAL;
 
 	descriptor = no_os_calloc(1, sizeof(*descriptor));
@@ -123,21 +113,9 @@ static int max_gpio_irq_ctrl_init(struct no_os_irq_ctrl_desc **desc,
 	descriptor->irq_ctrl_id = param->irq_ctrl_id;
 	descriptor->extra = param->extra;
 
-	if (!actions[param->irq_ctrl_id]) {
-		ret = no_os_list_init(&actions[param->irq_ctrl_id],
-				      NO_OS_LIST_PRIORITY_LIST, irq_action_cmp);
-		if (ret)
-			goto error;
-	}
-
 	*desc = descriptor;
 
 	return 0;
-
-error:
-	no_os_free(descriptor);
-
-	return ret;
 }
 
 /**
@@ -147,15 +125,26 @@ error:
  */
 static int max_gpio_irq_ctrl_remove(struct no_os_irq_ctrl_desc *desc)
 {
-	struct no_os_callback_desc *discard;
+	mxc_gpio_cfg_t cfg;
+	uint32_t i;
 
 	if (!desc)
 		return -EINVAL;
 
-	while (0 == no_os_list_get_first(actions[desc->irq_ctrl_id], (void **)&discard))
-		no_os_free(discard);
+	for (i = 0; i < MXC_CFG_GPIO_PINS_PORT; i++) {
+		if (!actions[desc->irq_ctrl_id][i].callback)
+			continue;
+
+		cfg = (mxc_gpio_cfg_t) {
+			.mask = NO_OS_BIT(i),
+			.port = MXC_GPIO_GET_GPIO(desc->irq_ctrl_id)
+		};
+		MXC_GPIO_RegisterCallback(&cfg, NULL, NULL);
+		actions[desc->irq_ctrl_id][i] = (struct irq_action) {
+			0
+		};
+	}
 
-	no_os_list_remove(actions[desc->irq_ctrl_id]);
 	no_os_free(desc);
 
 	return 0;
@@ -173,38 +162,17 @@ static int max_gpio_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
 		uint32_t irq_id,
 		struct no_os_callback_desc *callback_desc)
 {
-	int ret;
 	struct irq_action *action;
-	struct irq_action action_key = {.irq_id = irq_id};
 	mxc_gpio_cfg_t cfg;
 
-	if (!desc || !callback_desc)
+	if (!desc || !callback_desc || irq_id >= MXC_CFG_GPIO_PINS_PORT)
 		return -EINVAL;
 
-	ret = no_os_list_read_find(actions[desc->irq_ctrl_id], (void **)&action,
-				   &action_key);
-	/*
-	* If no action was found, insert a new one, otherwise update it
-	*/
-	if (ret) {
-		action = no_os_calloc(1, sizeof(*action));
-		if (!action)
-			return -ENOMEM;
-
-		action->irq_id = irq_id;
-		action->handle = MXC_GPIO_GET_GPIO(desc->irq_ctrl_id);
-		action->ctx = callback_desc->ctx;
-		action->callback = callback_desc->callback;
-
-		ret = no_os_list_add_last(actions[desc->irq_ctrl_id], action);
-		if (ret)
-			goto free_action;
-	} else {
-		action->irq_id = irq_id;
-		action->handle = MXC_GPIO_GET_GPIO(desc->irq_ctrl_id);
-		action->ctx = callback_desc->ctx;
-		action->callback = callback_desc->callback;
-	}
+	action = &actions[desc->irq_ctrl_id][irq_id];
+	action->irq_id = irq_id;
+	action->handle = MXC_GPIO_GET_GPIO(desc->irq_ctrl_id);
+	action->ctx = callback_desc->ctx;
+	action->callback = callback_desc->callback;
 
 	cfg = (mxc_gpio_cfg_t) {
 		.mask = NO_OS_BIT(irq_id),
@@ -213,10 +181,6 @@ static int max_gpio_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
 	MXC_GPIO_RegisterCallback(&cfg, gpio_irq_callback, action);
 
 	return 0;
-
-free_action:
-	no_os_free(action);
-	return ret;
 }
 
 /**
@@ -230,17 +194,12 @@ static int max_gpio_irq_unregister_callback(struct no_os_irq_ctrl_desc *desc,
 		uint32_t irq_id,
 		struct no_os_callback_desc *callback_desc)
 {
-	int ret;
-	struct irq_action *discard_action = NULL;
-	struct irq_action action_key = {.irq_id = irq_id};
 	mxc_gpio_cfg_t cfg;
 
 	if (!desc || !callback_desc || irq_id >= MXC_CFG_GPIO_PINS_PORT)
 		return -EINVAL;
 
-	ret = no_os_list_get_find(actions[desc->irq_ctrl_id], (void **)&discard_action,
-				  &action_key);
-	if (ret)
+	if (!actions[desc->irq_ctrl_id][irq_id].callback)
 		return -ENODEV;
 
 	cfg = (mxc_gpio_cfg_t) {
@@ -248,7 +207,9 @@ static int max_gpio_irq_unregister_callback(struct no_os_irq_ctrl_desc *desc,
 		.mask = NO_OS_BIT(irq_id)
 	};
 	MXC_GPIO_RegisterCallback(&cfg, NULL, NULL);
-	no_os_free(discard_action);
+	actions[desc->irq_ctrl_id][irq_id] = (struct irq_action) {
+		0
+	};
 
 	return 0;
 }
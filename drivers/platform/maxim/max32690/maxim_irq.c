@@ -403,11 +403,11 @@ int max_irq_ctrl_remove(struct no_os_irq_ctrl_desc *desc)
 
 	for (uint32_t i = 0; i < NO_OS_ARRAY_SIZE(_events); i++) {
 		while (0 == no_os_list_get_first(_events[i].actions, &discard))
-			free(discard);
+			no_os_free(discard);
 		no_os_list_remove(_events[i].actions);
 		_events[i].actions = NULL;
 	}
-	free(desc);
+	no_os_free(desc);
 	nvic = NULL;
 
 	return 0;
@@ -509,7 +509,7 @@ int max_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
 remove_new_action:
 	no_os_list_get_last(_events[callback_desc->event].actions, &discard);
 free_action:
-	free(action);
+	no_os_free(action);
 	return ret;
 }
 
@@ -553,7 +553,7 @@ int max_irq_unregister_callback(struct no_os_irq_ctrl_desc *desc,
 	if (ret)
 		return -ENODEV;
 
-	free(discard_action);
+	no_os_free(discard_action);
 
 	return ret;
 }
@@ -38,84 +38,82 @@
 #include "stm32_gpio.h"
 
 /**
- * @brief Prepare the GPIO decriptor.
- * @param desc - The GPIO descriptor.
- * @param param - The structure that contains the GPIO parameters.
- * @return 0 in case of success, -1 otherwise.
+ * @brief Configure the pins of a GPIO port.
+ * @param extra - The stm32 GPIO descriptor.
+ * @param port - Port number.
+ * @param pins - Mask of the port pins to be configured.
+ * @param pull - Pull up/down resistor configuration.
+ * @param pextra - stm32 specific parameters, may be NULL.
+ * @return 0 in case of success, negative error code otherwise.
  */
-static int32_t _gpio_init(struct no_os_gpio_desc *desc,
-			  const struct no_os_gpio_init_param *param)
+static int32_t _gpio_config(struct stm32_gpio_desc *extra, int32_t port,
+			    uint32_t pins, enum no_os_gpio_pull_up pull,
+			    struct stm32_gpio_init_param *pextra)
 {
-	int32_t ret = 0;
-	struct stm32_gpio_desc *extra = desc->extra;
-	struct stm32_gpio_init_param *pextra = param->extra;
 	uint32_t mode = GPIO_MODE_INPUT;
 	uint32_t speed = GPIO_SPEED_FREQ_LOW;
 
-	if (!param)
-		return -EINVAL;
-
 	/* enable gpio port in RCC */
-	if (param->port == 0) {
+	if (port == 0) {
 		__HAL_RCC_GPIOA_CLK_ENABLE();
 		extra->port = GPIOA;
 	}
 #ifdef GPIOB
-	else if (param->port == 1) {
+	else if (port == 1) {
 		__HAL_RCC_GPIOB_CLK_ENABLE();
 		extra->port = GPIOB;
 	}
 #endif
 #ifdef GPIOC
-	else if (param->port == 2) {
+	else if (port == 2) {
 		__HAL_RCC_GPIOC_CLK_ENABLE();
 		extra->port = GPIOC;
 	}
 #endif
 #ifdef GPIOD
-	else if (param->port == 3) {
+	else if (port == 3) {
 		__HAL_RCC_GPIOD_CLK_ENABLE();
 		extra->port = GPIOD;
 	}
 #endif
 #ifdef GPIOE
-	else if (param->port == 4) {
+	else if (port == 4) {
 		__HAL_RCC_GPIOE_CLK_ENABLE();
 		extra->port = GPIOE;
 	}
 #endif
 #ifdef GPIOF
-	else if (param->port == 5) {
+	else if (port == 5) {
 		__HAL_RCC_GPIOF_CLK_ENABLE();
 		extra->port = GPIOF;
 	}
 #endif
 #ifdef GPIOG
-	else if (param->port == 6) {
+	else if (port == 6) {
 		__HAL_RCC_GPIOG_CLK_ENABLE();
 		extra->port = GPIOG;
 	}
 #endif
 #ifdef GPIOH
-	else if (param->port == 7) {
+	else if (port == 7) {
 		__HAL_RCC_GPIOH_CLK_ENABLE();
 		extra->port = GPIOH;
 	}
 #endif
 #ifdef GPIOI
-	else if (param->port == 8) {
+	else if (port == 8) {
 		__HAL_RCC_GPIOI_CLK_ENABLE();
 		extra->port = GPIOI;
 	}
 #endif
 #ifdef GPIOJ
-	else if (param->port == 9) {
+	else if (port == 9) {
 		__HAL_RCC_GPIOJ_CLK_ENABLE();
 		extra->port = GPIOJ;
 	}
 #endif
 #ifdef GPIOK
-	else if (param->port == 10) {
+	else if (port == 10) {
 		__HAL_RCC_GPIOK_CLK_ENABLE();
 		extra->port = GPIOK;
 	}
@@ -123,7 +121,7 @@ static int32_t _gpio_init(struct no_os_gpio_desc *desc,
 	else
 		return -EINVAL;
 
-	if (param->extra) {
+	if (pextra) {
 		mode = pextra->mode;
 		speed = pextra->speed;
 	}
@@ -143,12 +141,7 @@ static int32_t _gpio_init(struct no_os_gpio_desc *desc,
 		return -EINVAL;
 	}
 
-	/* copy the settings to gpio descriptor */
-	desc->port = param->port;
-	desc->number = param->number;
-	desc->pull = param->pull;
-
-	switch (param->pull) {
+	switch (pull) {
 	case NO_OS_PULL_NONE:
 		extra->gpio_config.Pull = GPIO_NOPULL;
 		break;
@@ -165,13 +158,34 @@ static int32_t _gpio_init(struct no_os_gpio_desc *desc,
 	}
 
 	/* configure gpio with user configuration */
-	extra->gpio_config.Pin = NO_OS_BIT(param->number);
+	extra->gpio_config.Pin = pins;
 	extra->gpio_config.Mode = mode;
 	extra->gpio_config.Speed = speed;
 
 	HAL_GPIO_Init(extra->port, &extra->gpio_config);
 
-	return ret;
+	return 0;
+}
+
+/**
+ * @brief Prepare the GPIO decriptor.
+ * @param desc - The GPIO descriptor.
+ * @param param - The structure that contains the GPIO parameters.
+ * @return 0 in case of success, -1 otherwise.
+ */
+static int32_t _gpio_init(struct no_os_gpio_desc *desc,
+			  const struct no_os_gpio_init_param *param)
+{
+	if (!param)
+		return -EINVAL;
+
+	/* copy the settings to gpio descriptor */
+	desc->port = param->port;
+	desc->number = param->number;
+	desc->pull = param->pull;
+
+	return _gpio_config(desc->extra, param->port, NO_OS_BIT(param->number),
+			    param->pull, param->extra);
 }
 
 /**
@@ -379,6 +393,196 @@ int32_t stm32_gpio_get_value(struct no_os_gpio_desc *desc,
 	return 0;
 }
 
+/**
+ * @brief Convert group values to a mask of port pins.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Bit n for GPIO n of the group.
+ * @return Mask of the port pins.
+ */
+static uint32_t stm32_gpio_group_pins(struct no_os_gpio_group_desc *desc,
+				      uint32_t values)
+{
+	uint32_t pins = 0;
+	uint32_t i;
+
+	for (i = 0; i < desc->num; i++)
+		if (values & NO_OS_BIT(i))
+			pins |= NO_OS_BIT(desc->numbers[i]);
+
+	return pins;
+}
+
+/**
+ * @brief Obtain a GPIO group descriptor.
+ * @param desc - The GPIO group descriptor.
+ * @param param - GPIO group initialization parameters.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_group_get(struct no_os_gpio_group_desc **desc,
+			     const struct no_os_gpio_group_init_param *param)
+{
+	struct no_os_gpio_group_desc *descriptor;
+	struct stm32_gpio_desc *extra;
+	uint32_t pins = 0;
+	int32_t ret;
+	uint32_t i;
+
+	if (!desc || !param)
+		return -EINVAL;
+
+	for (i = 0; i < param->num; i++) {
+		if (param->numbers[i] < 0 || param->numbers[i] > 15)
+			return -EINVAL;
+		pins |= NO_OS_BIT(param->numbers[i]);
+	}
+
+	descriptor = no_os_calloc(1, sizeof(*descriptor));
+	if (!descriptor)
+		return -ENOMEM;
+
+	extra = no_os_calloc(1, sizeof(*extra));
+	if (!extra) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	ret = _gpio_config(extra, param->port, pins, param->pull, param->extra);
+	if (ret)
+		goto error;
+
+	for (i = 0; i < param->num; i++)
+		descriptor->numbers[i] = param->numbers[i];
+	descriptor->port = param->port;
+	descriptor->num = param->num;
+	descriptor->pull = param->pull;
+	descriptor->extra = extra;
+	*desc = descriptor;
+
+	return 0;
+error:
+	no_os_free(extra);
+	no_os_free(descriptor);
+
+	return ret;
+}
+
+/**
+ * @brief Free the resources allocated by stm32_gpio_group_get().
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_group_remove(struct no_os_gpio_group_desc *desc)
+{
+	if (desc)
+		no_os_free(desc->extra);
+
+	no_os_free(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Enable the input direction of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_group_direction_input(struct no_os_gpio_group_desc *desc)
+{
+	struct stm32_gpio_desc *extra;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	extra = desc->extra;
+	extra->gpio_config.Mode = GPIO_MODE_INPUT;
+	HAL_GPIO_Init(extra->port, &extra->gpio_config);
+
+	return 0;
+}
+
+/**
+ * @brief Set the GPIOs of the group selected by mask with one BSRR write.
+ * @param desc - The GPIO group descriptor.
+ * @param mask - GPIOs to be updated, bit n for GPIO n of the group.
+ * @param values - New values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_group_set_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t values)
+{
+	struct stm32_gpio_desc *extra;
+	uint32_t set;
+	uint32_t reset;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	extra = desc->extra;
+	set = stm32_gpio_group_pins(desc, mask & values);
+	reset = stm32_gpio_group_pins(desc, mask & ~values);
+
+	/* the upper half of BSRR resets, the lower half sets port pins */
+	extra->port->BSRR = (reset << 16) | set;
+
+	return 0;
+}
+
+/**
+ * @brief Enable the output direction of all the GPIOs of the group.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Initial output values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_group_direction_output(struct no_os_gpio_group_desc *desc,
+		uint32_t values)
+{
+	struct stm32_gpio_desc *extra;
+	int32_t ret;
+
+	if (!desc || !desc->extra)
+		return -EINVAL;
+
+	/* set the output levels before enabling the drivers */
+	ret = stm32_gpio_group_set_values(desc, NO_OS_GENMASK(desc->num - 1, 0),
+					  values);
+	if (ret)
+		return ret;
+
+	extra = desc->extra;
+	if (extra->gpio_config.Mode == GPIO_MODE_INPUT)
+		extra->gpio_config.Mode = GPIO_MODE_OUTPUT_PP;
+	HAL_GPIO_Init(extra->port, &extra->gpio_config);
+
+	return 0;
+}
+
+/**
+ * @brief Get the values of all the GPIOs of the group with one IDR read.
+ * @param desc - The GPIO group descriptor.
+ * @param values - Read values, bit n for GPIO n of the group.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t stm32_gpio_group_get_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t *values)
+{
+	struct stm32_gpio_desc *extra;
+	uint32_t idr;
+	uint32_t i;
+
+	if (!desc || !desc->extra || !values)
+		return -EINVAL;
+
+	extra = desc->extra;
+	idr = extra->port->IDR;
+
+	*values = 0;
+	for (i = 0; i < desc->num; i++)
+		if (idr & NO_OS_BIT(desc->numbers[i]))
+			*values |= NO_OS_BIT(i);
+
+	return 0;
+}
+
 /**
  * @brief stm32 platform specific GPIO platform ops structure
  */
@@ -391,4 +595,10 @@ const struct no_os_gpio_platform_ops stm32_gpio_ops = {
 	.gpio_ops_get_direction = &stm32_gpio_get_direction,
 	.gpio_ops_set_value = &stm32_gpio_set_value,
 	.gpio_ops_get_value = &stm32_gpio_get_value,
+	.gpio_ops_group_get = &stm32_gpio_group_get,
+	.gpio_ops_group_remove = &stm32_gpio_group_remove,
+	.gpio_ops_group_direction_input = &stm32_gpio_group_direction_input,
+	.gpio_ops_group_direction_output = &stm32_gpio_group_direction_output,
+	.gpio_ops_group_set_values = &stm32_gpio_group_set_values,
+	.gpio_ops_group_get_values = &stm32_gpio_group_get_values,
 };
@@ -95,16 +95,7 @@ static int8_t CDC_Control(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 
 void stm32_on_usb_cdc_acm_rx(uint8_t* buf, uint32_t len)
 {
-	unsigned int i = 0;
-	int ret;
-
-	while (i < len) {
-		ret = lf256fifo_write(gfifo, buf[i]);
-		if (ret)
-			break;
-
-		i++;
-	}
+	lf256fifo_write_bulk(gfifo, buf, len);
 }
 
 static int8_t CDC_Receive(uint8_t* Buf, uint32_t *Len)
@@ -257,18 +248,9 @@ static int32_t stm32_usb_uart_write(struct no_os_uart_desc *desc,
 static int32_t stm32_usb_uart_read(struct no_os_uart_desc *desc, uint8_t *data,
 				   uint32_t bytes_number)
 {
-	int ret;
-	unsigned int i = 0;
 	struct stm32_usb_uart_desc *sdesc = desc->extra;
 
-	while (i < bytes_number) {
-		ret = lf256fifo_read(sdesc->fifo, &data[i]);
-		if (ret)
-			break;
-		i++;
-	}
-
-	return i;
+	return lf256fifo_read_bulk(sdesc->fifo, data, bytes_number);
 }
 
 /**
@@ -33,6 +33,9 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
+/* Account the allocations of this file under the iio tag */
+#define NO_OS_ALLOC_TAG		NO_OS_ALLOC_TAG_IIO
+
 #include "iio.h"
 #include "iio_types.h"
 #include "iiod.h"
@@ -43,8 +46,11 @@
 #include "no_os_uart.h"
 #include "no_os_error.h"
 #include "no_os_alloc.h"
+#include "no_os_mutex.h"
 #include "no_os_circular_buffer.h"
+#include "no_os_spsc_ring.h"
 #include <inttypes.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -59,11 +65,28 @@
 #include "lwip_socket.h"
 #endif
 
+#ifdef LINUX_PLATFORM
+#include <poll.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 #define IIOD_PORT		30431
 #define MAX_SOCKET_TO_HANDLE	10
 #define REG_ACCESS_ATTRIBUTE	"direct_reg_access"
 #define IIOD_CONN_BUFFER_SIZE	0x1000
 #define NO_TRIGGER				(uint32_t)-1
+/* Xml fragments longer than this are formatted in an allocated buffer */
+#define IIO_XML_FRAGMENT_SIZE	256
+
+/* epoll tags of the fds that are not connections, which use their id */
+#define IIO_EVENT_SERVER	IIOD_MAX_CONNECTIONS
+#define IIO_EVENT_WAKE		(IIOD_MAX_CONNECTIONS + 1)
+#define IIO_MAX_EVENTS		(IIOD_MAX_CONNECTIONS + 2)
+/* Time a worker sleeps between steps of a connection that can't be polled */
+#define IIO_WORKER_POLL_MS	1
 
 #define NO_OS_STRINGIFY(x) #x
 #define NO_OS_TOSTRING(x) NO_OS_STRINGIFY(x)
@@ -141,14 +164,48 @@ struct iio_buffer_priv {
 	struct iio_buffer	public;
 	/** Buffer to read or write data. A reference will be found in buffer */
 	struct no_os_circular_buffer	cb;
+	/*
+	 * Scans pushed or popped by devices with a trigger handler, which can
+	 * run in interrupt context. They are moved from/to cb by iiod, so cb
+	 * is only accessed from one context.
+	 */
+	struct no_os_spsc_ring	*scans;
 	/* Buffer provide by user. */
 	int8_t			*raw_buf;
 	/* Length of raw_buf */
 	uint32_t		raw_buf_len;
+	/* Number of blocks to allocate when raw_buf is not provided */
+	uint32_t		nb_blocks;
+	/*
+	 * Blocks handed out by iio_buffer_get_block and not yet marked done.
+	 * They follow, in order, the write index of cb for input buffers and
+	 * the read index for output buffers.
+	 */
+	uint32_t		pending;
+	/*
+	 * Blocks marked done, possibly from interrupt context, and not yet
+	 * released in cb. Only iio_buffer_block_done increments it, atomically,
+	 * so pending and cb are only accessed from the context of iiod.
+	 */
+	uint32_t		done;
+#ifdef LINUX_PLATFORM
+	/* Used to wake up iiod when data comes from interrupt context */
+	struct iio_desc		*desc;
+	/* Set when iiod waits for data to be pushed in the buffer */
+	bool			waiting;
+#endif
 	/* Set when this devices has buffer */
 	bool			initalized;
-	/* Set when no_os_calloc was used to initalize cb.buf */
-	bool			allocated;
+	/*
+	 * Memory allocated for cb when raw_buf is not provided. With
+	 * IIO_REUSE_BUFFERS it is kept between iio_close_dev and iio_open_dev
+	 * and reused while big enough.
+	 */
+	int8_t			*alloc_buf;
+	/* Length of alloc_buf */
+	uint32_t		alloc_len;
+	/* scans ring of the last open, reused if the same size is needed */
+	struct no_os_spsc_ring	*spare_scans;
 };
 
 /**
@@ -173,6 +230,8 @@ struct iio_dev_priv {
 	struct iio_buffer_priv buffer;
 	/* Set to -1 when no trigger is set*/
 	uint32_t		trig_idx;
+	/* Serializes the callbacks of the device when the server is threaded */
+	void			*lock;
 };
 
 /**
@@ -193,11 +252,28 @@ struct iio_trig_priv {
 	bool	triggered;
 };
 
+#ifdef LINUX_PLATFORM
+/* Thread serving one connection */
+struct iio_worker {
+	struct iio_desc		*desc;
+	pthread_t		thread;
+	uint32_t		conn_id;
+	/* Connection file descriptor. Negative if it can't be polled */
+	int			fd;
+	/* Set while thread has to be joined */
+	bool			started;
+	/* eventfd written by iio_wakeup, for transfers waiting device data */
+	int			wake_fd;
+};
+#endif
+
 struct iio_desc {
 	struct iiod_desc	*iiod;
 	struct iiod_ops		iiod_ops;
 	void			*phy_desc;
-	char			*xml_desc;
+	/* Offset in the context xml of each of its pieces */
+	uint32_t		*xml_offsets;
+	uint32_t		xml_nb_pieces;
 	uint32_t		xml_size;
 	struct iio_ctx_attr	*ctx_attrs;
 	uint32_t		nb_ctx_attr;
@@ -205,18 +281,45 @@ struct iio_desc {
 	uint32_t		nb_devs;
 	struct iio_trig_priv	*trigs;
 	uint32_t		nb_trigs;
+	/* Hash table used to find objects by name. Its size is index_mask + 1 */
+	struct iio_index_entry	*index;
+	uint32_t		index_mask;
 	struct no_os_uart_desc	*uart_desc;
 	int (*recv)(void *conn, uint8_t *buf, uint32_t len);
 	int (*send)(void *conn, uint8_t *buf, uint32_t len);
 	/* FIFO for socket descriptors */
 	struct no_os_circular_buffer	*conns;
+	/* Protects the iiod connection pool when the server is threaded */
+	void			*conns_lock;
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
 	struct tcp_socket_desc	*current_sock;
 	/* Instance of server socket */
 	struct tcp_socket_desc	*server;
 #endif
+#ifdef LINUX_PLATFORM
+	/* Waits on the server, the connections and wake_fd */
+	int			epoll_fd;
+	/* eventfd used to wake up iio_step_wait */
+	int			wake_fd;
+	/* File descriptor of each connection. Negative if it can't be polled */
+	int			conn_fd[IIOD_MAX_CONNECTIONS];
+	/* Set when the connection must be stepped without waiting for data */
+	bool			conn_ready[IIOD_MAX_CONNECTIONS];
+	/* Serve each connection from its own thread */
+	bool			threaded;
+	struct iio_worker	workers[IIOD_MAX_CONNECTIONS];
+	/* eventfd set in order to stop the workers */
+	int			stop_fd;
+	volatile bool		stopping;
+#endif
 };
 
+static inline struct iio_buffer_priv *_to_buffer_priv(struct iio_buffer *buf)
+{
+	/* public is the first member of struct iio_buffer_priv */
+	return (struct iio_buffer_priv *)buf;
+}
+
 static inline int32_t _pop_conn(struct iio_desc *desc, uint32_t *conn_id)
 {
 	uint32_t size;
@@ -242,6 +345,267 @@ static inline int32_t _nb_active_conns(struct iio_desc *desc)
 	return size / sizeof(uint32_t);
 }
 
+#ifdef LINUX_PLATFORM
+static int32_t iio_event_init(struct iio_desc *desc)
+{
+	struct epoll_event ev = {
+		.events = EPOLLIN,
+		.data.u32 = IIO_EVENT_WAKE
+	};
+	uint32_t i;
+
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		desc->conn_fd[i] = -1;
+
+	desc->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (desc->epoll_fd < 0)
+		return -errno;
+
+	desc->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (desc->wake_fd < 0)
+		goto close_epoll;
+
+	if (epoll_ctl(desc->epoll_fd, EPOLL_CTL_ADD, desc->wake_fd, &ev) < 0)
+		goto close_wake;
+
+	return 0;
+
+close_wake:
+	close(desc->wake_fd);
+close_epoll:
+	close(desc->epoll_fd);
+
+	return -errno;
+}
+
+static void iio_event_remove(struct iio_desc *desc)
+{
+	close(desc->wake_fd);
+	close(desc->epoll_fd);
+}
+
+/* Wait for fd to be readable. tag is returned by epoll for this fd */
+static int32_t iio_event_add(struct iio_desc *desc, int fd, uint32_t tag)
+{
+	struct epoll_event ev = {
+		.events = EPOLLIN,
+		.data.u32 = tag
+	};
+
+	if (fd < 0)
+		return 0;
+
+	if (epoll_ctl(desc->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+		return -errno;
+
+	return 0;
+}
+#endif
+
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
+static int _sock_fd(struct tcp_socket_desc *sock)
+{
+#ifndef DISABLE_SECURE_SOCKET
+	/* TLS keeps received data in its own buffers, the fd can't be polled */
+	if (sock->secure)
+		return -1;
+#endif
+
+	return sock->id;
+}
+#endif
+
+/* Release a connection closed by the client. It must not be queued */
+static void _remove_conn(struct iio_desc *desc, uint32_t conn_id)
+{
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
+	struct iiod_conn_data data;
+#endif
+
+#ifdef LINUX_PLATFORM
+	if (desc->conn_fd[conn_id] >= 0)
+		epoll_ctl(desc->epoll_fd, EPOLL_CTL_DEL, desc->conn_fd[conn_id],
+			  NULL);
+	desc->conn_fd[conn_id] = -1;
+	desc->conn_ready[conn_id] = false;
+#endif
+#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
+	iiod_conn_remove(desc->iiod, conn_id, &data);
+	socket_remove(data.conn);
+	no_os_free(data.buf);
+#endif
+}
+
+#ifdef LINUX_PLATFORM
+static void *iio_worker_run(void *arg)
+{
+	struct iio_worker *worker = arg;
+	struct iio_desc *desc = worker->desc;
+	struct pollfd fds[3] = {
+		{ .fd = worker->fd, .events = POLLIN },
+		{ .fd = desc->stop_fd, .events = POLLIN },
+		{ .fd = worker->wake_fd, .events = POLLIN },
+	};
+	uint64_t cnt;
+	int32_t ret;
+	int timeout;
+
+	/* poll ignores a negative fd, only stop_fd and wake_fd are waited */
+	timeout = worker->fd < 0 ? IIO_WORKER_POLL_MS : -1;
+
+	while (!desc->stopping) {
+		ret = iiod_conn_step(desc->iiod, worker->conn_id);
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
+			break;
+
+		/* A command was completed, the next one may be received */
+		if (ret != -EAGAIN)
+			continue;
+
+		/*
+		 * Sleep until the client sends data, the device has new data
+		 * (iio_wakeup) or, if stuck in sending, the socket has room.
+		 * Connections that can't be polled are stepped again after
+		 * IIO_WORKER_POLL_MS, unless woken up earlier.
+		 */
+		fds[0].events = iiod_conn_is_idle(desc->iiod, worker->conn_id) ?
+				POLLIN : POLLOUT;
+		if (poll(fds, NO_OS_ARRAY_SIZE(fds), timeout) > 0 &&
+		    (fds[2].revents & POLLIN) &&
+		    read(worker->wake_fd, &cnt, sizeof(cnt)) < 0)
+			break;
+	}
+
+	no_os_mutex_lock(desc->conns_lock);
+	_remove_conn(desc, worker->conn_id);
+	no_os_mutex_unlock(desc->conns_lock);
+
+	return NULL;
+}
+
+static void iio_worker_join(struct iio_worker *worker)
+{
+	if (!worker->started)
+		return;
+
+	pthread_join(worker->thread, NULL);
+	worker->started = false;
+}
+
+static int32_t iio_worker_start(struct iio_desc *desc, uint32_t conn_id,
+				int fd)
+{
+	struct iio_worker *worker = &desc->workers[conn_id];
+	int ret;
+
+	/* The previous user of the slot has already released it */
+	iio_worker_join(worker);
+
+	worker->desc = desc;
+	worker->conn_id = conn_id;
+	worker->fd = fd;
+	ret = pthread_create(&worker->thread, NULL, iio_worker_run, worker);
+	if (ret)
+		return -ret;
+
+	worker->started = true;
+
+	return 0;
+}
+
+static int32_t iio_workers_init(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	desc->stop_fd = eventfd(0, EFD_CLOEXEC);
+	if (desc->stop_fd < 0)
+		return -errno;
+
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		desc->workers[i].wake_fd = eventfd(0, EFD_NONBLOCK |
+						   EFD_CLOEXEC);
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		if (desc->workers[i].wake_fd < 0)
+			goto error;
+
+	/* Fails with the default mutex implementation, that does nothing */
+	no_os_mutex_init(&desc->conns_lock);
+	if (!desc->conns_lock)
+		goto error;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+		no_os_mutex_init(&desc->devs[i].lock);
+		if (!desc->devs[i].lock)
+			goto error;
+	}
+
+	desc->threaded = true;
+
+	return 0;
+error:
+	for (i = 0; i < desc->nb_devs; i++)
+		no_os_mutex_remove(desc->devs[i].lock);
+	no_os_mutex_remove(desc->conns_lock);
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		if (desc->workers[i].wake_fd >= 0)
+			close(desc->workers[i].wake_fd);
+	close(desc->stop_fd);
+
+	return -ENOSYS;
+}
+
+/* Stop all workers. Their connections are closed */
+static void iio_workers_remove(struct iio_desc *desc)
+{
+	uint64_t cnt = 1;
+	uint32_t i;
+
+	if (!desc->threaded)
+		return;
+
+	desc->stopping = true;
+	if (write(desc->stop_fd, &cnt, sizeof(cnt)) < 0)
+		return;
+
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		iio_worker_join(&desc->workers[i]);
+
+	for (i = 0; i < desc->nb_devs; i++)
+		no_os_mutex_remove(desc->devs[i].lock);
+	no_os_mutex_remove(desc->conns_lock);
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		close(desc->workers[i].wake_fd);
+	close(desc->stop_fd);
+	desc->threaded = false;
+}
+#endif
+
+/*
+ * Queue a new connection. On Linux, fd is waited by iio_step_wait, or by
+ * the worker serving the connection when threaded. It can be negative for
+ * connections that can't be polled.
+ */
+static int32_t _add_conn(struct iio_desc *desc, uint32_t conn_id, int fd)
+{
+#ifdef LINUX_PLATFORM
+	int32_t ret;
+
+	if (desc->threaded)
+		return iio_worker_start(desc, conn_id, fd);
+
+	ret = iio_event_add(desc, fd, conn_id);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	desc->conn_fd[conn_id] = fd;
+	/* Step it at least once, it may have something to send */
+	desc->conn_ready[conn_id] = true;
+#endif
+
+	return _push_conn(desc, conn_id);
+}
+
+
 
 static int iio_recv(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
 {
@@ -277,28 +641,354 @@ static inline void _print_ch_id(char *buff, struct iio_channel *ch)
 	}
 }
 
+static struct iio_attribute *get_attributes(enum iio_attr_type type,
+		struct iio_dev_priv *dev,
+		struct iio_channel *ch)
+{
+	switch (type) {
+	case IIO_ATTR_TYPE_DEBUG:
+		return dev->dev_descriptor->debug_attributes;
+		break;
+	case IIO_ATTR_TYPE_DEVICE:
+		return dev->dev_descriptor->attributes;
+		break;
+	case IIO_ATTR_TYPE_BUFFER:
+		return dev->dev_descriptor->buffer_attributes;
+		break;
+	case IIO_ATTR_TYPE_CH_IN:
+	case IIO_ATTR_TYPE_CH_OUT:
+		return ch->attributes;
+	}
+
+	return NULL;
+}
+
 /**
- * @brief Get channel ID from a list of channels.
+ * @brief Returns trigger attributes.
+ * @param type - Attribute type.
+ * @param trig - Trigger instance.
+ * @return Attributes pointer if attributes exist, NULL otherwise.
+ */
+static struct iio_attribute *get_trig_attributes(enum iio_attr_type type,
+		struct iio_trig_priv *trig)
+{
+	switch (type) {
+	/* Only device type attributes allowed for triggers */
+	case IIO_ATTR_TYPE_DEVICE:
+		return trig->descriptor->attributes;
+		break;
+	default:
+		break;
+	}
+
+	return NULL;
+}
+
+/*
+ * Lookup index of devices, triggers, channels and attributes, built by
+ * iio_init so commands don't have to scan them by name. It is an open
+ * addressing hash table storing only indexes, the names being compared
+ * against the device descriptors.
+ */
+enum iio_index_kind {
+	IIO_INDEX_DEV = 1,
+	IIO_INDEX_CHAN,
+	IIO_INDEX_ATTR,
+};
+
+struct iio_index_entry {
+	/* Hash of the key. An entry with kind 0 is empty */
+	uint32_t	hash;
+	/* Index of the device. Triggers follow the devices */
+	uint16_t	dev;
+	/* Index of the channel or IIO_INDEX_NO_CH */
+	uint16_t	ch;
+	/* Index of the attribute in its list */
+	uint16_t	attr;
+	uint8_t		kind;
+	/* enum iio_attr_type of the attribute or ch_out for channels */
+	uint8_t		type;
+};
+
+#define IIO_INDEX_NO_CH		0xFFFF
+
+/*
+ * Devices are keyed only by name, channels also by device and direction and
+ * attributes by device, channel and type. The other fields are values.
+ */
+static uint32_t iio_index_hash(uint8_t kind, uint16_t dev, uint16_t ch,
+			       uint8_t type, const char *name)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	uint32_t key[4];
+	uint32_t i;
+
+	key[0] = kind;
+	key[1] = kind == IIO_INDEX_DEV ? 0 : dev;
+	key[2] = kind == IIO_INDEX_ATTR ? ch : 0;
+	key[3] = kind == IIO_INDEX_DEV ? 0 : type;
+	for (i = 0; i < NO_OS_ARRAY_SIZE(key); i++)
+		hash = (hash ^ key[i]) * 16777619u;
+	while (*name)
+		hash = (hash ^ (uint8_t)*name++) * 16777619u;
+
+	return hash;
+}
+
+static bool iio_index_key_equal(struct iio_index_entry *entry, uint8_t kind,
+				uint16_t dev, uint16_t ch, uint8_t type)
+{
+	if (entry->kind != kind)
+		return false;
+	if (kind == IIO_INDEX_DEV)
+		return true;
+	if (entry->dev != dev || entry->type != type)
+		return false;
+
+	return kind == IIO_INDEX_CHAN || entry->ch == ch;
+}
+
+static struct iio_attribute *iio_index_attributes(struct iio_desc *desc,
+		uint16_t dev, uint16_t ch, enum iio_attr_type type)
+{
+	struct iio_dev_priv *ldev;
+
+	if (dev >= desc->nb_devs)
+		return get_trig_attributes(type, desc->trigs + dev -
+					   desc->nb_devs);
+
+	ldev = desc->devs + dev;
+	if (ch == IIO_INDEX_NO_CH)
+		return get_attributes(type, ldev, NULL);
+
+	return get_attributes(type, ldev, ldev->dev_descriptor->channels + ch);
+}
+
+static bool iio_index_match(struct iio_desc *desc,
+			    struct iio_index_entry *entry, const char *name)
+{
+	struct iio_attribute *attributes;
+	char ch_id[MAX_CHN_ID];
+
+	switch (entry->kind) {
+	case IIO_INDEX_DEV:
+		if (entry->dev < desc->nb_devs)
+			return !strcmp(desc->devs[entry->dev].dev_id, name);
+		return !strcmp(desc->trigs[entry->dev - desc->nb_devs].id, name);
+	case IIO_INDEX_CHAN:
+		_print_ch_id(ch_id, desc->devs[entry->dev].dev_descriptor->channels +
+			     entry->ch);
+		return !strcmp(ch_id, name);
+	case IIO_INDEX_ATTR:
+		attributes = iio_index_attributes(desc, entry->dev, entry->ch,
+						  entry->type);
+		return !strcmp(attributes[entry->attr].name, name);
+	default:
+		return false;
+	}
+}
+
+/* Return the entry matching the key or the empty slot where it would go */
+static struct iio_index_entry *iio_index_slot(struct iio_desc *desc,
+		uint8_t kind, uint16_t dev, uint16_t ch, uint8_t type,
+		const char *name)
+{
+	struct iio_index_entry *entry;
+	uint32_t hash, i;
+
+	hash = iio_index_hash(kind, dev, ch, type, name);
+	i = hash & desc->index_mask;
+	while (true) {
+		entry = &desc->index[i];
+		if (!entry->kind)
+			return entry;
+		if (entry->hash == hash &&
+		    iio_index_key_equal(entry, kind, dev, ch, type) &&
+		    iio_index_match(desc, entry, name))
+			return entry;
+		i = (i + 1) & desc->index_mask;
+	}
+}
+
+/* Find the index of a device, channel or attribute. Negative if not found */
+static int32_t iio_index_find(struct iio_desc *desc, uint8_t kind,
+			      uint16_t dev, uint16_t ch, uint8_t type,
+			      const char *name)
+{
+	struct iio_index_entry *entry;
+
+	if (!desc->index)
+		return -ENOENT;
+
+	entry = iio_index_slot(desc, kind, dev, ch, type, name);
+	if (!entry->kind)
+		return -ENOENT;
+
+	switch (kind) {
+	case IIO_INDEX_DEV:
+		return entry->dev;
+	case IIO_INDEX_CHAN:
+		return entry->ch;
+	default:
+		return entry->attr;
+	}
+}
+
+/*
+ * Add an entry if its key is not already present, so the first of two
+ * objects with the same name is found, as with a linear search.
+ */
+static void iio_index_add(struct iio_desc *desc, uint8_t kind, uint16_t dev,
+			  uint16_t ch, uint16_t attr, uint8_t type,
+			  const char *name)
+{
+	struct iio_index_entry *entry;
+
+	entry = iio_index_slot(desc, kind, dev, ch, type, name);
+	if (entry->kind)
+		return;
+
+	entry->hash = iio_index_hash(kind, dev, ch, type, name);
+	entry->kind = kind;
+	entry->dev = dev;
+	entry->ch = ch;
+	entry->attr = attr;
+	entry->type = type;
+}
+
+/* Add the attributes of a list or only count them if the index is not set */
+static uint32_t iio_index_add_attrs(struct iio_desc *desc, uint16_t dev,
+				    uint16_t ch, enum iio_attr_type type)
+{
+	struct iio_attribute *attributes;
+	uint32_t i;
+
+	attributes = iio_index_attributes(desc, dev, ch, type);
+	if (!attributes)
+		return 0;
+
+	for (i = 0; attributes[i].name; i++)
+		if (desc->index)
+			iio_index_add(desc, IIO_INDEX_ATTR, dev, ch, i, type,
+				      attributes[i].name);
+
+	return i;
+}
+
+/* Add all the objects to the index or only count them if it is not set */
+static uint32_t iio_index_add_all(struct iio_desc *desc)
+{
+	struct iio_channel *ch;
+	struct iio_device *dev;
+	uint32_t i, j, cnt = 0;
+	char ch_id[MAX_CHN_ID];
+	uint8_t type;
+
+	for (i = 0; i < desc->nb_devs + desc->nb_trigs; i++) {
+		if (desc->index)
+			iio_index_add(desc, IIO_INDEX_DEV, i, IIO_INDEX_NO_CH,
+				      0, 0, i < desc->nb_devs ?
+				      desc->devs[i].dev_id :
+				      desc->trigs[i - desc->nb_devs].id);
+		cnt++;
+
+		if (i >= desc->nb_devs) {
+			cnt += iio_index_add_attrs(desc, i, IIO_INDEX_NO_CH,
+						   IIO_ATTR_TYPE_DEVICE);
+			continue;
+		}
+
+		cnt += iio_index_add_attrs(desc, i, IIO_INDEX_NO_CH,
+					   IIO_ATTR_TYPE_DEVICE);
+		cnt += iio_index_add_attrs(desc, i, IIO_INDEX_NO_CH,
+					   IIO_ATTR_TYPE_DEBUG);
+		cnt += iio_index_add_attrs(desc, i, IIO_INDEX_NO_CH,
+					   IIO_ATTR_TYPE_BUFFER);
+
+		dev = desc->devs[i].dev_descriptor;
+		if (!dev->channels)
+			continue;
+
+		for (j = 0; j < dev->num_ch; j++) {
+			ch = dev->channels + j;
+			if (desc->index) {
+				_print_ch_id(ch_id, ch);
+				iio_index_add(desc, IIO_INDEX_CHAN, i, j, 0,
+					      ch->ch_out, ch_id);
+			}
+			cnt++;
+
+			type = ch->ch_out ? IIO_ATTR_TYPE_CH_OUT :
+			       IIO_ATTR_TYPE_CH_IN;
+			cnt += iio_index_add_attrs(desc, i, j, type);
+		}
+	}
+
+	return cnt;
+}
+
+static int32_t iio_init_index(struct iio_desc *desc)
+{
+	uint32_t size = 1;
+	uint32_t cnt;
+
+	cnt = iio_index_add_all(desc);
+	/* Keep the table at most half full */
+	while (size < 2 * cnt)
+		size <<= 1;
+
+	desc->index = no_os_calloc(size, sizeof(*desc->index));
+	if (!desc->index)
+		return -ENOMEM;
+
+	desc->index_mask = size - 1;
+	iio_index_add_all(desc);
+
+	return 0;
+}
+
+/**
+ * @brief Get channel from the channels of a device.
+ * @param desc - IIO descriptor.
+ * @param dev - Device interface.
  * @param channel - Channel name.
- * @param desc - Device descriptor
  * @param ch_out - If "true" is output channel, if "false" is input channel.
- * @return Channel ID, or negative value if attribute is not found.
+ * @return Channel pointer, or NULL if the channel is not found.
  */
-static inline struct iio_channel *iio_get_channel(const char *channel,
-		struct iio_device *desc, bool ch_out)
+static inline struct iio_channel *iio_get_channel(struct iio_desc *desc,
+		struct iio_dev_priv *dev, const char *channel, bool ch_out)
 {
-	int16_t i = 0;
-	char	ch_id[MAX_CHN_ID];
+	int32_t i;
 
-	while (i < desc->num_ch) {
-		_print_ch_id(ch_id, &desc->channels[i]);
-		if (!strcmp(channel, ch_id) &&
-		    (desc->channels[i].ch_out == ch_out))
-			return &desc->channels[i];
-		i++;
-	}
+	i = iio_index_find(desc, IIO_INDEX_CHAN, dev - desc->devs, 0, ch_out,
+			   channel);
+	if (i < 0)
+		return NULL;
 
-	return NULL;
+	return &dev->dev_descriptor->channels[i];
+}
+
+/**
+ * @brief Find attribute by name.
+ * @param desc - IIO descriptor.
+ * @param dev - Device index. Triggers follow the devices.
+ * @param ch - Channel index or IIO_INDEX_NO_CH.
+ * @param type - Attribute type.
+ * @param name - Attribute name.
+ * @return Attribute pointer, or NULL if the attribute is not found.
+ */
+static struct iio_attribute *iio_find_attr(struct iio_desc *desc,
+		uint16_t dev, uint16_t ch, enum iio_attr_type type,
+		const char *name)
+{
+	int32_t i;
+
+	i = iio_index_find(desc, IIO_INDEX_ATTR, dev, ch, type, name);
+	if (i < 0)
+		return NULL;
+
+	return iio_index_attributes(desc, dev, ch, type) + i;
 }
 
 /**
@@ -310,14 +1000,13 @@ static inline struct iio_channel *iio_get_channel(const char *channel,
 static struct iio_dev_priv *get_iio_device(struct iio_desc *desc,
 		const char *device_name)
 {
-	uint32_t i;
+	int32_t i;
 
-	for (i = 0; i < desc->nb_devs; i++) {
-		if (strcmp(desc->devs[i].dev_id, device_name) == 0)
-			return &desc->devs[i];
-	}
+	i = iio_index_find(desc, IIO_INDEX_DEV, 0, 0, 0, device_name);
+	if (i < 0 || (uint32_t)i >= desc->nb_devs)
+		return NULL;
 
-	return NULL;
+	return &desc->devs[i];
 }
 
 /**
@@ -329,14 +1018,13 @@ static struct iio_dev_priv *get_iio_device(struct iio_desc *desc,
 static struct iio_trig_priv *get_iio_trig_device(struct iio_desc *desc,
 		const char *trigger_id)
 {
-	uint32_t i;
+	int32_t i;
 
-	for (i = 0; i < desc->nb_trigs; i++) {
-		if (strcmp(desc->trigs[i].id, trigger_id) == 0)
-			return &desc->trigs[i];
-	}
+	i = iio_index_find(desc, IIO_INDEX_DEV, 0, 0, 0, trigger_id);
+	if (i < 0 || (uint32_t)i < desc->nb_devs)
+		return NULL;
 
-	return NULL;
+	return &desc->trigs[i - desc->nb_devs];
 }
 
 /**
@@ -350,16 +1038,21 @@ static int iio_set_buffers_count(struct iiod_ctx *ctx, const char *device,
 				 uint32_t buffers_count)
 {
 	struct iio_desc *desc = ctx->instance;
+	struct iio_dev_priv *dev;
 
-	if (!get_iio_device(desc, device))
+	dev = get_iio_device(desc, device);
+	if (!dev)
 		return -ENODEV;
 
-	/* Our implementation uses a circular buffer to send/receive data so
-	 * only 1 is a valid value.
-	 */
-	if (buffers_count != 1)
+	if (!buffers_count)
 		return -EINVAL;
 
+	/*
+	 * Number of blocks of the queue allocated on the next open. When the
+	 * application provides raw_buf, its whole length is used instead.
+	 */
+	dev->buffer.nb_blocks = buffers_count;
+
 	return 0;
 }
 
@@ -457,42 +1150,31 @@ static int iio_write_all_attr(struct attr_fun_params *params,
 /**
  * @brief Read/write attribute.
  * @param params - Structure describing parameters for store and show functions
- * @param attributes - Array of attributes.
- * @param attr_name - Attribute name to be modified
+ * @param attribute - Attribute to be modified, as found by iio_find_attr.
  * @param is_write -If it has value "1", writes attribute, otherwise reads
  * 		attribute.
  * @return Length of chars written/read or negative value in case of error.
  */
 static int iio_rd_wr_attribute(struct attr_fun_params *params,
-			       struct iio_attribute *attributes,
-			       const char *attr_name,
+			       struct iio_attribute *attribute,
 			       bool is_write)
 {
-	int16_t i = 0;
-
-	/* Search attribute */
-	while (attributes[i].name) {
-		if (!strcmp(attr_name, attributes[i].name))
-			break;
-		i++;
-	}
-
-	if (!attributes[i].name)
+	if (!attribute)
 		return -ENOENT;
 
 	if (is_write) {
-		if (!attributes[i].store)
+		if (!attribute->store)
 			return -ENOENT;
 
-		return attributes[i].store(params->dev_instance, params->buf,
-					   params->len, params->ch_info,
-					   attributes[i].priv);
+		return attribute->store(params->dev_instance, params->buf,
+					params->len, params->ch_info,
+					attribute->priv);
 	} else {
-		if (!attributes[i].show)
+		if (!attribute->show)
 			return -ENOENT;
-		return attributes[i].show(params->dev_instance, params->buf,
-					  params->len, params->ch_info,
-					  attributes[i].priv);
+		return attribute->show(params->dev_instance, params->buf,
+				       params->len, params->ch_info,
+				       attribute->priv);
 	}
 }
 
@@ -729,47 +1411,78 @@ int iio_format_value(char *buf, uint32_t len, enum iio_val fmt,
 	}
 }
 
-static struct iio_attribute *get_attributes(enum iio_attr_type type,
-		struct iio_dev_priv *dev,
-		struct iio_channel *ch)
+/**
+ * @brief Get the names of objects referred by index in the context xml.
+ * @param ctx      - IIO instance and conn instance.
+ * @param dev      - Device index. Triggers follow the devices.
+ * @param chn      - Channel index. Used only for channel attributes.
+ * @param attr_idx - Attribute index or negative if only the device is needed.
+ * @param type     - Attribute type. Updated with the channel direction.
+ * @param device   - Device id to be filled.
+ * @param channel  - Channel id to be filled.
+ * @param attr     - Attribute name to be filled.
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int iio_get_names(struct iiod_ctx *ctx, uint32_t dev, uint32_t chn,
+			 int32_t attr_idx, enum iio_attr_type *type,
+			 char *device, char *channel, char *attr)
 {
-	switch (type) {
-	case IIO_ATTR_TYPE_DEBUG:
-		return dev->dev_descriptor->debug_attributes;
-		break;
-	case IIO_ATTR_TYPE_DEVICE:
-		return dev->dev_descriptor->attributes;
-		break;
-	case IIO_ATTR_TYPE_BUFFER:
-		return dev->dev_descriptor->buffer_attributes;
-		break;
-	case IIO_ATTR_TYPE_CH_IN:
-	case IIO_ATTR_TYPE_CH_OUT:
-		return ch->attributes;
+	struct iio_desc *desc = ctx->instance;
+	struct iio_attribute *attributes;
+	struct iio_channel *ch = NULL;
+	struct iio_dev_priv *ldev;
+	struct iio_trig_priv *trig;
+	int32_t i;
+
+	if (dev >= desc->nb_devs + desc->nb_trigs)
+		return -ENODEV;
+
+	if (dev >= desc->nb_devs) {
+		trig = &desc->trigs[dev - desc->nb_devs];
+		strcpy(device, trig->id);
+		if (attr_idx < 0)
+			return 0;
+
+		attributes = get_trig_attributes(*type, trig);
+	} else {
+		ldev = &desc->devs[dev];
+		strcpy(device, ldev->dev_id);
+		if (attr_idx < 0)
+			return 0;
+
+		if (*type == IIO_ATTR_TYPE_CH_IN || *type == IIO_ATTR_TYPE_CH_OUT) {
+			if (chn >= ldev->dev_descriptor->num_ch)
+				return -ENOENT;
+
+			ch = &ldev->dev_descriptor->channels[chn];
+			*type = ch->ch_out ? IIO_ATTR_TYPE_CH_OUT :
+				IIO_ATTR_TYPE_CH_IN;
+			_print_ch_id(channel, ch);
+		} else {
+			channel[0] = '\0';
+		}
+
+		attributes = get_attributes(*type, ldev, ch);
 	}
 
-	return NULL;
-}
+	for (i = 0; attributes && attributes[i].name; i++)
+		if (i == attr_idx) {
+			strncpy(attr, attributes[i].name, MAX_ATTR_NAME - 1);
+			attr[MAX_ATTR_NAME - 1] = '\0';
 
-/**
- * @brief Returns trigger attributes.
- * @param type - Attribute type.
- * @param trig - Trigger instance.
- * @return Attributes pointer if attributes exist, NULL otherwise.
- */
-static struct iio_attribute *get_trig_attributes(enum iio_attr_type type,
-		struct iio_trig_priv *trig)
-{
-	switch (type) {
-	/* Only device type attributes allowed for triggers */
-	case IIO_ATTR_TYPE_DEVICE:
-		return trig->descriptor->attributes;
-		break;
-	default:
-		break;
+			return 0;
+		}
+
+	/* The register access attribute is last in the debug attributes */
+	if (dev < desc->nb_devs && *type == IIO_ATTR_TYPE_DEBUG &&
+	    i == attr_idx && (ldev->dev_descriptor->debug_reg_read ||
+			      ldev->dev_descriptor->debug_reg_write)) {
+		strcpy(attr, REG_ACCESS_ATTRIBUTE);
+
+		return 0;
 	}
 
-	return NULL;
+	return -ENOENT;
 }
 
 /**
@@ -784,6 +1497,7 @@ static struct iio_attribute *get_trig_attributes(enum iio_attr_type type,
 static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 			 struct iiod_attr *attr, char *buf, uint32_t len)
 {
+	struct iio_desc *desc = ctx->instance;
 	struct iio_dev_priv *dev;
 	struct iio_trig_priv *trig_dev;
 	struct iio_ch_info ch_info;
@@ -805,7 +1519,7 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 
 		if (attr->channel[0] != '\0') {
 			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
-			ch = iio_get_channel(attr->channel, dev->dev_descriptor,
+			ch = iio_get_channel(ctx->instance, dev, attr->channel,
 					     ch_out);
 			if (!ch)
 				return -ENOENT;
@@ -822,10 +1536,14 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 		params.buf = buf;
 		params.len = len;
 		params.dev_instance = dev->dev_instance;
-		attributes = get_attributes(attr->type, dev, ch);
-		if (!strcmp(attr->name, ""))
+		if (!strcmp(attr->name, "")) {
+			attributes = get_attributes(attr->type, dev, ch);
 			return iio_read_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 0);
+		}
+		attributes = iio_find_attr(desc, dev - desc->devs,
+					   ch ? ch - dev->dev_descriptor->channels :
+					   IIO_INDEX_NO_CH, attr->type, attr->name);
+		return iio_rd_wr_attribute(&params, attributes, 0);
 	}
 
 	/* IIO device with given name is not found, verify if it corresponds to a trigger */
@@ -837,10 +1555,14 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 		params.buf = buf;
 		params.len = len;
 		params.dev_instance = trig_dev->instance;
-		attributes = get_trig_attributes(attr->type, trig_dev);
-		if (!strcmp(attr->name, ""))
+		if (!strcmp(attr->name, "")) {
+			attributes = get_trig_attributes(attr->type, trig_dev);
 			return iio_read_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 0);
+		}
+		attributes = iio_find_attr(desc,
+					   desc->nb_devs + (trig_dev - desc->trigs),
+					   IIO_INDEX_NO_CH, attr->type, attr->name);
+		return iio_rd_wr_attribute(&params, attributes, 0);
 	}
 
 	/* No device and no trigger with given name were found */
@@ -859,6 +1581,7 @@ static int iio_read_attr(struct iiod_ctx *ctx, const char *device,
 static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
 			  struct iiod_attr *attr, char *buf, uint32_t len)
 {
+	struct iio_desc		*desc = ctx->instance;
 	struct iio_dev_priv	*dev;
 	struct iio_trig_priv *trig_dev;
 	struct attr_fun_params	params;
@@ -881,7 +1604,7 @@ static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
 
 		if (attr->channel[0] != '\0') {
 			ch_out = attr->type == IIO_ATTR_TYPE_CH_OUT ? 1 : 0;
-			ch = iio_get_channel(attr->channel, dev->dev_descriptor,
+			ch = iio_get_channel(ctx->instance, dev, attr->channel,
 					     ch_out);
 			if (!ch)
 				return -ENOENT;
@@ -899,10 +1622,14 @@ static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
 		params.buf = (char *)buf;
 		params.len = len;
 		params.dev_instance = dev->dev_instance;
-		attributes = get_attributes(attr->type, dev, ch);
-		if (!strcmp(attr->name, ""))
+		if (!strcmp(attr->name, "")) {
+			attributes = get_attributes(attr->type, dev, ch);
 			return iio_write_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 1);
+		}
+		attributes = iio_find_attr(desc, dev - desc->devs,
+					   ch ? ch - dev->dev_descriptor->channels :
+					   IIO_INDEX_NO_CH, attr->type, attr->name);
+		return iio_rd_wr_attribute(&params, attributes, 1);
 	}
 
 	/* IIO device with given name is not found, verify if it corresponds to a trigger */
@@ -914,10 +1641,14 @@ static int iio_write_attr(struct iiod_ctx *ctx, const char *device,
 		params.buf = (char *)buf;
 		params.len = len;
 		params.dev_instance = trig_dev->instance;
-		attributes = get_trig_attributes(attr->type, trig_dev);
-		if (!strcmp(attr->name, ""))
+		if (!strcmp(attr->name, "")) {
+			attributes = get_trig_attributes(attr->type, trig_dev);
 			return iio_read_all_attr(&params, attributes);
-		return iio_rd_wr_attribute(&params, attributes, attr->name, 1);
+		}
+		attributes = iio_find_attr(desc,
+					   desc->nb_devs + (trig_dev - desc->trigs),
+					   IIO_INDEX_NO_CH, attr->type, attr->name);
+		return iio_rd_wr_attribute(&params, attributes, 1);
 	}
 
 	/* No device and no trigger with given name were found */
@@ -1062,7 +1793,9 @@ static void iio_process_async_triggers(struct iio_desc *desc)
 			continue;
 
 		if (dev->dev_descriptor->trigger_handler) {
+			no_os_mutex_lock(dev->lock);
 			dev->dev_descriptor->trigger_handler(&dev->dev_data);
+			no_os_mutex_unlock(dev->lock);
 			desc->trigs[i].triggered = 0;
 		}
 	}
@@ -1098,6 +1831,9 @@ int iio_process_trigger_type(struct iio_desc *desc, char *trigger_name)
 					dev->dev_descriptor->trigger_handler(&dev->dev_data);
 			} else {
 				trig->triggered = 1;
+#ifdef LINUX_PLATFORM
+				iio_wakeup(desc);
+#endif
 			}
 		}
 	}
@@ -1105,27 +1841,22 @@ int iio_process_trigger_type(struct iio_desc *desc, char *trigger_name)
 	return 0;
 }
 
-static uint32_t bytes_per_scan(struct iio_channel *channels, uint32_t mask)
+static uint32_t bytes_per_scan(struct iio_channel *channels,
+			       const uint32_t *mask, uint32_t nb_ch)
 {
 	uint32_t cnt, i, length, largest = 1;
 
 	cnt = 0;
-	i = 0;
-	while (mask) {
-		if ((mask & 1)) {
-			length = channels[i].scan_type->storagebits / 8;
+	no_os_for_each_set_bit(i, mask, nb_ch) {
+		length = channels[i].scan_type->storagebits / 8;
 
-			if (length > largest)
-				largest = length;
+		if (length > largest)
+			largest = length;
 
-			if (cnt % length)
-				cnt += 2 * length - (cnt % length);
-			else
-				cnt += length;
-		}
-
-		mask >>= 1;
-		++i;
+		if (cnt % length)
+			cnt += 2 * length - (cnt % length);
+		else
+			cnt += length;
 	}
 
 	if (cnt % largest)
@@ -1134,21 +1865,183 @@ static uint32_t bytes_per_scan(struct iio_channel *channels, uint32_t mask)
 	return cnt;
 }
 
+/**
+ * @brief Get the channel count of a device and the scan size of a mask.
+ * @param ctx         - IIO instance and conn instance.
+ * @param dev         - Device index.
+ * @param mask        - Bitmap of channels or NULL for the channel count only.
+ * @param mask_words  - Number of words in mask.
+ * @param nb_ch       - Filled with the number of channels of the device.
+ * @param sample_size - Filled with the size in bytes of a scan.
+ * @param output      - Filled with the direction of the channels in mask.
+ * @return 0 in case of success, negative value otherwise.
+ */
+static int iio_get_buffer_info(struct iiod_ctx *ctx, uint32_t dev,
+			       const uint32_t *mask, uint32_t mask_words,
+			       uint32_t *nb_ch, uint32_t *sample_size,
+			       bool *output)
+{
+	struct iio_desc *desc = ctx->instance;
+	uint32_t scan_mask[IIOD_MASK_WORDS] = {0};
+	struct iio_device *dev_descriptor;
+	uint32_t nb, first;
+
+	if (dev >= desc->nb_devs)
+		return -ENODEV;
+
+	dev_descriptor = desc->devs[dev].dev_descriptor;
+	*nb_ch = dev_descriptor->num_ch;
+	if (!mask)
+		return 0;
+
+	/* Keep only the bits of existing channels */
+	nb = no_os_min(*nb_ch, IIOD_MAX_MASK_CHANNELS);
+	memcpy(scan_mask, mask, no_os_min(mask_words, NO_OS_BITS_TO_WORDS(nb)) *
+	       sizeof(*mask));
+	if (nb % 32)
+		scan_mask[nb / 32] &= 0xFFFFFFFF >> (32 - nb % 32);
+	first = no_os_find_next_set_bit(scan_mask, nb, 0);
+	if (first == nb)
+		return -ENOENT;
+
+	*output = dev_descriptor->channels[first].ch_out;
+	*sample_size = bytes_per_scan(dev_descriptor->channels, scan_mask, nb);
+
+	return 0;
+}
+
+/* Free the memory allocated by iio_open_dev for the buffer data */
+static void iio_buffer_free(struct iio_buffer_priv *buf)
+{
+	no_os_free(buf->alloc_buf);
+	buf->alloc_buf = NULL;
+	buf->alloc_len = 0;
+
+	if (buf->scans) {
+		no_os_spsc_ring_remove(buf->scans);
+		buf->scans = NULL;
+	}
+
+	if (buf->spare_scans) {
+		no_os_spsc_ring_remove(buf->spare_scans);
+		buf->spare_scans = NULL;
+	}
+}
+
+/*
+ * Stop using the memory of the buffer data. With IIO_REUSE_BUFFERS it stays
+ * allocated until iio_remove, so a client reopening the buffer with the same
+ * parameters doesn't allocate again. Otherwise it is freed.
+ */
+static void iio_buffer_release(struct iio_buffer_priv *buf)
+{
+#ifdef IIO_REUSE_BUFFERS
+	if (buf->scans) {
+		buf->spare_scans = buf->scans;
+		buf->scans = NULL;
+	}
+#else
+	iio_buffer_free(buf);
+#endif
+}
+
+/*
+ * Release in cb the blocks marked done by iio_buffer_block_done. Input blocks
+ * become available to be read by the client. Output blocks are freed, unless
+ * the buffer is cyclic in which case they are handed out again.
+ */
+static void iio_buffer_release_blocks(struct iio_buffer_priv *buf)
+{
+	struct no_os_cb_ptr *ptr;
+	uint32_t done;
+
+	done = __atomic_exchange_n(&buf->done, 0, __ATOMIC_ACQUIRE);
+	buf->pending -= done;
+	if (buf->public.dir == IIO_DIRECTION_OUTPUT &&
+	    buf->public.cyclic_info.is_cyclic)
+		return;
+
+	ptr = buf->public.dir == IIO_DIRECTION_INPUT ? &buf->cb.write :
+	      &buf->cb.read;
+	for (; done; done--) {
+		ptr->idx += buf->public.size;
+		if (ptr->idx >= buf->cb.size) {
+			ptr->idx -= buf->cb.size;
+			ptr->spin_count++;
+		}
+	}
+}
+
+/* Wake up iiod if it waits for data to be pushed in the buffer */
+static void iio_buffer_notify(struct iio_buffer_priv *buf)
+{
+#ifdef LINUX_PLATFORM
+	if (buf->desc &&
+	    __atomic_exchange_n(&buf->waiting, false, __ATOMIC_SEQ_CST))
+		iio_wakeup(buf->desc);
+#endif
+}
+
+/*
+ * Move the scans pushed by the device to cb or, for output buffers, queue the
+ * data written by the client in cb for the device to pop. Cyclic data is
+ * queued again until the ring is full.
+ */
+static void iio_buffer_sync(struct iio_buffer_priv *buf)
+{
+	uint32_t size;
+	uint32_t len;
+	void *addr;
+
+	iio_buffer_release_blocks(buf);
+	if (!buf->scans)
+		return;
+
+	if (buf->public.dir == IIO_DIRECTION_INPUT) {
+		while (!no_os_spsc_ring_peek(buf->scans, buf->scans->size, &addr,
+					     &len)) {
+			no_os_cb_write(&buf->cb, addr, len);
+			no_os_spsc_ring_consume(buf->scans, len);
+		}
+
+		return;
+	}
+
+	while (true) {
+		no_os_cb_size(&buf->cb, &size);
+		if (!size)
+			return;
+
+		if (no_os_spsc_ring_reserve(buf->scans, size, &addr, &len))
+			return;
+
+		no_os_cb_read(&buf->cb, addr, len);
+		no_os_spsc_ring_commit(buf->scans, len);
+		if (buf->public.cyclic_info.is_cyclic &&
+		    buf->cb.read.idx == buf->cb.write.idx)
+			buf->cb.read.idx = 0;
+	}
+}
+
 /**
  * @brief  Open device.
  * @param ctx - IIO instance and conn instance
  * @param device - String containing device name.
  * @param sample_size - Sample size.
- * @param mask - Channels to be opened.
+ * @param mask - Bitmap of channels to be opened.
+ * @param mask_words - Number of words in mask.
  * @return 0, negative value in case of failure.
  */
 static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
-			uint32_t samples, uint32_t mask, bool cyclic)
+			uint32_t samples, const uint32_t *mask,
+			uint32_t mask_words, bool cyclic)
 {
 	struct iio_desc *desc;
 	struct iio_dev_priv *dev;
 	struct iio_trig_priv *trig;
-	uint32_t ch_mask;
+	struct no_os_spsc_ring *scans;
+	uint32_t *scan_mask;
+	uint32_t nb_ch;
 	int32_t ret;
 	int8_t *buf;
 	uint32_t buf_size;
@@ -1160,19 +2053,29 @@ static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
 	if (!dev->buffer.initalized)
 		return -EINVAL;
 
-	ch_mask = 0xFFFFFFFF >> (32 - dev->dev_descriptor->num_ch);
-	mask &= ch_mask;
-	if (!mask)
+	/* Keep only the bits of existing channels */
+	nb_ch = dev->dev_descriptor->num_ch;
+	scan_mask = dev->buffer.public.scan_mask;
+	memset(scan_mask, 0, NO_OS_BITS_TO_WORDS(nb_ch) * sizeof(*scan_mask));
+	memcpy(scan_mask, mask, no_os_min(mask_words,
+					  NO_OS_BITS_TO_WORDS(nb_ch)) * sizeof(*mask));
+	if (nb_ch % 32)
+		scan_mask[nb_ch / 32] &= 0xFFFFFFFF >> (32 - nb_ch % 32);
+	if (no_os_find_next_set_bit(scan_mask, nb_ch, 0) == nb_ch)
 		return -ENOENT;
 
 	dev->buffer.public.cyclic_info.is_cyclic = cyclic;
 	dev->buffer.public.cyclic_info.buff_index = 0;
 
-	dev->buffer.public.active_mask = mask;
+	dev->buffer.public.active_mask = scan_mask[0];
 	dev->buffer.public.bytes_per_scan =
-		bytes_per_scan(dev->dev_descriptor->channels, mask);
+		bytes_per_scan(dev->dev_descriptor->channels, scan_mask, nb_ch);
 	dev->buffer.public.size = dev->buffer.public.bytes_per_scan * samples;
 	dev->buffer.public.samples = samples;
+	dev->buffer.pending = 0;
+	dev->buffer.done = 0;
+	/* Release in case iio_close_dev wasn't called */
+	iio_buffer_release(&dev->buffer);
 	if (dev->buffer.raw_buf && dev->buffer.raw_buf_len) {
 		if (dev->buffer.raw_buf_len < dev->buffer.public.size)
 			/* Need a bigger buffer or to allocate */
@@ -1181,35 +2084,55 @@ static int iio_open_dev(struct iiod_ctx *ctx, const char *device,
 						      dev->buffer.public.size);
 		buf = dev->buffer.raw_buf;
 	} else {
-		if (dev->buffer.allocated) {
-			/* Free in case iio_close_dev wasn't called to free it*/
-			no_os_free(dev->buffer.cb.buff);
-			dev->buffer.allocated = 0;
+		buf_size = dev->buffer.public.size *
+			   no_os_max(dev->buffer.nb_blocks, 1);
+		if (dev->buffer.alloc_len < buf_size) {
+			no_os_free(dev->buffer.alloc_buf);
+			dev->buffer.alloc_len = 0;
+			dev->buffer.alloc_buf = (int8_t *)no_os_calloc(buf_size,
+						sizeof(*buf));
+			if (!dev->buffer.alloc_buf)
+				return -ENOMEM;
+			dev->buffer.alloc_len = buf_size;
+		} else {
+			memset(dev->buffer.alloc_buf, 0, buf_size);
 		}
-		buf_size = dev->buffer.public.size;
-		buf = (int8_t *)no_os_calloc(dev->buffer.public.size, sizeof(*buf));
-		if (!buf)
-			return -ENOMEM;
-		dev->buffer.allocated = 1;
+		buf = dev->buffer.alloc_buf;
 	}
 
+	dev->buffer.public.nb_blocks = buf_size / dev->buffer.public.size;
 	ret = no_os_cb_cfg(&dev->buffer.cb, buf, buf_size);
-	if (NO_OS_IS_ERR_VALUE(ret)) {
-		if (dev->buffer.allocated) {
-			no_os_free(dev->buffer.cb.buff);
-			dev->buffer.allocated = 0;
-		}
-
+	if (NO_OS_IS_ERR_VALUE(ret))
 		return ret;
+
+	if (dev->dev_descriptor->trigger_handler) {
+		/* Room for one block of scans */
+		for (buf_size = 1; buf_size < dev->buffer.public.size;)
+			buf_size <<= 1;
+		scans = dev->buffer.spare_scans;
+		dev->buffer.spare_scans = NULL;
+		if (scans && scans->size == buf_size) {
+			scans->head = 0;
+			scans->tail = 0;
+		} else {
+			no_os_spsc_ring_remove(scans);
+			ret = no_os_spsc_ring_init(&scans, buf_size);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+		}
+		dev->buffer.scans = scans;
 	}
 
-	if (dev->dev_descriptor->pre_enable) {
-		ret = dev->dev_descriptor->pre_enable(dev->dev_instance, mask);
+	if (dev->dev_descriptor->pre_enable_scan)
+		ret = dev->dev_descriptor->pre_enable_scan(dev->dev_instance,
+				scan_mask, nb_ch);
+	else if (dev->dev_descriptor->pre_enable)
+		ret = dev->dev_descriptor->pre_enable(dev->dev_instance,
+						      scan_mask[0]);
+	if (dev->dev_descriptor->pre_enable_scan ||
+	    dev->dev_descriptor->pre_enable) {
 		if (NO_OS_IS_ERR_VALUE(ret)) {
-			if (dev->buffer.allocated) {
-				no_os_free(dev->buffer.cb.buff);
-				dev->buffer.allocated = 0;
-			}
+			iio_buffer_release(&dev->buffer);
 			return ret;
 		}
 	}
@@ -1244,11 +2167,7 @@ static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
 	if (!dev->buffer.initalized)
 		return -EINVAL;
 
-	if (dev->buffer.allocated) {
-		/* Should something else be used to free internal strucutre */
-		no_os_free(dev->buffer.cb.buff);
-		dev->buffer.allocated = 0;
-	}
+	iio_buffer_release(&dev->buffer);
 
 	desc = ctx->instance;
 	if (dev->trig_idx != NO_TRIGGER) {
@@ -1261,6 +2180,9 @@ static int iio_close_dev(struct iiod_ctx *ctx, const char *device)
 	}
 
 	dev->buffer.public.active_mask = 0;
+	memset(dev->buffer.public.scan_mask, 0,
+	       NO_OS_BITS_TO_WORDS(dev->dev_descriptor->num_ch) *
+	       sizeof(*dev->buffer.public.scan_mask));
 	if (dev->dev_descriptor->post_disable)
 		ret = dev->dev_descriptor->post_disable(dev->dev_instance);
 
@@ -1277,6 +2199,9 @@ static int iio_call_submit(struct iiod_ctx *ctx, const char *device,
 		return -EINVAL;
 
 	dev->buffer.public.dir = dir;
+	if (dir == IIO_DIRECTION_OUTPUT)
+		iio_buffer_sync(&dev->buffer);
+
 	if (dev->dev_descriptor->submit && dev->trig_idx == NO_TRIGGER)
 		return dev->dev_descriptor->submit(&dev->dev_data);
 	else if ((dir == IIO_DIRECTION_INPUT && dev->dev_descriptor->read_dev
@@ -1314,7 +2239,25 @@ static int iio_push_buffer(struct iiod_ctx *ctx, const char *device)
 
 static int iio_refill_buffer(struct iiod_ctx *ctx, const char *device)
 {
-	return iio_call_submit(ctx, device, IIO_DIRECTION_INPUT);
+	struct iio_dev_priv *dev;
+	uint32_t size;
+	int ret;
+
+	ret = iio_call_submit(ctx, device, IIO_DIRECTION_INPUT);
+	if (ret && ret != -EAGAIN)
+		return ret;
+
+	dev = get_iio_device(ctx->instance, device);
+	iio_buffer_sync(&dev->buffer);
+	if (!ret)
+		return 0;
+
+	/* No free block to fill but there is data queued for the client */
+	ret = no_os_cb_size(&dev->buffer.cb, &size);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return size ? 0 : -EAGAIN;
 }
 
 /**
@@ -1337,7 +2280,19 @@ static int iio_read_buffer(struct iiod_ctx *ctx, const char *device, char *buf,
 	if (!dev || !dev->buffer.initalized)
 		return -EINVAL;
 
+	iio_buffer_sync(&dev->buffer);
 	ret = no_os_cb_size(&dev->buffer.cb, &size);
+#ifdef LINUX_PLATFORM
+	if (!ret && !size) {
+		/*
+		 * Ask the producer to wake up iiod, then look again for data
+		 * pushed before the request could be seen.
+		 */
+		__atomic_store_n(&dev->buffer.waiting, true, __ATOMIC_SEQ_CST);
+		iio_buffer_sync(&dev->buffer);
+		ret = no_os_cb_size(&dev->buffer.cb, &size);
+	}
+#endif
 #ifdef IIO_IGNORE_BUFF_OVERRUN_ERR
 #warning Buffer overrun error checking is disabled.
 	if (ret != -NO_OS_EOVERRUN)
@@ -1381,11 +2336,12 @@ static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
 	if (!dev || !dev->buffer.initalized)
 		return -EINVAL;
 
+	iio_buffer_release_blocks(&dev->buffer);
 	ret = no_os_cb_size(&dev->buffer.cb, &size);
 	if (NO_OS_IS_ERR_VALUE(ret))
 		return ret;
 
-	available = dev->buffer.public.size - size;
+	available = dev->buffer.cb.size - size;
 	bytes = no_os_min(available, bytes);
 	ret = no_os_cb_write(&dev->buffer.cb, buf, bytes);
 	if (NO_OS_IS_ERR_VALUE(ret))
@@ -1394,47 +2350,121 @@ static int iio_write_buffer(struct iiod_ctx *ctx, const char *device,
 	return bytes;
 }
 
+/**
+ * @brief Get the next block of the buffer queue.
+ *
+ * For input buffers this is the next free block to be filled by the device.
+ * For output buffers it is the next block written by the client.
+ * Several blocks can be held at the same time (e.g. queued DMA transfers)
+ * and they must be released in order with iio_buffer_block_done.
+ * @param buffer - IIO buffer.
+ * @param addr - Address of the block of iio_buffer.size bytes.
+ * @return 0 in case of success, -EAGAIN if no block is available or
+ * negative value otherwise.
+ */
 int iio_buffer_get_block(struct iio_buffer *buffer, void **addr)
 {
+	struct iio_buffer_priv *priv;
 	uint32_t size;
+	uint32_t idx;
+	int ret;
 
-	if (!buffer)
+	if (!buffer || !addr || !buffer->size)
 		return -EINVAL;
 
-	if (buffer->dir == IIO_DIRECTION_INPUT)
-		return no_os_cb_prepare_async_write(buffer->buf, buffer->size, addr, &size);
+	priv = _to_buffer_priv(buffer);
+	iio_buffer_release_blocks(priv);
+	ret = no_os_cb_size(buffer->buf, &size);
+	if (NO_OS_IS_ERR_VALUE(ret) && ret != -NO_OS_EOVERRUN)
+		return ret;
+
+	if (buffer->dir == IIO_DIRECTION_INPUT) {
+		/* A partially read block is still owned by the client */
+		if (NO_OS_DIV_ROUND_UP(size, buffer->size) + priv->pending >=
+		    buffer->nb_blocks)
+			return -EAGAIN;
+		idx = buffer->buf->write.idx;
+	} else {
+		if (size / buffer->size <= priv->pending)
+			return -EAGAIN;
+		idx = buffer->buf->read.idx;
+	}
 
-	return no_os_cb_prepare_async_read(buffer->buf, buffer->size, addr, &size);
+	idx = (idx + priv->pending * buffer->size) % buffer->buf->size;
+	*addr = buffer->buf->buff + idx;
+	priv->pending++;
+
+	return 0;
 }
 
+/**
+ * @brief Release the oldest block obtained with iio_buffer_get_block.
+ *
+ * Input blocks become available to be read by the client. Output blocks are
+ * freed, unless the buffer is cyclic in which case they are handed out again.
+ * Can be called from interrupt context (e.g. on DMA completion): the block is
+ * only counted here and released in the buffer queue by iiod.
+ * @param buffer - IIO buffer.
+ * @return 0 in case of success, negative value otherwise.
+ */
 int iio_buffer_block_done(struct iio_buffer *buffer)
 {
+	struct iio_buffer_priv *priv;
+	uint32_t done;
+
 	if (!buffer)
 		return -EINVAL;
 
+	priv = _to_buffer_priv(buffer);
+	done = __atomic_load_n(&priv->done, __ATOMIC_RELAXED);
+	do {
+		if (done >= __atomic_load_n(&priv->pending, __ATOMIC_RELAXED))
+			return -EINVAL;
+	} while (!__atomic_compare_exchange_n(&priv->done, &done, done + 1,
+					      false, __ATOMIC_RELEASE,
+					      __ATOMIC_RELAXED));
+
 	if (buffer->dir == IIO_DIRECTION_INPUT)
-		return no_os_cb_end_async_write(buffer->buf);
+		iio_buffer_notify(priv);
 
-	return no_os_cb_end_async_read(buffer->buf);
+	return 0;
 }
 
 /* Write to buffer iio_buffer.bytes_per_scan bytes from data */
 int iio_buffer_push_scan(struct iio_buffer *buffer, void *data)
 {
+	struct iio_buffer_priv *priv;
+	int ret;
+
 	if (!buffer)
 		return -EINVAL;
 
-	return no_os_cb_write(buffer->buf, data, buffer->bytes_per_scan);
+	priv = _to_buffer_priv(buffer);
+	if (!priv->scans)
+		return no_os_cb_write(buffer->buf, data, buffer->bytes_per_scan);
+
+	ret = no_os_spsc_ring_write(priv->scans, data, buffer->bytes_per_scan);
+	if (!NO_OS_IS_ERR_VALUE(ret))
+		iio_buffer_notify(priv);
+
+	return ret;
 }
 
 /* Read from buffer iio_buffer.bytes_per_scan bytes into data */
 int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data)
 {
+	struct iio_buffer_priv *priv;
+
 	if (!buffer)
 		return -EINVAL;
 
 	int ret;
 
+	priv = _to_buffer_priv(buffer);
+	if (priv->scans)
+		return no_os_spsc_ring_read(priv->scans, data,
+					    buffer->bytes_per_scan);
+
 	ret = no_os_cb_read(buffer->buf, data, buffer->bytes_per_scan);
 
 	if (buffer->cyclic_info.is_cyclic) {
@@ -1468,11 +2498,13 @@ static int32_t accept_network_clients(struct iio_desc *desc)
 			goto close_socket;
 		}
 
+		no_os_mutex_lock(desc->conns_lock);
 		ret = iiod_conn_add(desc->iiod, &data, &id);
+		no_os_mutex_unlock(desc->conns_lock);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto free_buf;
 
-		ret = _push_conn(desc, id);
+		ret = _add_conn(desc, id, _sock_fd(sock));
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto remove_conn;
 	} while (true);
@@ -1480,7 +2512,9 @@ static int32_t accept_network_clients(struct iio_desc *desc)
 	return 0;
 
 remove_conn:
+	no_os_mutex_lock(desc->conns_lock);
 	iiod_conn_remove(desc->iiod, id, &data);
+	no_os_mutex_unlock(desc->conns_lock);
 free_buf:
 	no_os_free(data.buf);
 close_socket:
@@ -1497,7 +2531,6 @@ close_socket:
  */
 int iio_step(struct iio_desc *desc)
 {
-	struct iiod_conn_data data;
 	uint32_t conn_id;
 	int32_t ret;
 
@@ -1519,222 +2552,346 @@ int iio_step(struct iio_desc *desc)
 		return ret;
 
 	ret = iiod_conn_step(desc->iiod, conn_id);
-	if (ret == -ENOTCONN) {
-#if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
-		iiod_conn_remove(desc->iiod, conn_id, &data);
-		socket_remove(data.conn);
-		no_os_free(data.buf);
+	if (ret == -ENOTCONN)
+		_remove_conn(desc, conn_id);
+	else
+		_push_conn(desc, conn_id);
+
+	return ret;
+}
+
+#ifdef LINUX_PLATFORM
+/**
+ * @brief Event driven version of iio_step.
+ *
+ * Sleeps until a client connects, a connection receives data or iio_wakeup
+ * is called, then steps only the connections that have something to do.
+ * Connections in the middle of a command don't wait for data, so they keep
+ * being stepped without sleeping. Buffer transfers waiting for device data
+ * sleep until the producer of the data calls iio_wakeup, which is done by
+ * iio_buffer_push_scan and iio_buffer_block_done.
+ * @param desc       - IIO descriptor
+ * @param timeout_ms - Maximum time to sleep. -1 to sleep until an event.
+ * @return 0 in case of success or negative value otherwise.
+ */
+int iio_step_wait(struct iio_desc *desc, int32_t timeout_ms)
+{
+	struct epoll_event events[IIO_MAX_EVENTS];
+	uint32_t conn_id;
+	int32_t ret, i, n;
+	uint64_t cnt;
+
+	for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+		if (desc->conn_ready[i])
+			timeout_ms = 0;
+
+	n = epoll_wait(desc->epoll_fd, events, IIO_MAX_EVENTS, timeout_ms);
+	if (n < 0)
+		return errno == EINTR ? -EAGAIN : -errno;
+
+	for (i = 0; i < n; i++) {
+		switch (events[i].data.u32) {
+		case IIO_EVENT_WAKE:
+			if (read(desc->wake_fd, &cnt, sizeof(cnt)) < 0)
+				return -errno;
+			/* Transfers waiting for device data may advance */
+			for (conn_id = 0; conn_id < IIOD_MAX_CONNECTIONS;
+			     conn_id++)
+				if (desc->conn_fd[conn_id] >= 0)
+					desc->conn_ready[conn_id] = true;
+			break;
+#if defined(NO_OS_NETWORKING)
+		case IIO_EVENT_SERVER:
+			ret = accept_network_clients(desc);
+			if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
+				return ret;
+			break;
 #endif
-	} else {
+		default:
+			desc->conn_ready[events[i].data.u32] = true;
+			break;
+		}
+	}
+
+	iio_process_async_triggers(desc);
+
+	ret = 0;
+	n = _nb_active_conns(desc);
+	while (n--) {
+		_pop_conn(desc, &conn_id);
+		if (!desc->conn_ready[conn_id]) {
+			_push_conn(desc, conn_id);
+			continue;
+		}
+
+		ret = iiod_conn_step(desc->iiod, conn_id);
+		if (ret == -ENOTCONN) {
+			_remove_conn(desc, conn_id);
+			continue;
+		}
+
 		_push_conn(desc, conn_id);
+		desc->conn_ready[conn_id] = desc->conn_fd[conn_id] < 0 ||
+					    !iiod_conn_is_idle(desc->iiod, conn_id);
+		if (NO_OS_IS_ERR_VALUE(ret) && ret != -EAGAIN)
+			return ret;
 	}
 
 	return ret;
 }
 
 /**
- * @brief Add context attributes into xml string buffer.
- * @param desc - IIo descriptor.
- * @param buff - xml buffer.
- * @param buff_size - size of buffer
+ * @brief Wake up iio_step_wait and the connections waiting for device data.
+ * Can be called from interrupt context.
+ * @param desc - IIO descriptor
  * @return 0 in case of success or negative value otherwise.
  */
-static uint32_t iio_add_ctx_attr_in_xml(struct iio_desc *desc, char *buff,
-					uint32_t buff_size)
+int iio_wakeup(struct iio_desc *desc)
 {
-	struct iio_ctx_attr *attr;
-	char dummy_buff[50];
-	int32_t i;
-	int32_t j;
-	int32_t n;
+	uint64_t cnt = 1;
+	uint32_t i;
 
-	if ((int32_t)buff_size == -1)
-		n = 0;
-	else
-		n = buff_size;
-
-	if (buff == NULL)
-		/* Set dummy value for buff. It is used only for counting */
-		buff = dummy_buff;
-
-	i = 0;
-
-	attr = desc->ctx_attrs;
-	if (attr)
-		for (j = 0; j < (int32_t)desc->nb_ctx_attr; j++) {
-			i += snprintf(buff + i,
-				      no_os_max(n - i, 0),
-				      "<context-attribute name=\"%s\" ",
-				      attr[j].name);
-
-			i += snprintf(buff + i,
-				      no_os_max(n - i, 0),
-				      "value=\"%s\" />",
-				      attr[j].value);
+	if (desc->threaded)
+		for (i = 0; i < IIOD_MAX_CONNECTIONS; i++)
+			if (write(desc->workers[i].wake_fd, &cnt,
+				  sizeof(cnt)) < 0)
+				return -errno;
+
+	if (write(desc->wake_fd, &cnt, sizeof(cnt)) < 0)
+		return -errno;
+
+	return 0;
+}
+#endif
+
+/*
+ * Writes the context xml, or just counts its size when buf is NULL.
+ * Only the bytes falling in the window [start, start + len) of the xml are
+ * stored in buf, so it can be generated in chunks.
+ */
+struct iio_xml_writer {
+	char		*buf;
+	uint32_t	start;
+	uint32_t	len;
+	/* Offset in the xml of the next byte to be written */
+	uint32_t	pos;
+	int32_t		err;
+};
+
+static void iio_xml_write(struct iio_xml_writer *w, const char *str,
+			  uint32_t len)
+{
+	uint32_t from, to;
+
+	if (w->buf) {
+		from = no_os_max(w->pos, w->start);
+		to = no_os_min(w->pos + len, w->start + w->len);
+		if (from < to)
+			memcpy(w->buf + from - w->start, str + from - w->pos,
+			       to - from);
+	}
+
+	w->pos += len;
+}
+
+static void iio_xml_printf(struct iio_xml_writer *w, const char *fmt, ...)
+{
+	char tmp[IIO_XML_FRAGMENT_SIZE];
+	char *frag = tmp;
+	va_list args;
+	int len;
+
+	/* Nothing more to store in the window */
+	if (w->buf && w->pos >= w->start + w->len)
+		return;
+
+	va_start(args, fmt);
+	len = vsnprintf(tmp, sizeof(tmp), fmt, args);
+	va_end(args);
+	if (len < 0) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	if (w->buf && len >= (int)sizeof(tmp) &&
+	    w->pos + len > w->start) {
+		frag = no_os_malloc(len + 1);
+		if (!frag) {
+			w->err = -ENOMEM;
+			return;
 		}
 
-	return i;
+		va_start(args, fmt);
+		vsnprintf(frag, len + 1, fmt, args);
+		va_end(args);
+	}
+
+	iio_xml_write(w, frag, len);
+
+	if (frag != tmp)
+		no_os_free(frag);
+}
+
+/* Number of attributes in a NULL terminated list */
+static uint32_t iio_xml_nb_attrs(struct iio_attribute *attrs)
+{
+	uint32_t n = 0;
+
+	if (attrs)
+		while (attrs[n].name)
+			n++;
+
+	return n;
 }
 
 /*
- * Generate an xml describing a device and write it to buff.
- * Will return the size of the xml.
- * If buff_size is 0, no data will be written to buff, but size will be returned
+ * The xml of a device is made of pieces that can be generated separately:
+ * the opening tag, one piece for each channel, device attribute and debug
+ * attribute and the closing piece with the buffer element.
  */
-static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
-					char *id, char *buff,
-					uint32_t buff_size)
+static uint32_t iio_xml_device_nb_pieces(struct iio_device *device)
+{
+	return 2 + (device->channels ? device->num_ch : 0) +
+	       iio_xml_nb_attrs(device->attributes) +
+	       iio_xml_nb_attrs(device->debug_attributes);
+}
+
+/* Write piece k of the xml describing a device */
+static int32_t iio_generate_device_xml(struct iio_xml_writer *w,
+				       struct iio_device *device, char *name,
+				       char *id, uint32_t k)
 {
 	struct iio_channel	*ch;
 	struct iio_attribute	*attr;
 	char			ch_id[50];
-	int32_t			i;
+	uint32_t		nb;
 	int32_t			j;
-	int32_t			k;
-	int32_t			n;
 
-	if ((int32_t)buff_size == -1)
-		n = 0;
-	else
-		n = buff_size;
-
-	if (buff == NULL)
-		/* Set dummy value for buff. It is used only for counting */
-		buff = ch_id;
-
-	i = 0;
-
-	i += snprintf(buff + i, no_os_max(n - i, 0),
-		      "<device id=\"%s\" name=\"%s\">", id, name);
-
-	/* Write channels */
-	if (device->channels)
-		for (j = 0; j < device->num_ch; j++) {
-			ch = &device->channels[j];
-			_print_ch_id(ch_id, ch);
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<channel id=\"%s\"",
-				      ch_id);
-			if (ch->name)
-				i += snprintf(buff + i, no_os_max(n - i, 0),
-					      " name=\"%s\"",
-					      ch->name);
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      " type=\"%s\" >",
-				      ch->ch_out ? "output" : "input");
-
-			if (ch->scan_type)
-				i += snprintf(buff + i, no_os_max(n - i, 0),
-					      "<scan-element index=\"%d\""
-					      " format=\"%s:%c%d/%d>>%d\" />",
-					      ch->scan_index,
-					      ch->scan_type->is_big_endian ? "be" : "le",
-					      ch->scan_type->sign,
-					      ch->scan_type->realbits,
-					      ch->scan_type->storagebits,
-					      ch->scan_type->shift);
-
-			/* Write channel attributes */
-			if (ch->attributes)
-				for (k = 0; ch->attributes[k].name; k++) {
-					attr = &ch->attributes[k];
-					i += snprintf(buff + i, no_os_max(n - i, 0), "<attribute name=\"%s\" ",
-						      attr->name);
-					if (ch->diferential) {
-						switch (attr->shared) {
-						case IIO_SHARED_BY_ALL:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s\"",
-								      attr->name);
-							break;
-						case IIO_SHARED_BY_DIR:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s\"",
-								      ch->ch_out ? "out" : "in",
-								      attr->name);
-							break;
-						case IIO_SHARED_BY_TYPE:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s-%s_%s\"",
-								      ch->ch_out ? "out" : "in",
-								      iio_chan_type_string[ch->ch_type],
-								      iio_chan_type_string[ch->ch_type],
-								      attr->name);
-							break;
-						case IIO_SEPARATE:
-							if (!ch->indexed) {
-								// Differential channels must be indexed!
-								return -EINVAL;
-							}
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s%d-%s%d_%s\"",
-								      ch->ch_out ? "out" : "in",
-								      iio_chan_type_string[ch->ch_type],
-								      ch->channel,
-								      iio_chan_type_string[ch->ch_type],
-								      ch->channel2,
-								      attr->name);
-							break;
-						}
-					} else {
-						switch (attr->shared) {
-						case IIO_SHARED_BY_ALL:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s\"",
-								      attr->name);
-							break;
-						case IIO_SHARED_BY_DIR:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s\"",
-								      ch->ch_out ? "out" : "in",
-								      attr->name);
-							break;
-						case IIO_SHARED_BY_TYPE:
-							i += snprintf(buff + i, no_os_max(n - i, 0),
-								      "filename=\"%s_%s_%s\"",
-								      ch->ch_out ? "out" : "in",
-								      iio_chan_type_string[ch->ch_type],
-								      attr->name);
-							break;
-						case IIO_SEPARATE:
-							if (ch->indexed)
-								i += snprintf(buff + i, no_os_max(n - i, 0),
-									      "filename=\"%s_%s%d_%s\"",
-									      ch->ch_out ? "out" : "in",
-									      iio_chan_type_string[ch->ch_type],
-									      ch->channel,
-									      attr->name);
-							else
-								i += snprintf(buff + i, no_os_max(n - i, 0),
-									      "filename=\"%s_%s_%s\"",
-									      ch->ch_out ? "out" : "in",
-									      iio_chan_type_string[ch->ch_type],
-									      attr->name);
-							break;
+	if (k == 0) {
+		iio_xml_printf(w, "<device id=\"%s\" name=\"%s\">", id, name);
+
+		return w->err;
+	}
+
+	k--;
+	nb = device->channels ? device->num_ch : 0;
+	if (k < nb) {
+		ch = &device->channels[k];
+		_print_ch_id(ch_id, ch);
+		iio_xml_printf(w, "<channel id=\"%s\"", ch_id);
+		if (ch->name)
+			iio_xml_printf(w, " name=\"%s\"", ch->name);
+		iio_xml_printf(w, " type=\"%s\" >",
+			       ch->ch_out ? "output" : "input");
+
+		if (ch->scan_type)
+			iio_xml_printf(w, "<scan-element index=\"%d\""
+				       " format=\"%s:%c%d/%d>>%d\" />",
+				       ch->scan_index,
+				       ch->scan_type->is_big_endian ? "be" : "le",
+				       ch->scan_type->sign,
+				       ch->scan_type->realbits,
+				       ch->scan_type->storagebits,
+				       ch->scan_type->shift);
+
+		/* Write channel attributes */
+		if (ch->attributes)
+			for (j = 0; ch->attributes[j].name; j++) {
+				attr = &ch->attributes[j];
+				iio_xml_printf(w, "<attribute name=\"%s\" ",
+					       attr->name);
+				if (ch->diferential) {
+					switch (attr->shared) {
+					case IIO_SHARED_BY_ALL:
+						iio_xml_printf(w, "filename=\"%s\"",
+							       attr->name);
+						break;
+					case IIO_SHARED_BY_DIR:
+						iio_xml_printf(w, "filename=\"%s_%s\"",
+							       ch->ch_out ? "out" : "in",
+							       attr->name);
+						break;
+					case IIO_SHARED_BY_TYPE:
+						iio_xml_printf(w, "filename=\"%s_%s-%s_%s\"",
+							       ch->ch_out ? "out" : "in",
+							       iio_chan_type_string[ch->ch_type],
+							       iio_chan_type_string[ch->ch_type],
+							       attr->name);
+						break;
+					case IIO_SEPARATE:
+						if (!ch->indexed) {
+							// Differential channels must be indexed!
+							return -EINVAL;
 						}
+						iio_xml_printf(w, "filename=\"%s_%s%d-%s%d_%s\"",
+							       ch->ch_out ? "out" : "in",
+							       iio_chan_type_string[ch->ch_type],
+							       ch->channel,
+							       iio_chan_type_string[ch->ch_type],
+							       ch->channel2,
+							       attr->name);
+						break;
+					}
+				} else {
+					switch (attr->shared) {
+					case IIO_SHARED_BY_ALL:
+						iio_xml_printf(w, "filename=\"%s\"",
+							       attr->name);
+						break;
+					case IIO_SHARED_BY_DIR:
+						iio_xml_printf(w, "filename=\"%s_%s\"",
+							       ch->ch_out ? "out" : "in",
+							       attr->name);
+						break;
+					case IIO_SHARED_BY_TYPE:
+						iio_xml_printf(w, "filename=\"%s_%s_%s\"",
+							       ch->ch_out ? "out" : "in",
+							       iio_chan_type_string[ch->ch_type],
+							       attr->name);
+						break;
+					case IIO_SEPARATE:
+						if (ch->indexed)
+							iio_xml_printf(w, "filename=\"%s_%s%d_%s\"",
+								       ch->ch_out ? "out" : "in",
+								       iio_chan_type_string[ch->ch_type],
+								       ch->channel,
+								       attr->name);
+						else
+							iio_xml_printf(w, "filename=\"%s_%s_%s\"",
+								       ch->ch_out ? "out" : "in",
+								       iio_chan_type_string[ch->ch_type],
+								       attr->name);
+						break;
 					}
-					i += snprintf(buff + i, no_os_max(n - i, 0), " />");
 				}
+				iio_xml_printf(w, " />");
+			}
 
-			i += snprintf(buff + i, no_os_max(n - i, 0), "</channel>");
-		}
+		iio_xml_printf(w, "</channel>");
+
+		return w->err;
+	}
+
+	k -= nb;
+	nb = iio_xml_nb_attrs(device->attributes);
+	if (k < nb) {
+		iio_xml_printf(w, "<attribute name=\"%s\" />",
+			       device->attributes[k].name);
+
+		return w->err;
+	}
+
+	k -= nb;
+	nb = iio_xml_nb_attrs(device->debug_attributes);
+	if (k < nb) {
+		iio_xml_printf(w, "<debug-attribute name=\"%s\" />",
+			       device->debug_attributes[k].name);
+
+		return w->err;
+	}
 
-	/* Write device attributes */
-	if (device->attributes)
-		for (j = 0; device->attributes[j].name; j++)
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<attribute name=\"%s\" />",
-				      device->attributes[j].name);
-
-	/* Write debug attributes */
-	if (device->debug_attributes)
-		for (j = 0; device->debug_attributes[j].name; j++)
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<debug-attribute name=\"%s\" />",
-				      device->debug_attributes[j].name);
 	if (device->debug_reg_read || device->debug_reg_write)
-		i += snprintf(buff + i, no_os_max(n - i, 0),
-			      "<debug-attribute name=\""REG_ACCESS_ATTRIBUTE"\" />");
+		iio_xml_printf(w, "<debug-attribute name=\""REG_ACCESS_ATTRIBUTE"\" />");
 
 	/*
 	 * Write buffer element (required by libiio v1.x to create buffer).
@@ -1746,75 +2903,228 @@ static uint32_t iio_generate_device_xml(struct iio_device *device, char *name,
 	if (device->read_dev || device->write_dev || device->submit ||
 	    device->trigger_handler) {
 		if (device->buffer_attributes) {
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<buffer index=\"0\">");
+			iio_xml_printf(w, "<buffer index=\"0\">");
 			for (j = 0; device->buffer_attributes[j].name; j++)
-				i += snprintf(buff + i, no_os_max(n - i, 0),
-					      "<attribute name=\"%s\" />",
-					      device->buffer_attributes[j].name);
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "</buffer>");
+				iio_xml_printf(w, "<attribute name=\"%s\" />",
+					       device->buffer_attributes[j].name);
+			iio_xml_printf(w, "</buffer>");
 		} else {
-			i += snprintf(buff + i, no_os_max(n - i, 0),
-				      "<buffer index=\"0\" />");
+			iio_xml_printf(w, "<buffer index=\"0\" />");
 		}
 	}
 
-	i += snprintf(buff + i, no_os_max(n - i, 0), "</device>");
+	iio_xml_printf(w, "</device>");
 
-	return i;
+	return w->err;
 }
 
-static int32_t iio_init_xml(struct iio_desc *desc)
+#ifdef NO_OS_ALLOC_STATS
+/*
+ * Publish the allocator statistics as context attributes. The values have a
+ * fixed width so the size of the xml, computed once, doesn't change.
+ */
+static void iio_xml_alloc_stats(struct iio_xml_writer *w)
+{
+	struct no_os_alloc_pool_stats pool;
+	struct no_os_alloc_stats stats;
+	uint32_t i;
+
+	for (i = 0; i < NO_OS_ALLOC_TAG_MAX; i++) {
+		if (no_os_alloc_get_stats(i, &stats))
+			continue;
+		iio_xml_printf(w, "<context-attribute name=\"alloc_%s\" "
+			       "value=\"in_use=%010"PRIu32" peak=%010"PRIu32
+			       " allocs=%010"PRIu32" frees=%010"PRIu32
+			       " failed=%010"PRIu32" wasted=%010"PRIu32"\" />",
+			       no_os_alloc_tag_name(i), stats.in_use, stats.peak,
+			       stats.nb_allocs, stats.nb_frees, stats.nb_failed,
+			       stats.wasted);
+	}
+
+	for (i = 0; !no_os_alloc_get_pool_stats(i, &pool); i++)
+		iio_xml_printf(w, "<context-attribute name=\"alloc_pool_%"PRIu32
+			       "\" value=\"used=%010"PRIu32" peak=%010"PRIu32
+			       " blocks=%010"PRIu32"\" />", pool.block_size,
+			       pool.used, pool.peak, pool.nb_blocks);
+}
+#endif
+
+/*
+ * Get the descriptor, name and id of the device or trigger number i.
+ * Triggers are described by dummy, which only has their attributes.
+ */
+static struct iio_device *iio_xml_object(struct iio_desc *desc, uint32_t i,
+		struct iio_device *dummy,
+		char **name, char **id)
 {
-	struct iio_dev_priv *dev;
 	struct iio_trig_priv *trig;
-	struct iio_device dummy = { 0 };
-	uint32_t i, size, of;
 
-	/* -2 because of the 0 character */
-	size = sizeof(header) + sizeof(header_end) - 2;
-	size += iio_add_ctx_attr_in_xml(desc, NULL, -1);
-	for (i = 0; i < desc->nb_devs; i++) {
-		dev = desc->devs + i;
-		size += iio_generate_device_xml(dev->dev_descriptor,
-						(char *)dev->name,
-						dev->dev_id, NULL, -1);
+	if (i < desc->nb_devs) {
+		*name = (char *)desc->devs[i].name;
+		*id = desc->devs[i].dev_id;
+
+		return desc->devs[i].dev_descriptor;
+	}
+
+	trig = desc->trigs + i - desc->nb_devs;
+	memset(dummy, 0, sizeof(*dummy));
+	dummy->attributes = trig->descriptor->attributes;
+	*name = trig->name;
+	*id = trig->id;
+
+	return dummy;
+}
+
+/*
+ * The xml is made of pieces: the header with the context attributes, the
+ * pieces of each device and trigger and the closing tag. They are small so
+ * that a chunk of the xml is generated without formatting much of what
+ * precedes it.
+ */
+static uint32_t iio_xml_nb_pieces(struct iio_desc *desc)
+{
+	struct iio_device dummy, *device;
+	uint32_t i, nb = 2;
+	char *name, *id;
+
+	for (i = 0; i < desc->nb_devs + desc->nb_trigs; i++) {
+		device = iio_xml_object(desc, i, &dummy, &name, &id);
+		nb += iio_xml_device_nb_pieces(device);
+	}
+
+	return nb;
+}
+
+static int32_t iio_generate_xml_piece(struct iio_desc *desc,
+				      struct iio_xml_writer *w, uint32_t k)
+{
+	struct iio_device dummy, *device;
+	uint32_t i, nb;
+	char *name, *id;
+
+	if (k == 0) {
+		iio_xml_write(w, header, sizeof(header) - 1);
+		for (i = 0; i < desc->nb_ctx_attr; i++) {
+			iio_xml_printf(w, "<context-attribute name=\"%s\" ",
+				       desc->ctx_attrs[i].name);
+			iio_xml_printf(w, "value=\"%s\" />",
+				       desc->ctx_attrs[i].value);
+		}
+#ifdef NO_OS_ALLOC_STATS
+		iio_xml_alloc_stats(w);
+#endif
+
+		return w->err;
 	}
-	for (i = 0; i < desc->nb_trigs; i++) {
-		trig = desc->trigs + i;
-		dummy.attributes = trig->descriptor->attributes;
-		size += iio_generate_device_xml(&dummy, trig->name, trig->id,
-						NULL, -1);
+
+	k--;
+	for (i = 0; i < desc->nb_devs + desc->nb_trigs; i++) {
+		device = iio_xml_object(desc, i, &dummy, &name, &id);
+		nb = iio_xml_device_nb_pieces(device);
+		if (k < nb)
+			return iio_generate_device_xml(w, device, name, id, k);
+		k -= nb;
 	}
 
-	desc->xml_desc = (char *)no_os_calloc(size + 1, sizeof(*desc->xml_desc));
-	if (!desc->xml_desc)
-		return -ENOMEM;
+	iio_xml_write(w, header_end, sizeof(header_end) - 1);
 
-	desc->xml_size = size;
+	return w->err;
+}
 
-	strcpy(desc->xml_desc, header);
-	of = sizeof(header) - 1;
-	of += iio_add_ctx_attr_in_xml(desc, desc->xml_desc + of, size - of);
-	for (i = 0; i < desc->nb_devs; i++) {
-		dev = desc->devs + i;
-		of += iio_generate_device_xml(dev->dev_descriptor,
-					      (char *)dev->name, dev->dev_id,
-					      desc->xml_desc + of, size - of);
+/**
+ * @brief Generate len bytes of the context xml, starting at offset.
+ *
+ * Only the pieces overlapping the requested window are generated, their
+ * offsets being computed once by iio_init_xml. The first one is found with a
+ * binary search, so sending the whole xml in chunks is linear in its size.
+ * @param ctx    - IIOD context.
+ * @param offset - Offset in the xml.
+ * @param buf    - Where to write the xml.
+ * @param len    - Maximum number of bytes to write.
+ * @return Number of bytes written, negative value in case of failure.
+ */
+static int iio_read_xml(struct iiod_ctx *ctx, uint32_t offset, char *buf,
+			uint32_t len)
+{
+	struct iio_desc *desc = ctx->instance;
+	struct iio_xml_writer w = { 0 };
+	uint32_t k, lo, hi;
+	int32_t ret;
+
+	if (offset >= desc->xml_size)
+		return 0;
+
+	w.buf = buf;
+	w.start = offset;
+	w.len = no_os_min(len, desc->xml_size - offset);
+
+	/* Last piece starting at or before offset */
+	lo = 0;
+	hi = desc->xml_nb_pieces;
+	while (hi - lo > 1) {
+		k = lo + (hi - lo) / 2;
+		if (desc->xml_offsets[k] <= w.start)
+			lo = k;
+		else
+			hi = k;
 	}
-	for (i = 0; i < desc->nb_trigs; i++) {
-		trig = desc->trigs + i;
-		dummy.attributes = trig->descriptor->attributes;
-		of += iio_generate_device_xml(&dummy, trig->name, trig->id,
-					      desc->xml_desc + of, size - of);
+
+	for (k = lo; k < desc->xml_nb_pieces; k++) {
+		if (desc->xml_offsets[k] >= w.start + w.len)
+			break;
+
+		w.pos = desc->xml_offsets[k];
+		ret = iio_generate_xml_piece(desc, &w, k);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
 	}
 
-	strcpy(desc->xml_desc + of, header_end);
+	return w.len;
+}
+
+/* Compute the size of the xml and where each of its pieces starts */
+static int32_t iio_init_xml(struct iio_desc *desc)
+{
+	struct iio_xml_writer w = { 0 };
+	uint32_t k, nb_pieces;
+	int32_t ret;
+
+	nb_pieces = iio_xml_nb_pieces(desc);
+	desc->xml_offsets = no_os_calloc(nb_pieces + 1,
+					 sizeof(*desc->xml_offsets));
+	if (!desc->xml_offsets)
+		return -ENOMEM;
+
+	for (k = 0; k < nb_pieces; k++) {
+		desc->xml_offsets[k] = w.pos;
+		ret = iio_generate_xml_piece(desc, &w, k);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			no_os_free(desc->xml_offsets);
+			desc->xml_offsets = NULL;
+			return ret;
+		}
+	}
+	desc->xml_offsets[nb_pieces] = w.pos;
+	desc->xml_nb_pieces = nb_pieces;
+	desc->xml_size = w.pos;
 
 	return 0;
 }
 
+static void iio_free_devs(struct iio_desc *desc)
+{
+	uint32_t i;
+
+	if (!desc->devs)
+		return;
+
+	for (i = 0; i < desc->nb_devs; i++) {
+		iio_buffer_free(&desc->devs[i].buffer);
+		no_os_free(desc->devs[i].buffer.public.scan_mask);
+	}
+	no_os_free(desc->devs);
+}
+
 static int32_t iio_init_devs(struct iio_desc *desc,
 			     struct iio_device_init *devs, uint32_t n)
 {
@@ -1838,6 +3148,10 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 		ldev->dev_data.dev = ndev->dev;
 		ldev->dev_data.buffer = &ldev->buffer.public;
 		ldev->name = ndev->name;
+		ldev->buffer.nb_blocks = ndev->nb_blocks;
+#ifdef LINUX_PLATFORM
+		ldev->buffer.desc = desc;
+#endif
 		if (ndev->dev_descriptor->read_dev ||
 		    ndev->dev_descriptor->write_dev ||
 		    ndev->dev_descriptor->submit ||
@@ -1845,6 +3159,14 @@ static int32_t iio_init_devs(struct iio_desc *desc,
 			ldev->buffer.raw_buf = ndev->raw_buf;
 			ldev->buffer.raw_buf_len = ndev->raw_buf_len;
 			ldev->buffer.public.buf = &ldev->buffer.cb;
+			ldev->buffer.public.scan_mask = no_os_calloc(
+					no_os_max(NO_OS_BITS_TO_WORDS(ndev->dev_descriptor->num_ch), 1),
+					sizeof(uint32_t));
+			if (!ldev->buffer.public.scan_mask) {
+				iio_free_devs(desc);
+				desc->devs = NULL;
+				return -ENOMEM;
+			}
 			ldev->buffer.initalized = 1;
 		} else {
 			ldev->buffer.initalized = 0;
@@ -1890,6 +3212,156 @@ static int32_t iio_init_trigs(struct iio_desc *desc,
 	return 0;
 }
 
+#ifdef LINUX_PLATFORM
+/*
+ * When the server is threaded, the callbacks of one device are called by one
+ * connection at a time.
+ */
+static void *iio_dev_lock(struct iiod_ctx *ctx, const char *device)
+{
+	struct iio_dev_priv *dev;
+
+	dev = get_iio_device(ctx->instance, device);
+	if (!dev)
+		return NULL;
+
+	no_os_mutex_lock(dev->lock);
+
+	return dev->lock;
+}
+
+static int iio_read_attr_locked(struct iiod_ctx *ctx, const char *device,
+				struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_read_attr(ctx, device, attr, buf, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_write_attr_locked(struct iiod_ctx *ctx, const char *device,
+				 struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_write_attr(ctx, device, attr, buf, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_get_trigger_locked(struct iiod_ctx *ctx, const char *device,
+				  char *trigger, uint32_t len)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_get_trigger(ctx, device, trigger, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_set_trigger_locked(struct iiod_ctx *ctx, const char *device,
+				  const char *trigger, uint32_t len)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_set_trigger(ctx, device, trigger, len);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_read_buffer_locked(struct iiod_ctx *ctx, const char *device,
+				  char *buf, uint32_t bytes)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_read_buffer(ctx, device, buf, bytes);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_write_buffer_locked(struct iiod_ctx *ctx, const char *device,
+				   const char *buf, uint32_t bytes)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_write_buffer(ctx, device, buf, bytes);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_refill_buffer_locked(struct iiod_ctx *ctx, const char *device)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_refill_buffer(ctx, device);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_push_buffer_locked(struct iiod_ctx *ctx, const char *device)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_push_buffer(ctx, device);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_open_dev_locked(struct iiod_ctx *ctx, const char *device,
+			       uint32_t samples, const uint32_t *mask,
+			       uint32_t mask_words, bool cyclic)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_open_dev(ctx, device, samples, mask, mask_words, cyclic);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_close_dev_locked(struct iiod_ctx *ctx, const char *device)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_close_dev(ctx, device);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+
+static int iio_set_buffers_count_locked(struct iiod_ctx *ctx,
+					const char *device,
+					uint32_t buffers_count)
+{
+	void *lock = iio_dev_lock(ctx, device);
+	int ret;
+
+	ret = iio_set_buffers_count(ctx, device, buffers_count);
+	no_os_mutex_unlock(lock);
+
+	return ret;
+}
+#endif
+
 /**
  * @brief Set communication ops and read/write ops
  * @param desc - iio descriptor.
@@ -1907,6 +3379,11 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	if (!desc || !init_param)
 		return -EINVAL;
 
+#ifndef LINUX_PLATFORM
+	if (init_param->threaded)
+		return -ENOSYS;
+#endif
+
 	ldesc = (struct iio_desc *)no_os_calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return -ENOMEM;
@@ -1926,6 +3403,10 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	if (NO_OS_IS_ERR_VALUE(ret))
 		goto free_trigs;
 
+	ret = iio_init_index(ldesc);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto free_xml;
+
 	/* device operations */
 	ops = &ldesc->iiod_ops;
 	ops->read_attr = iio_read_attr;
@@ -1941,26 +3422,67 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 	ops->send = iio_send;
 	ops->recv = iio_recv;
 	ops->set_buffers_count = iio_set_buffers_count;
+	ops->get_names = iio_get_names;
+	ops->get_buffer_info = iio_get_buffer_info;
+	ops->read_xml = iio_read_xml;
+#ifdef LINUX_PLATFORM
+	if (init_param->threaded) {
+		ops->read_attr = iio_read_attr_locked;
+		ops->write_attr = iio_write_attr_locked;
+		ops->get_trigger = iio_get_trigger_locked;
+		ops->set_trigger = iio_set_trigger_locked;
+		ops->read_buffer = iio_read_buffer_locked;
+		ops->write_buffer = iio_write_buffer_locked;
+		ops->refill_buffer = iio_refill_buffer_locked;
+		ops->push_buffer = iio_push_buffer_locked;
+		ops->open = iio_open_dev_locked;
+		ops->close = iio_close_dev_locked;
+		ops->set_buffers_count = iio_set_buffers_count_locked;
+	}
+#endif
 
 	iiod_param.instance = ldesc;
 	iiod_param.ops = ops;
-	iiod_param.xml = ldesc->xml_desc;
+	iiod_param.xml = NULL;
 	iiod_param.xml_len = ldesc->xml_size;
 	iiod_param.phy_type = init_param->phy_type;
 
 	ret = iiod_init(&ldesc->iiod, &iiod_param);
 	if (NO_OS_IS_ERR_VALUE(ret))
-		goto free_xml;
+		goto free_index;
 
 	ret = no_os_cb_init(&ldesc->conns,
 			    sizeof(uint32_t) * (IIOD_MAX_CONNECTIONS + 1));
 	if (NO_OS_IS_ERR_VALUE(ret))
 		goto free_iiod;
 
+#ifdef LINUX_PLATFORM
+	ret = iio_event_init(ldesc);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		goto free_conns;
+
+	if (init_param->threaded) {
+		ret = iio_workers_init(ldesc);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			iio_event_remove(ldesc);
+			goto free_conns;
+		}
+	}
+#endif
+
 	if (init_param->phy_type == USE_UART) {
+		int uart_fd = -1;
+
 		ldesc->send = (int (*)())no_os_uart_write;
 		ldesc->recv = (int (*)())no_os_uart_read;
 		ldesc->uart_desc = init_param->uart_desc;
+#ifdef LINUX_PLATFORM
+		if (init_param->uart_get_fd) {
+			uart_fd = init_param->uart_get_fd(ldesc->uart_desc);
+			if (uart_fd >= 0)
+				ldesc->recv = (int (*)())no_os_uart_read_nonblocking;
+		}
+#endif
 
 		struct iiod_conn_data data = {
 			.conn = ldesc->uart_desc,
@@ -1969,8 +3491,11 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		};
 		ret = iiod_conn_add(ldesc->iiod, &data, &conn_id);
 		if (NO_OS_IS_ERR_VALUE(ret))
-			goto free_conns;
-		_push_conn(ldesc, conn_id);
+			goto free_events;
+		/* Without a pollable fd, the connection is always stepped */
+		ret = _add_conn(ldesc, conn_id, uart_fd);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_events;
 	}
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
 	else if (init_param->phy_type == USE_NETWORK) {
@@ -1979,13 +3504,19 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		ret = socket_init(&ldesc->server,
 				  init_param->tcp_socket_init_param);
 		if (NO_OS_IS_ERR_VALUE(ret))
-			goto free_conns;
+			goto free_events;
 		ret = socket_bind(ldesc->server, IIOD_PORT);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto free_pylink;
 		ret = socket_listen(ldesc->server, MAX_BACKLOG);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			goto free_pylink;
+#ifdef LINUX_PLATFORM
+		ret = iio_event_add(ldesc, _sock_fd(ldesc->server),
+				    IIO_EVENT_SERVER);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_pylink;
+#endif
 	}
 #endif
 	else if (init_param->phy_type == USE_LOCAL_BACKEND) {
@@ -1999,11 +3530,13 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param)
 		};
 		ret = iiod_conn_add(ldesc->iiod, &data, &conn_id);
 		if (NO_OS_IS_ERR_VALUE(ret))
-			goto free_conns;
-		_push_conn(ldesc, conn_id);
+			goto free_events;
+		ret = _add_conn(ldesc, conn_id, -1);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			goto free_events;
 	} else {
 		ret = -EINVAL;
-		goto free_conns;
+		goto free_events;
 	}
 
 	*desc = ldesc;
@@ -2014,16 +3547,23 @@ free_pylink:
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
 	socket_remove(ldesc->server);
 #endif
+free_events:
+#ifdef LINUX_PLATFORM
+	iio_workers_remove(ldesc);
+	iio_event_remove(ldesc);
+#endif
 free_conns:
 	no_os_cb_remove(ldesc->conns);
 free_iiod:
 	iiod_remove(ldesc->iiod);
+free_index:
+	no_os_free(ldesc->index);
 free_xml:
-	no_os_free(ldesc->xml_desc);
+	no_os_free(ldesc->xml_offsets);
 free_trigs:
 	no_os_free(ldesc->trigs);
 free_devs:
-	no_os_free(ldesc->devs);
+	iio_free_devs(ldesc);
 free_desc:
 	no_os_free(ldesc);
 
@@ -2043,6 +3583,10 @@ int iio_remove(struct iio_desc *desc)
 	if (!desc)
 		return -EINVAL;
 
+#ifdef LINUX_PLATFORM
+	/* The workers close their connections */
+	iio_workers_remove(desc);
+#endif
 #if defined(NO_OS_NETWORKING) || defined(NO_OS_LWIP_NETWORKING) || defined(NO_OS_W5500_NETWORKING)
 	for (int i = 0; i < IIOD_MAX_CONNECTIONS; i++) {
 		ret = iiod_conn_remove(desc->iiod, i, &data);
@@ -2052,12 +3596,16 @@ int iio_remove(struct iio_desc *desc)
 		}
 	}
 	socket_remove(desc->server);
+#endif
+#ifdef LINUX_PLATFORM
+	iio_event_remove(desc);
 #endif
 	no_os_cb_remove(desc->conns);
 	iiod_remove(desc->iiod);
-	no_os_free(desc->devs);
+	iio_free_devs(desc);
 	no_os_free(desc->trigs);
-	no_os_free(desc->xml_desc);
+	no_os_free(desc->index);
+	no_os_free(desc->xml_offsets);
 	no_os_free(desc);
 
 	return 0;
@@ -61,6 +61,12 @@ struct iio_device_init {
 	int8_t *raw_buf;
 	/* Length of raw_buf */
 	uint32_t raw_buf_len;
+	/*
+	 * Number of blocks of the buffer queue allocated when raw_buf is NULL.
+	 * With more than one block the device can fill a block while the
+	 * previous one is sent to the client. 0 is the same as 1.
+	 */
+	uint32_t nb_blocks;
 	/* If set, trigger will be linked to this device */
 	char *trigger_id;
 };
@@ -108,6 +114,20 @@ struct iio_init_param {
 	uint32_t nb_devs;
 	struct iio_trigger_init *trigs;
 	uint32_t nb_trigs;
+	/*
+	 * Serve each client from its own thread, so a slow client doesn't
+	 * delay the others. Only supported on Linux, where it requires the
+	 * pthread no_os_mutex implementation (linux_mutex.c).
+	 */
+	bool threaded;
+	/*
+	 * Optional, Linux only. Returns a file descriptor that becomes
+	 * readable when uart_desc receives data (e.g. linux_uart_get_fd).
+	 * When set, the UART is read without blocking and waited with the
+	 * other connections, so iio_step_wait sleeps instead of blocking in
+	 * the UART read.
+	 */
+	int (*uart_get_fd)(struct no_os_uart_desc *desc);
 };
 
 /* Set communication ops and read/write ops. */
@@ -116,6 +136,12 @@ int iio_init(struct iio_desc **desc, struct iio_init_param *init_param);
 int iio_remove(struct iio_desc *desc);
 /* Execut an iio step. */
 int iio_step(struct iio_desc *desc);
+#ifdef LINUX_PLATFORM
+/* Wait up to timeout_ms for events and step the connections that are ready */
+int iio_step_wait(struct iio_desc *desc, int32_t timeout_ms);
+/* Wake up iio_step_wait */
+int iio_wakeup(struct iio_desc *desc);
+#endif
 /* Signal iio that a trigger has been triggered.
  * This will be called in interrupt context. An application callback will be
    called in interrupt context if trigger is synchronous with the interrupt
@@ -129,15 +155,22 @@ int iio_format_value(char *buf, uint32_t len, enum iio_val fmt,
 		     int32_t size, int32_t *vals);
 
 /* DMA buffer functions. */
-/* Get buffer addr where to write iio_buffer.size bytes */
+/* Get the next block of iio_buffer.size bytes from the buffer queue */
 int iio_buffer_get_block(struct iio_buffer *buffer, void **addr);
-/* To be called to mark last iio_buffer_read as done */
+/* Mark the oldest block got with iio_buffer_get_block as done */
 int iio_buffer_block_done(struct iio_buffer *buffer);
 
 /* Trigger buffer functions. */
-/* Write to buffer iio_buffer.bytes_per_scan bytes from data */
+/*
+ * Write to buffer iio_buffer.bytes_per_scan bytes from data.
+ * For devices with a trigger handler scans go through a lock-free queue, so
+ * it can be called from interrupt context. -EAGAIN is returned if it is full.
+ */
 int iio_buffer_push_scan(struct iio_buffer *buffer, void *data);
-/* Read from buffer iio_buffer.bytes_per_scan bytes into data */
+/*
+ * Read from buffer iio_buffer.bytes_per_scan bytes into data.
+ * Same as push, -EAGAIN is returned if no scan is queued.
+ */
 int iio_buffer_pop_scan(struct iio_buffer *buffer, void *data);
 
 #endif /* IIO_H_ */
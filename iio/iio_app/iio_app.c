@@ -68,6 +68,7 @@
 
 #ifdef LINUX_PLATFORM
 #include "linux_socket.h"
+#include "linux_uart.h"
 #include "tcp_socket.h"
 #endif
 
@@ -232,7 +233,15 @@ static int32_t network_setup(struct iio_init_param *iio_init_param,
 static int32_t uart_setup(struct no_os_uart_desc **uart_desc,
 			  struct no_os_uart_init_param *uart_init_par)
 {
-#if defined(LINUX_PLATFORM) || defined(NO_OS_LWIP_NETWORKING)
+#if defined(LINUX_PLATFORM)
+	/* Served over the network, unless a Linux UART is given */
+	if (uart_init_par->platform_ops != &linux_uart_ops) {
+		*uart_desc = NULL;
+		return 0;
+	}
+
+	return no_os_uart_init(uart_desc, uart_init_par);
+#elif defined(NO_OS_LWIP_NETWORKING)
 	*uart_desc = NULL;
 	return 0;
 #endif
@@ -344,7 +353,19 @@ int iio_app_init(struct iio_app_desc **app,
 	status = lwip_network_setup(application, app_init_param, &iio_init_param);
 	if (status)
 		goto error;
-#elif defined(NO_OS_NETWORKING) || defined(LINUX_PLATFORM)
+#elif defined(LINUX_PLATFORM)
+	if (uart_desc) {
+		/* The UART is waited with poll, like a network connection */
+		iio_init_param.phy_type = USE_UART;
+		iio_init_param.uart_desc = uart_desc;
+		iio_init_param.uart_get_fd = linux_uart_get_fd;
+	} else {
+		status = network_setup(&iio_init_param, uart_desc,
+				       application->irq_desc);
+		if (status < 0)
+			goto error;
+	}
+#elif defined(NO_OS_NETWORKING)
 	status = network_setup(&iio_init_param, uart_desc, application->irq_desc);
 	if (status < 0)
 		goto error;
@@ -382,6 +403,7 @@ int iio_app_init(struct iio_app_desc **app,
 		iio_init_devs[i].dev = app_init_param.devices[i].dev;
 		iio_init_devs[i].dev_descriptor = app_init_param.devices[i].dev_descriptor;
 		iio_init_devs[i].trigger_id = app_init_param.devices[i].default_trigger_id;
+		iio_init_devs[i].nb_blocks = app_init_param.devices[i].nb_blocks;
 		buff = app_init_param.devices[i].read_buff ?
 		       app_init_param.devices[i].read_buff :
 		       app_init_param.devices[i].write_buff;
@@ -398,6 +420,7 @@ int iio_app_init(struct iio_app_desc **app,
 	iio_init_param.nb_devs = app_init_param.nb_devices;
 	iio_init_param.trigs = app_init_param.trigs;
 	iio_init_param.nb_trigs = app_init_param.nb_trigs;
+	iio_init_param.threaded = app_init_param.threaded;
 	iio_init_param.ctx_attrs = app_init_param.ctx_attrs;
 	iio_init_param.nb_ctx_attr = app_init_param.nb_ctx_attr;
 
@@ -436,7 +459,16 @@ int iio_app_run(struct iio_app_desc *app)
 	int status;
 
 	do {
+#ifdef LINUX_PLATFORM
+		/*
+		 * Sleep until a client needs to be served. Applications with a
+		 * post step callback expect it to be called without delays.
+		 */
+		status = iio_step_wait(app->iio_desc,
+				       app->post_step_callback ? 0 : -1);
+#else
 		status = iio_step(app->iio_desc);
+#endif
 		if (status && status != -EAGAIN && status != -ENOTCONN
 		    && status != -NO_OS_EOVERRUN)
 			return status;
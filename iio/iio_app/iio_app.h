@@ -76,6 +76,8 @@ struct iio_app_device {
 	struct iio_data_buffer *read_buff;
 	struct iio_data_buffer *write_buff;
 	char *default_trigger_id;
+	/* Number of blocks of the buffer queue when no buffer is provided */
+	uint32_t nb_blocks;
 };
 
 /**
@@ -124,6 +126,8 @@ struct iio_app_init_param {
 	int (*post_step_callback)(void *arg);
 	/** Function parameteres */
 	void *arg;
+	/** Serve each client from its own thread. Linux only */
+	bool threaded;
 
 #ifdef NO_OS_LWIP_NETWORKING
 	struct lwip_network_param lwip_param;
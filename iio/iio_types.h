@@ -199,10 +199,14 @@ struct iio_cyclic_buffer_info {
 };
 
 struct iio_buffer {
-	/* Mask with active channels */
+	/* Mask with active channels. Holds only the first 32 channels */
 	uint32_t active_mask;
-	/* Size in bytes */
+	/* Bitmap with all active channels. NO_OS_BITS_TO_WORDS(num_ch) words */
+	uint32_t *scan_mask;
+	/* Size in bytes of a block */
 	uint32_t size;
+	/* Number of blocks in the buffer queue */
+	uint32_t nb_blocks;
 	/* Number of bytes per sample * number of active channels */
 	uint32_t bytes_per_scan;
 	/* Number of requested samples */
@@ -264,6 +268,11 @@ struct iio_device {
 	/* Bufer callbacks */
 	/** Called before enabling buffer */
 	int32_t (*pre_enable)(void *dev, uint32_t mask);
+	/** Same as pre_enable but receiving the bitmap of all nb_ch channels.
+	 *  Needed by devices with more than 32 channels. When set, pre_enable
+	 *  is not called. */
+	int32_t (*pre_enable_scan)(void *dev, const uint32_t *mask,
+				   uint32_t nb_ch);
 	/** Called after disabling buffer */
 	int32_t (*post_disable)(void *dev);
 	/** Called when buffer ready to transfer. Write/read to/from dev */
@@ -31,6 +31,8 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
+#define NO_OS_ALLOC_TAG		NO_OS_ALLOC_TAG_IIO
+
 #include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
@@ -69,7 +71,8 @@ static struct iiod_str cmds[] = {
 	[IIOD_CMD_WRITEBUF]	= IIOD_STR("WRITEBUF"),
 	[IIOD_CMD_GETTRIG]	= IIOD_STR("GETTRIG"),
 	[IIOD_CMD_SETTRIG]	= IIOD_STR("SETTRIG"),
-	[IIOD_CMD_SET]		= IIOD_STR("SET")
+	[IIOD_CMD_SET]		= IIOD_STR("SET"),
+	[IIOD_CMD_BINARY]	= IIOD_STR("BINARY")
 };
 static const uint32_t priority_array[] = {
 	/* Order not tested, just personal expectation. Function can
@@ -87,7 +90,8 @@ static const uint32_t priority_array[] = {
 	IIOD_CMD_GETTRIG,
 	IIOD_CMD_SETTRIG,
 	IIOD_CMD_HELP,
-	IIOD_CMD_SET
+	IIOD_CMD_SET,
+	IIOD_CMD_BINARY
 };
 
 static_assert(NO_OS_ARRAY_SIZE(cmds) == NO_OS_ARRAY_SIZE(priority_array),
@@ -125,6 +129,37 @@ static int32_t parse_num(const char *token, uint32_t *res, uint32_t base)
 	return 0;
 }
 
+/*
+ * Parse a mask sent as a hex string, most significant word first, as libiio
+ * does for devices with more than 32 channels.
+ */
+static int32_t iiod_parse_mask(const char *token, struct comand_desc *res)
+{
+	char word[9];
+	int32_t len;
+	int32_t i;
+	int32_t ret;
+
+	len = strlen(token);
+	if (!len || len > IIOD_MASK_WORDS * 8)
+		return -EINVAL;
+
+	memset(res->mask, 0, sizeof(res->mask));
+	res->mask_words = NO_OS_DIV_ROUND_UP(len, 8);
+	for (i = 0; i < (int32_t)res->mask_words; i++) {
+		/* Least significant word is at the end of the string */
+		len -= 8;
+		strncpy(word, token + no_os_max(len, 0),
+			8 + no_os_min(len, 0));
+		word[8 + no_os_min(len, 0)] = '\0';
+		ret = parse_num(word, &res->mask[i], 16);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	return 0;
+}
+
 static int32_t iiod_parse_open(const char *token, struct comand_desc *res,
 			       char **ctx)
 {
@@ -141,7 +176,7 @@ static int32_t iiod_parse_open(const char *token, struct comand_desc *res,
 	if (!token)
 		return -EINVAL;
 
-	ret = parse_num(token, &res->mask, 16);
+	ret = iiod_parse_mask(token, res);
 	if (NO_OS_IS_ERR_VALUE(ret))
 		return ret;
 
@@ -240,6 +275,7 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 	case IIOD_CMD_EXIT:
 	case IIOD_CMD_PRINT:
 	case IIOD_CMD_VERSION:
+	case IIOD_CMD_BINARY:
 		return 0;
 	case IIOD_CMD_TIMEOUT:
 		return parse_num(token, &res->timeout, 10);
@@ -278,7 +314,8 @@ int32_t iiod_parse_line(char *buf, struct comand_desc *res, char **ctx)
 }
 
 static int dummy_open(struct iiod_ctx *ctx, const char *device,
-		      uint32_t samples, uint32_t mask, bool cyclic)
+		      uint32_t samples, const uint32_t *mask,
+		      uint32_t mask_words, bool cyclic)
 {
 	return -EINVAL;
 }
@@ -306,6 +343,21 @@ static int dummy_wr_data(struct iiod_ctx *ctx, const char *device,
 	return -EINVAL;
 }
 
+static int dummy_get_names(struct iiod_ctx *ctx, uint32_t dev, uint32_t chn,
+			   int32_t attr_idx, enum iio_attr_type *type,
+			   char *device, char *channel, char *attr)
+{
+	return -EINVAL;
+}
+
+static int dummy_get_buffer_info(struct iiod_ctx *ctx, uint32_t dev,
+				 const uint32_t *mask, uint32_t mask_words,
+				 uint32_t *nb_ch, uint32_t *sample_size,
+				 bool *output)
+{
+	return -EINVAL;
+}
+
 static int dummy_set_timeout(struct iiod_ctx *ctx, uint32_t timeout)
 {
 	return -EINVAL;
@@ -333,6 +385,9 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 	ops->write_attr = SET_DUMMY_IF_NULL(new_ops->write_attr, dummy_rw_attr);
 	ops->get_trigger = SET_DUMMY_IF_NULL(new_ops->get_trigger, dummy_rd_data);
 	ops->set_trigger = SET_DUMMY_IF_NULL(new_ops->set_trigger, dummy_wr_data);
+	ops->get_names = SET_DUMMY_IF_NULL(new_ops->get_names, dummy_get_names);
+	ops->get_buffer_info = SET_DUMMY_IF_NULL(new_ops->get_buffer_info,
+				dummy_get_buffer_info);
 	ops->set_timeout = SET_DUMMY_IF_NULL(new_ops->set_timeout, dummy_set_timeout);
 	ops->set_buffers_count = SET_DUMMY_IF_NULL(new_ops->set_buffers_count,
 				 dummy_set_buffers_count);
@@ -340,6 +395,7 @@ int32_t iiod_copy_ops(struct iiod_ops *ops, struct iiod_ops *new_ops)
 					       dummy_close);
 	ops->push_buffer = SET_DUMMY_IF_NULL(new_ops->push_buffer,
 					     dummy_close);
+	ops->read_xml = new_ops->read_xml;
 
 	return 0;
 }
@@ -352,6 +408,9 @@ int32_t iiod_init(struct iiod_desc **desc, struct iiod_init_param *param)
 	if (!desc || !param || !param->ops)
 		return -EINVAL;
 
+	if (!param->xml && !param->ops->read_xml)
+		return -EINVAL;
+
 	ldesc = (struct iiod_desc *)calloc(1, sizeof(*ldesc));
 	if (!ldesc)
 		return -ENOMEM;
@@ -378,6 +437,89 @@ void iiod_remove(struct iiod_desc *desc)
 	free(desc);
 }
 
+/* Find a buffer created by the client on device dev */
+static struct iiod_bin_buffer *iiod_bin_find_buffer(struct iiod_conn_priv *conn,
+		uint8_t dev, uint32_t id)
+{
+	uint32_t i;
+
+	for (i = 0; i < IIOD_BIN_MAX_BUFFERS; i++)
+		if (conn->bin_bufs[i].used && conn->bin_bufs[i].dev == dev &&
+		    conn->bin_bufs[i].id == id)
+			return &conn->bin_bufs[i];
+
+	return NULL;
+}
+
+/*
+ * Open the device of a buffer, if not already done. The number of samples is
+ * given by the size of the biggest block.
+ */
+static int32_t iiod_bin_enable(struct iiod_desc *desc,
+			       struct iiod_conn_priv *conn,
+			       struct iiod_bin_buffer *buf)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	uint32_t i, size = 0;
+	int32_t ret;
+
+	if (buf->enabled)
+		return 0;
+
+	for (i = 0; i < IIOD_BIN_MAX_BLOCKS; i++)
+		size = no_os_max(size, buf->block_size[i]);
+	if (!size)
+		return -EINVAL;
+
+	ret = desc->ops.open(&ctx, conn->cmd_data.device,
+			     size / buf->sample_size, buf->mask,
+			     buf->mask_words, false);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	buf->enabled = true;
+
+	return 0;
+}
+
+/* Close the device of a buffer, if open */
+static int32_t iiod_bin_disable(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn,
+				struct iiod_bin_buffer *buf)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+
+	if (!buf->enabled)
+		return 0;
+
+	buf->enabled = false;
+
+	return desc->ops.close(&ctx, conn->cmd_data.device);
+}
+
+/* Close the devices of the buffers left by the client of a connection */
+static void iiod_bin_free_buffers(struct iiod_desc *desc,
+				  struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct comand_desc *data = &conn->cmd_data;
+	struct iiod_bin_buffer *buf;
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < IIOD_BIN_MAX_BUFFERS; i++) {
+		buf = &conn->bin_bufs[i];
+		if (buf->used && buf->enabled) {
+			ret = desc->ops.get_names(&ctx, buf->dev, 0, -1,
+						  &data->type, data->device,
+						  data->channel, data->attr);
+			if (!NO_OS_IS_ERR_VALUE(ret))
+				iiod_bin_disable(desc, conn, buf);
+		}
+		buf->used = false;
+	}
+}
+
 static void conn_clean_state(struct iiod_conn_priv *conn)
 {
 	memset(&conn->cmd_data, 0, sizeof(conn->cmd_data));
@@ -387,7 +529,9 @@ static void conn_clean_state(struct iiod_conn_priv *conn)
 	conn->res.buf.buf = NULL;
 	conn->res.buf.idx = 0;
 	conn->parser_idx = 0;
-	conn->state = IIOD_READING_LINE;
+	conn->bin_buf = NULL;
+	conn->bin_err = 0;
+	conn->state = conn->binary ? IIOD_BIN_READING_CMD : IIOD_READING_LINE;
 }
 
 int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
@@ -431,6 +575,7 @@ int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 	data->conn = conn->conn;
 	data->len = conn->payload_buf_len;
 	data->buf = conn->payload_buf;
+	iiod_bin_free_buffers(desc, conn);
 	conn->used = 0;
 
 	return 0;
@@ -446,7 +591,7 @@ static int32_t call_op(struct iiod_ops *ops, struct comand_desc *data,
 		return ops->set_timeout(ctx, data->timeout);
 	case IIOD_CMD_OPEN:
 		return ops->open(ctx, data->device, data->sample_count,
-				 data->mask, data->cyclic);
+				 data->mask, data->mask_words, data->cyclic);
 	case IIOD_CMD_CLOSE:
 		return ops->close(ctx, data->device);
 	case IIOD_CMD_SETTRIG:
@@ -481,12 +626,16 @@ static int32_t rw_iiod_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn,
 			ret = desc->ops.send(&ctx, tmp_buf, len);
 		else
 			ret = desc->ops.recv(&ctx, tmp_buf, len);
+		if (ret == -EAGAIN)
+			ret = 0;
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 
 		buf->idx += ret;
-		if (ret < len)
+		if (ret < len) {
+			conn->waiting_data = !(flags & IIOD_WR);
 			return -EAGAIN;
+		}
 	}
 
 	if (flags & IIOD_ENDL) {
@@ -505,28 +654,36 @@ static int32_t do_read_buff_delayed(struct iiod_desc *desc,
 				    struct iiod_conn_priv *conn)
 {
 	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
-	uint32_t max_to_read;
-	int32_t ret, len;
+	uint32_t max_to_read, len;
+	int32_t ret;
 
 	conn->nb_buf.buf = conn->payload_buf;
 	len = no_os_min(conn->payload_buf_len, conn->cmd_data.bytes_count);
 	max_to_read = len - conn->nb_buf.len;
 	ret = desc->ops.read_buffer(&ctx, conn->cmd_data.device,
 				    conn->nb_buf.buf + conn->nb_buf.len, max_to_read);
+	if (ret == -EAGAIN)
+		ret = 0;
 	if (ret < 0)
 		return ret;
 
 	conn->nb_buf.len += ret;
 
-	if (conn->nb_buf.len < conn->cmd_data.bytes_count)
+	if (conn->nb_buf.len < len) {
+		conn->waiting_data = true;
 		return -EAGAIN;
+	}
 
 	ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_WR);
 	if (ret < 0)
 		return ret;
 
+	/* Data bigger than the connection buffer is sent in chunks */
+	conn->cmd_data.bytes_count -= conn->nb_buf.len;
 	conn->nb_buf.len = 0;
 	conn->nb_buf.idx = 0;
+	if (conn->cmd_data.bytes_count)
+		return -EAGAIN;
 
 	return 0;
 }
@@ -551,6 +708,10 @@ static int32_t do_read_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn)
 		/* Read from dev */
 		ret = desc->ops.read_buffer(&ctx, conn->cmd_data.device,
 					    conn->nb_buf.buf, len);
+		if (ret == -EAGAIN || ret == 0) {
+			conn->waiting_data = true;
+			return -EAGAIN;
+		}
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
 		len = ret;
@@ -572,6 +733,49 @@ static int32_t do_read_buff(struct iiod_desc *desc, struct iiod_conn_priv *conn)
 	return 0;
 }
 
+/*
+ * Send the context xml chunk by chunk, generating each one with
+ * ops->read_xml in payload_buf. The text protocol ends it with \n.
+ */
+static int32_t do_write_xml(struct iiod_desc *desc,
+			    struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	uint32_t len;
+	uint8_t flags;
+	int32_t ret;
+
+	while (conn->xml_offset < desc->xml_len) {
+		if (conn->nb_buf.len == 0) {
+			len = no_os_min(conn->payload_buf_len,
+					desc->xml_len - conn->xml_offset);
+			ret = desc->ops.read_xml(&ctx, conn->xml_offset,
+						 conn->payload_buf, len);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+			if (!ret)
+				return -EINVAL;
+
+			conn->nb_buf.buf = conn->payload_buf;
+			conn->nb_buf.len = ret;
+			conn->nb_buf.idx = 0;
+		}
+
+		flags = IIOD_WR;
+		if (!conn->binary &&
+		    conn->xml_offset + conn->nb_buf.len == desc->xml_len)
+			flags |= IIOD_ENDL;
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, flags);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->xml_offset += conn->nb_buf.len;
+		conn->nb_buf.len = 0;
+	}
+
+	return 0;
+}
+
 static int32_t do_write_buff(struct iiod_desc *desc,
 			     struct iiod_conn_priv *conn)
 {
@@ -615,6 +819,7 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 		.name = data->attr,
 		.channel = data->channel
 	};
+	uint32_t i;
 	int32_t ret;
 
 	switch (data->cmd) {
@@ -625,7 +830,8 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 	case IIOD_CMD_SETTRIG:
 	case IIOD_CMD_SET:
 		if (data->cmd == IIOD_CMD_OPEN) {
-			conn->mask = data->mask;
+			memcpy(conn->mask, data->mask, sizeof(conn->mask));
+			conn->mask_words = data->mask_words;
 			if (data->cyclic)
 				conn->is_cyclic_buffer = true;
 		}
@@ -643,13 +849,25 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 	case IIOD_CMD_PRINT:
 		conn->res.val = desc->xml_len;
 		conn->res.write_val = 1;
-		conn->res.buf.buf = desc->xml;
-		conn->res.buf.len = desc->xml_len;
+		if (desc->xml) {
+			conn->res.buf.buf = desc->xml;
+			conn->res.buf.len = desc->xml_len;
+		}
 		break;
 	case IIOD_CMD_VERSION:
 		conn->res.buf.buf = IIOD_VERSION;
 		conn->res.buf.len = IIOD_VERSION_LEN;
 		break;
+	case IIOD_CMD_BINARY:
+		conn->res.write_val = 1;
+		if (desc->ops.get_names == dummy_get_names) {
+			conn->res.val = -EOPNOTSUPP;
+			break;
+		}
+		/* Following commands are parsed by the binary state machine */
+		conn->res.val = 0;
+		conn->binary = true;
+		break;
 	case IIOD_CMD_READ:
 	case IIOD_CMD_GETTRIG:
 		if (data->cmd == IIOD_CMD_READ)
@@ -684,7 +902,11 @@ static int32_t iiod_run_cmd(struct iiod_desc *desc,
 			break;
 		}
 		conn->res.val = data->bytes_count;
-		ret = snprintf(conn->buf_mask, 10, "%08"PRIx32, conn->mask);
+		/* Echo the mask with the same number of words it was set */
+		for (ret = 0, i = conn->mask_words; i > 0; i--)
+			ret += snprintf(conn->buf_mask + ret,
+					sizeof(conn->buf_mask) - ret,
+					"%08"PRIx32, conn->mask[i - 1]);
 		conn->res.buf.buf = conn->buf_mask;
 		conn->res.buf.len = ret;
 		break;
@@ -735,6 +957,572 @@ end:
 	return ret;
 }
 
+/* Return true if a binary command is followed by a 64 bit length */
+static bool iiod_bin_has_payload(uint8_t op)
+{
+	switch (op) {
+	case IIOD_BIN_OP_WRITE_ATTR:
+	case IIOD_BIN_OP_WRITE_DBG_ATTR:
+	case IIOD_BIN_OP_WRITE_BUF_ATTR:
+	case IIOD_BIN_OP_WRITE_CHN_ATTR:
+	case IIOD_BIN_OP_CREATE_BLOCK:
+	case IIOD_BIN_OP_TRANSFER_BLOCK:
+	case IIOD_BIN_OP_ENQUEUE_BLOCK_CYCLIC:
+	case IIOD_BIN_OP_READ_ATTRS:
+	case IIOD_BIN_OP_WRITE_ATTRS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Read IIOD_BIN_CMD_SIZE or IIOD_BIN_LEN_SIZE bytes in conn->bin_raw without
+ * blocking.
+ */
+static int32_t iiod_bin_read_raw(struct iiod_desc *desc,
+				 struct iiod_conn_priv *conn, uint32_t len)
+{
+	int32_t ret;
+
+	if (!conn->nb_buf.buf) {
+		conn->nb_buf.buf = (char *)conn->bin_raw;
+		conn->nb_buf.len = len;
+		conn->nb_buf.idx = 0;
+	}
+
+	ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+
+	return 0;
+}
+
+/* Fill conn->cmd_data with the names of the objects used by a binary cmd */
+static int32_t iiod_bin_get_names(struct iiod_desc *desc,
+				  struct iiod_conn_priv *conn,
+				  struct iiod_bin_cmd *cmd)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct comand_desc *data = &conn->cmd_data;
+	int32_t attr_idx = -1;
+	uint32_t chn = 0;
+
+	switch (cmd->op) {
+	case IIOD_BIN_OP_READ_ATTR:
+	case IIOD_BIN_OP_WRITE_ATTR:
+		data->type = IIO_ATTR_TYPE_DEVICE;
+		attr_idx = cmd->code;
+		break;
+	case IIOD_BIN_OP_READ_DBG_ATTR:
+	case IIOD_BIN_OP_WRITE_DBG_ATTR:
+		data->type = IIO_ATTR_TYPE_DEBUG;
+		attr_idx = cmd->code;
+		break;
+	case IIOD_BIN_OP_READ_BUF_ATTR:
+	case IIOD_BIN_OP_WRITE_BUF_ATTR:
+		data->type = IIO_ATTR_TYPE_BUFFER;
+		attr_idx = cmd->code;
+		break;
+	case IIOD_BIN_OP_READ_CHN_ATTR:
+	case IIOD_BIN_OP_WRITE_CHN_ATTR:
+		/* Channel index in the upper 16 bits, attribute in the lower */
+		data->type = IIO_ATTR_TYPE_CH_IN;
+		chn = (uint32_t)cmd->code >> 16;
+		attr_idx = cmd->code & 0xFFFF;
+		break;
+	default:
+		break;
+	}
+
+	if (attr_idx < -1)
+		return -EINVAL;
+
+	return desc->ops.get_names(&ctx, cmd->dev, chn, attr_idx, &data->type,
+				   data->device, data->channel, data->attr);
+}
+
+/*
+ * Execute the attribute reads or writes listed in the payload of a
+ * READ_ATTRS or WRITE_ATTRS command. Results are appended after the list in
+ * payload_buf and sent as the response data.
+ */
+static int32_t iiod_bin_run_attrs(struct iiod_desc *desc,
+				  struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct comand_desc *data = &conn->cmd_data;
+	struct iiod_attr attr = {
+		.name = data->attr,
+		.channel = data->channel
+	};
+	bool is_write = conn->bin_cmd.op == IIOD_BIN_OP_WRITE_ATTRS;
+	uint8_t *buf = (uint8_t *)conn->payload_buf;
+	uint32_t in, out, start, len;
+	struct iiod_bin_cmd sub;
+	uint8_t saved;
+	int32_t ret;
+
+	start = NO_OS_DIV_ROUND_UP(data->bytes_count, 4) * 4;
+	out = start;
+	for (in = 0; in < data->bytes_count; in += IIOD_BIN_CMD_SIZE) {
+		if (in + IIOD_BIN_CMD_SIZE > data->bytes_count ||
+		    out + 4 > conn->payload_buf_len)
+			return -EINVAL;
+
+		/* Entries are command headers, client_id being ignored */
+		sub.op = buf[in + 2];
+		sub.dev = buf[in + 3];
+		sub.code = (int32_t)no_os_get_unaligned_le32(buf + in + 4);
+
+		len = 0;
+		if (is_write) {
+			in += 4;
+			if (in + IIOD_BIN_CMD_SIZE > data->bytes_count)
+				return -EINVAL;
+			len = no_os_get_unaligned_le32(buf + in + 4);
+			if (len > data->bytes_count - in - IIOD_BIN_CMD_SIZE)
+				return -EINVAL;
+		}
+
+		switch (sub.op) {
+		case IIOD_BIN_OP_READ_ATTR:
+		case IIOD_BIN_OP_READ_DBG_ATTR:
+		case IIOD_BIN_OP_READ_BUF_ATTR:
+		case IIOD_BIN_OP_READ_CHN_ATTR:
+			ret = is_write ? -EINVAL : 0;
+			break;
+		case IIOD_BIN_OP_WRITE_ATTR:
+		case IIOD_BIN_OP_WRITE_DBG_ATTR:
+		case IIOD_BIN_OP_WRITE_BUF_ATTR:
+		case IIOD_BIN_OP_WRITE_CHN_ATTR:
+			ret = is_write ? 0 : -EINVAL;
+			break;
+		default:
+			ret = -EINVAL;
+			break;
+		}
+		if (!ret)
+			ret = iiod_bin_get_names(desc, conn, &sub);
+		attr.type = data->type;
+
+		/* Errors of an entry are only reported in its result */
+		if (!NO_OS_IS_ERR_VALUE(ret) && is_write) {
+			/* The byte following the value may be the next entry */
+			saved = buf[in + IIOD_BIN_CMD_SIZE + len];
+			buf[in + IIOD_BIN_CMD_SIZE + len] = '\0';
+			ret = desc->ops.write_attr(&ctx, data->device, &attr,
+						   (char *)buf + in +
+						   IIOD_BIN_CMD_SIZE, len);
+			buf[in + IIOD_BIN_CMD_SIZE + len] = saved;
+		} else if (!NO_OS_IS_ERR_VALUE(ret)) {
+			ret = desc->ops.read_attr(&ctx, data->device, &attr,
+						  (char *)buf + out + 4,
+						  conn->payload_buf_len - out - 4);
+		}
+
+		no_os_put_unaligned_le32(ret, buf + out);
+		out += 4;
+		if (!is_write && !NO_OS_IS_ERR_VALUE(ret)) {
+			for (; ret & 0x3; ret++)
+				if (out + ret < conn->payload_buf_len)
+					buf[out + ret] = 0;
+			out = no_os_min(out + ret, conn->payload_buf_len);
+		}
+
+		in += NO_OS_DIV_ROUND_UP(len, 4) * 4;
+	}
+
+	conn->res.val = out - start;
+	conn->res.buf.buf = conn->payload_buf + start;
+	conn->res.buf.len = out - start;
+
+	return 0;
+}
+
+/*
+ * Create a buffer with the channel mask read in payload_buf. The response
+ * data is the mask, as done by libiio.
+ */
+static int32_t iiod_bin_create_buffer(struct iiod_desc *desc,
+				      struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_bin_cmd *cmd = &conn->bin_cmd;
+	uint32_t i, len = conn->cmd_data.bytes_count;
+	struct iiod_bin_buffer *buf = NULL;
+	uint32_t nb_ch;
+	int32_t ret;
+
+	if (iiod_bin_find_buffer(conn, cmd->dev, IIOD_BIN_BUF_ID(cmd->code)))
+		return -EBUSY;
+
+	if (len > sizeof(buf->mask))
+		return -E2BIG;
+
+	for (i = 0; i < IIOD_BIN_MAX_BUFFERS && !buf; i++)
+		if (!conn->bin_bufs[i].used)
+			buf = &conn->bin_bufs[i];
+	if (!buf)
+		return -ENOMEM;
+
+	memset(buf, 0, sizeof(*buf));
+	for (i = 0; i < len; i++)
+		buf->mask[i / 4] |= (uint32_t)(uint8_t)conn->payload_buf[i]
+				    << (8 * (i % 4));
+	buf->mask_words = NO_OS_DIV_ROUND_UP(len, 4);
+
+	ret = desc->ops.get_buffer_info(&ctx, cmd->dev, buf->mask,
+					buf->mask_words, &nb_ch,
+					&buf->sample_size, &buf->output);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+	if (!buf->sample_size)
+		return -EINVAL;
+
+	buf->used = true;
+	buf->dev = cmd->dev;
+	buf->id = IIOD_BIN_BUF_ID(cmd->code);
+
+	conn->res.buf.buf = conn->payload_buf;
+	conn->res.buf.len = len;
+
+	return len;
+}
+
+/* Create or free a block of a buffer. The size of a new block is bytes_count */
+static int32_t iiod_bin_set_block(struct iiod_conn_priv *conn, bool create)
+{
+	struct iiod_bin_cmd *cmd = &conn->bin_cmd;
+	uint32_t block = IIOD_BIN_BLOCK_ID(cmd->code);
+	uint32_t size = conn->cmd_data.bytes_count;
+	struct iiod_bin_buffer *buf;
+
+	buf = iiod_bin_find_buffer(conn, cmd->dev, IIOD_BIN_BUF_ID(cmd->code));
+	if (!buf)
+		return -ENOENT;
+
+	if (block >= IIOD_BIN_MAX_BLOCKS)
+		return create ? -ENOMEM : -ENOENT;
+
+	if (!create) {
+		buf->block_size[block] = 0;
+
+		return 0;
+	}
+
+	/* The device is opened for a number of whole samples */
+	if (!size || size % buf->sample_size)
+		return -EINVAL;
+
+	buf->block_size[block] = size;
+
+	return 0;
+}
+
+/*
+ * Fill an input block: refill the device buffer and prepare to send len bytes
+ * of it after the response. Returns the number of bytes to be sent.
+ */
+static int32_t iiod_bin_dequeue(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn,
+				struct iiod_bin_buffer *buf, uint32_t len)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	uint32_t block = IIOD_BIN_BLOCK_ID(conn->bin_cmd.code);
+	int32_t ret;
+
+	if (block >= IIOD_BIN_MAX_BLOCKS || len > buf->block_size[block])
+		return -EINVAL;
+
+	ret = iiod_bin_enable(desc, conn, buf);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = desc->ops.refill_buffer(&ctx, conn->cmd_data.device);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	buf->bytes_used[block] = len;
+	conn->bin_buf = buf;
+	conn->cmd_data.bytes_count = len;
+
+	return len;
+}
+
+/*
+ * Called when the 64 bit length of a TRANSFER_BLOCK or ENQUEUE_BLOCK_CYCLIC
+ * command is read. The data of output blocks follows and is streamed to the
+ * device in IIOD_BIN_RW_BUF, or dropped if the block can't be transferred.
+ * Input blocks are read when the command is run.
+ */
+static int32_t iiod_bin_start_block(struct iiod_desc *desc,
+				    struct iiod_conn_priv *conn, uint64_t len)
+{
+	struct iiod_bin_cmd *cmd = &conn->bin_cmd;
+	uint32_t block = IIOD_BIN_BLOCK_ID(cmd->code);
+	struct iiod_bin_buffer *buf;
+	int32_t ret;
+
+	/* Without the buffer it is unknown if data follows */
+	buf = iiod_bin_find_buffer(conn, cmd->dev, IIOD_BIN_BUF_ID(cmd->code));
+	if (!buf || len > UINT32_MAX)
+		return -ENOTCONN;
+
+	conn->bin_buf = buf;
+	conn->cmd_data.bytes_count = len;
+	if (!buf->output) {
+		conn->state = IIOD_RUNNING_CMD;
+
+		return 0;
+	}
+
+	ret = iiod_bin_get_names(desc, conn, cmd);
+	if (!NO_OS_IS_ERR_VALUE(ret)) {
+		if (cmd->op == IIOD_BIN_OP_ENQUEUE_BLOCK_CYCLIC)
+			ret = -EOPNOTSUPP;
+		else if (block >= IIOD_BIN_MAX_BLOCKS ||
+			 len > buf->block_size[block])
+			ret = -EINVAL;
+		else
+			ret = iiod_bin_enable(desc, conn, buf);
+	}
+	if (!NO_OS_IS_ERR_VALUE(ret))
+		buf->bytes_used[block] = len;
+	else
+		conn->bin_err = ret;
+	conn->state = IIOD_BIN_RW_BUF;
+
+	return 0;
+}
+
+/* Read and drop the data of an output block that can't be transferred */
+static int32_t iiod_bin_drop_data(struct iiod_desc *desc,
+				  struct iiod_conn_priv *conn)
+{
+	int32_t ret;
+
+	while (conn->cmd_data.bytes_count) {
+		if (conn->nb_buf.len == 0) {
+			conn->nb_buf.buf = conn->payload_buf;
+			conn->nb_buf.len = no_os_min(conn->payload_buf_len,
+						     conn->cmd_data.bytes_count);
+			conn->nb_buf.idx = 0;
+		}
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_RD);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->cmd_data.bytes_count -= conn->nb_buf.len;
+		conn->nb_buf.len = 0;
+	}
+
+	return 0;
+}
+
+/*
+ * Execute a binary command. Equivalent of iiod_run_cmd. No I/O.
+ * Errors of the command are reported to the client in conn->res.val.
+ */
+static int32_t iiod_bin_run_cmd(struct iiod_desc *desc,
+				struct iiod_conn_priv *conn)
+{
+	struct iiod_ctx ctx = IIOD_CTX(desc, conn);
+	struct iiod_bin_cmd *cmd = &conn->bin_cmd;
+	struct comand_desc *data = &conn->cmd_data;
+	struct iiod_attr attr = {
+		.name = data->attr,
+		.channel = data->channel
+	};
+	struct iiod_bin_buffer *buf;
+	enum iio_attr_type trig_type;
+	char dummy[MAX_ATTR_NAME];
+	uint32_t i;
+	int32_t ret;
+
+	memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+	switch (cmd->op) {
+	case IIOD_BIN_OP_PRINT:
+		conn->res.val = desc->xml_len;
+		if (desc->xml) {
+			conn->res.buf.buf = desc->xml;
+			conn->res.buf.len = desc->xml_len;
+		}
+
+		return 0;
+	case IIOD_BIN_OP_TIMEOUT:
+		conn->res.val = desc->ops.set_timeout(&ctx, cmd->code);
+
+		return 0;
+	case IIOD_BIN_OP_READ_ATTRS:
+	case IIOD_BIN_OP_WRITE_ATTRS:
+		ret = iiod_bin_run_attrs(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret)) {
+			memset(&conn->res.buf, 0, sizeof(conn->res.buf));
+			conn->res.val = ret;
+		}
+
+		return 0;
+	default:
+		break;
+	}
+
+	ret = iiod_bin_get_names(desc, conn, cmd);
+	if (NO_OS_IS_ERR_VALUE(ret)) {
+		conn->res.val = ret;
+
+		return 0;
+	}
+	attr.type = data->type;
+
+	switch (cmd->op) {
+	case IIOD_BIN_OP_READ_ATTR:
+	case IIOD_BIN_OP_READ_DBG_ATTR:
+	case IIOD_BIN_OP_READ_BUF_ATTR:
+	case IIOD_BIN_OP_READ_CHN_ATTR:
+	case IIOD_BIN_OP_GETTRIG:
+		if (cmd->op == IIOD_BIN_OP_GETTRIG)
+			ret = desc->ops.get_trigger(&ctx, data->device,
+						    conn->payload_buf,
+						    conn->payload_buf_len);
+		else
+			ret = desc->ops.read_attr(&ctx, data->device, &attr,
+						  conn->payload_buf,
+						  conn->payload_buf_len);
+		conn->res.val = ret;
+		if (!NO_OS_IS_ERR_VALUE(ret)) {
+			conn->res.buf.buf = conn->payload_buf;
+			conn->res.buf.len = ret;
+		}
+		break;
+	case IIOD_BIN_OP_WRITE_ATTR:
+	case IIOD_BIN_OP_WRITE_DBG_ATTR:
+	case IIOD_BIN_OP_WRITE_BUF_ATTR:
+	case IIOD_BIN_OP_WRITE_CHN_ATTR:
+		conn->payload_buf[data->bytes_count] = '\0';
+		conn->res.val = desc->ops.write_attr(&ctx, data->device, &attr,
+						     conn->payload_buf,
+						     data->bytes_count);
+		break;
+	case IIOD_BIN_OP_SETTRIG:
+		/* code is the index of the trigger or negative to remove it */
+		memset(data->trigger, 0, sizeof(data->trigger));
+		if (cmd->code >= 0) {
+			ret = desc->ops.get_names(&ctx, cmd->code, 0, -1,
+						  &trig_type, data->trigger,
+						  dummy, dummy);
+			if (NO_OS_IS_ERR_VALUE(ret)) {
+				conn->res.val = ret;
+				break;
+			}
+		}
+		conn->res.val = desc->ops.set_trigger(&ctx, data->device,
+						      data->trigger,
+						      strlen(data->trigger));
+		break;
+	case IIOD_BIN_OP_CREATE_BUFFER:
+		conn->res.val = iiod_bin_create_buffer(desc, conn);
+		break;
+	case IIOD_BIN_OP_FREE_BUFFER:
+	case IIOD_BIN_OP_ENABLE_BUFFER:
+	case IIOD_BIN_OP_DISABLE_BUFFER:
+		buf = iiod_bin_find_buffer(conn, cmd->dev,
+					   IIOD_BIN_BUF_ID(cmd->code));
+		if (!buf) {
+			conn->res.val = -ENOENT;
+			break;
+		}
+		if (cmd->op == IIOD_BIN_OP_ENABLE_BUFFER) {
+			conn->res.val = iiod_bin_enable(desc, conn, buf);
+			break;
+		}
+		conn->res.val = iiod_bin_disable(desc, conn, buf);
+		if (cmd->op == IIOD_BIN_OP_FREE_BUFFER)
+			buf->used = false;
+		break;
+	case IIOD_BIN_OP_CREATE_BLOCK:
+	case IIOD_BIN_OP_FREE_BLOCK:
+		conn->res.val = iiod_bin_set_block(conn,
+						   cmd->op == IIOD_BIN_OP_CREATE_BLOCK);
+		break;
+	case IIOD_BIN_OP_TRANSFER_BLOCK:
+		buf = conn->bin_buf;
+		if (!buf->output) {
+			conn->res.val = iiod_bin_dequeue(desc, conn, buf,
+							 data->bytes_count);
+			break;
+		}
+		/* Output block data was already written in IIOD_BIN_RW_BUF */
+		if (conn->bin_err) {
+			conn->res.val = conn->bin_err;
+			break;
+		}
+		ret = desc->ops.push_buffer(&ctx, data->device);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			conn->res.val = ret;
+		else
+			conn->res.val = data->bytes_count;
+		break;
+	case IIOD_BIN_OP_ENQUEUE_BLOCK_CYCLIC:
+		/* Output data, if any, was dropped in IIOD_BIN_RW_BUF */
+		conn->res.val = -EOPNOTSUPP;
+		break;
+	case IIOD_BIN_OP_RETRY_DEQUEUE_BLOCK:
+		/* Blocks are transferred synchronously, transfer it again */
+		buf = iiod_bin_find_buffer(conn, cmd->dev,
+					   IIOD_BIN_BUF_ID(cmd->code));
+		i = IIOD_BIN_BLOCK_ID(cmd->code);
+		if (!buf || i >= IIOD_BIN_MAX_BLOCKS)
+			conn->res.val = -ENOENT;
+		else if (buf->output)
+			conn->res.val = buf->bytes_used[i];
+		else
+			conn->res.val = iiod_bin_dequeue(desc, conn, buf,
+							 buf->bytes_used[i]);
+		break;
+	default:
+		conn->res.val = -EOPNOTSUPP;
+		break;
+	}
+
+	return 0;
+}
+
+/* Write the response header and data of a binary command without blocking */
+static int32_t iiod_bin_write_response(struct iiod_desc *desc,
+				       struct iiod_conn_priv *conn)
+{
+	int32_t ret;
+
+	if (!conn->nb_buf.buf) {
+		no_os_put_unaligned_le16(conn->bin_cmd.client_id, conn->bin_raw);
+		conn->bin_raw[2] = IIOD_BIN_OP_RESPONSE;
+		conn->bin_raw[3] = conn->bin_cmd.dev;
+		no_os_put_unaligned_le32(conn->res.val, conn->bin_raw + 4);
+		conn->nb_buf.buf = (char *)conn->bin_raw;
+		conn->nb_buf.len = IIOD_BIN_CMD_SIZE;
+		conn->nb_buf.idx = 0;
+	}
+
+	if (conn->nb_buf.idx < conn->nb_buf.len) {
+		ret = rw_iiod_buff(desc, conn, &conn->nb_buf, IIOD_WR);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	if (conn->res.buf.buf && conn->res.buf.idx < conn->res.buf.len) {
+		ret = rw_iiod_buff(desc, conn, &conn->res.buf, IIOD_WR);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+
+	return 0;
+}
+
 /*
  * Function will return SUCCESS when a state was processed.
  * If a state is still in processing state, it will return -EAGAIN.
@@ -748,6 +1536,8 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 		.instance = desc->app_instance,
 		.conn = conn->conn
 	};
+	uint32_t nb_ch;
+	uint64_t len;
 	int32_t ret;
 
 	switch (conn->state) {
@@ -778,6 +1568,13 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 		return 0;
 	case IIOD_RUNNING_CMD:
 		/* Execute or call necessary ops depending on cmd. No I/O */
+		if (conn->binary) {
+			ret = iiod_bin_run_cmd(desc, conn);
+			conn->state = IIOD_BIN_WRITING_RESPONSE;
+
+			return ret;
+		}
+
 		ret = iiod_run_cmd(desc, conn);
 		if (NO_OS_IS_ERR_VALUE(ret))
 			return ret;
@@ -812,8 +1609,12 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 				return ret;
 		}
 
-		if (conn->cmd_data.cmd != IIOD_CMD_READBUF &&
-		    conn->cmd_data.cmd != IIOD_CMD_WRITEBUF) {
+		if (conn->cmd_data.cmd == IIOD_CMD_PRINT && !desc->xml) {
+			memset(&conn->nb_buf, 0, sizeof(conn->nb_buf));
+			conn->xml_offset = 0;
+			conn->state = IIOD_WRITING_XML;
+		} else if (conn->cmd_data.cmd != IIOD_CMD_READBUF &&
+			   conn->cmd_data.cmd != IIOD_CMD_WRITEBUF) {
 			if (conn->is_cyclic_buffer && conn->cmd_data.cmd != IIOD_CMD_OPEN)
 				conn->state = IIOD_PUSH_CYCLIC_BUFFER;
 			else
@@ -844,7 +1645,11 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 				}
 				memset(&conn->res.buf, 0, sizeof(conn->res.buf));
 				conn->res.val = conn->cmd_data.bytes_count;
-				conn->cmd_data.cmd = IIOD_CMD_PRINT;
+				/*
+				 * Any cmd without data to follow the result.
+				 * Not PRINT, which would stream the xml.
+				 */
+				conn->cmd_data.cmd = IIOD_CMD_WRITE;
 				conn->state = IIOD_WRITING_CMD_RESULT;
 
 				return 0;
@@ -895,7 +1700,128 @@ static int32_t iiod_run_state(struct iiod_desc *desc,
 			conn->is_cyclic_buffer = false;
 		}
 		return 0;
+	case IIOD_BIN_READING_CMD:
+		ret = iiod_bin_read_raw(desc, conn, IIOD_BIN_CMD_SIZE);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
 
+		conn->bin_cmd.client_id = no_os_get_unaligned_le16(conn->bin_raw);
+		conn->bin_cmd.op = conn->bin_raw[2];
+		conn->bin_cmd.dev = conn->bin_raw[3];
+		conn->bin_cmd.code = (int32_t)no_os_get_unaligned_le32(conn->bin_raw
+				     + 4);
+		if (conn->bin_cmd.op == IIOD_BIN_OP_CREATE_BUFFER) {
+			/*
+			 * The mask has one word per 32 channels of the device.
+			 * The stream can't be resynchronized without its size.
+			 */
+			ret = desc->ops.get_buffer_info(&ctx, conn->bin_cmd.dev,
+							NULL, 0, &nb_ch, NULL,
+							NULL);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return -ENOTCONN;
+
+			len = NO_OS_DIV_ROUND_UP(nb_ch, 32) * 4;
+			if (len >= conn->payload_buf_len)
+				return -ENOTCONN;
+
+			conn->cmd_data.bytes_count = len;
+			conn->nb_buf.buf = conn->payload_buf;
+			conn->nb_buf.len = len;
+			conn->nb_buf.idx = 0;
+			conn->state = IIOD_READING_WRITE_DATA;
+		} else if (iiod_bin_has_payload(conn->bin_cmd.op)) {
+			conn->state = IIOD_BIN_READING_LEN;
+		} else {
+			conn->state = IIOD_RUNNING_CMD;
+		}
+
+		return 0;
+	case IIOD_BIN_READING_LEN:
+		ret = iiod_bin_read_raw(desc, conn, IIOD_BIN_LEN_SIZE);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		len = no_os_get_unaligned_le64(conn->bin_raw);
+		switch (conn->bin_cmd.op) {
+		case IIOD_BIN_OP_CREATE_BLOCK:
+			/* The length is the size of the block, no data follows */
+			conn->cmd_data.bytes_count = no_os_min(len, UINT32_MAX);
+			conn->state = IIOD_RUNNING_CMD;
+
+			return 0;
+		case IIOD_BIN_OP_TRANSFER_BLOCK:
+		case IIOD_BIN_OP_ENQUEUE_BLOCK_CYCLIC:
+			return iiod_bin_start_block(desc, conn, len);
+		default:
+			break;
+		}
+
+		/*
+		 * Attribute values and masks must fit in the connection buffer.
+		 * The stream can't be resynchronized after dropping a payload so
+		 * the connection is closed.
+		 */
+		if (len >= conn->payload_buf_len)
+			return -ENOTCONN;
+
+		conn->cmd_data.bytes_count = len;
+		conn->nb_buf.buf = conn->payload_buf;
+		conn->nb_buf.len = len;
+		conn->nb_buf.idx = 0;
+		conn->state = IIOD_READING_WRITE_DATA;
+
+		return 0;
+	case IIOD_BIN_WRITING_RESPONSE:
+		ret = iiod_bin_write_response(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		/* Input block data follows the response */
+		if (conn->bin_buf && !conn->bin_buf->output &&
+		    !NO_OS_IS_ERR_VALUE((int32_t)conn->res.val) &&
+		    conn->cmd_data.bytes_count) {
+			conn->state = IIOD_BIN_RW_BUF;
+		} else if (conn->bin_cmd.op == IIOD_BIN_OP_PRINT &&
+			   !desc->xml) {
+			conn->xml_offset = 0;
+			conn->state = IIOD_WRITING_XML;
+		} else {
+			conn->state = IIOD_LINE_DONE;
+		}
+
+		return 0;
+	case IIOD_BIN_RW_BUF:
+		if (!conn->bin_buf->output) {
+			ret = do_read_buff(desc, conn);
+			if (NO_OS_IS_ERR_VALUE(ret))
+				return ret;
+
+			conn->state = IIOD_LINE_DONE;
+
+			return 0;
+		}
+
+		if (conn->bin_err)
+			ret = iiod_bin_drop_data(desc, conn);
+		else
+			ret = do_write_buff(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		/* Push the block and send the response */
+		conn->cmd_data.bytes_count = no_os_get_unaligned_le64(conn->bin_raw);
+		conn->state = IIOD_RUNNING_CMD;
+
+		return 0;
+	case IIOD_WRITING_XML:
+		ret = do_write_xml(desc, conn);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+
+		conn->state = IIOD_LINE_DONE;
+
+		return 0;
 	default:
 		/* Should never get here */
 		return -EINVAL;
@@ -912,6 +1838,7 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 		return -EINVAL;
 
 	conn = &desc->conns[conn_id];
+	conn->waiting_data = false;
 	do {
 		ret = iiod_run_state(desc, conn);
 		if (ret == -EAGAIN)
@@ -925,3 +1852,23 @@ int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id)
 
 	return ret;
 }
+
+bool iiod_conn_is_idle(struct iiod_desc *desc, uint32_t conn_id)
+{
+	if (!desc || conn_id >= IIOD_MAX_CONNECTIONS ||
+	    !desc->conns[conn_id].used)
+		return false;
+
+	switch (desc->conns[conn_id].state) {
+	case IIOD_READING_LINE:
+	case IIOD_READING_WRITE_DATA:
+	case IIOD_BIN_READING_CMD:
+	case IIOD_BIN_READING_LEN:
+		return true;
+	case IIOD_RW_BUF:
+	case IIOD_BIN_RW_BUF:
+		return desc->conns[conn_id].waiting_data;
+	default:
+		return false;
+	}
+}
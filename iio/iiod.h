@@ -49,6 +49,12 @@
 #define MAX_CHN_ID		64
 #define MAX_ATTR_NAME		256
 
+/* Maximum number of channels of a device that can be set in a buffer mask */
+#ifndef IIOD_MAX_MASK_CHANNELS
+#define IIOD_MAX_MASK_CHANNELS	256
+#endif
+#define IIOD_MASK_WORDS		((IIOD_MAX_MASK_CHANNELS + 31) / 32)
+
 enum iio_attr_type {
 	IIO_ATTR_TYPE_DEBUG,
 	IIO_ATTR_TYPE_BUFFER,
@@ -105,9 +111,11 @@ struct iiod_ops {
 	 * (depending on the internal buffer).
 	 * All calls with the same ctx will refer to this buffer until close is
 	 * called.
+	 * mask is a bitmap of mask_words words, channel 0 being bit 0 of the
+	 * first word.
 	 */
 	int (*open)(struct iiod_ctx *ctx, const char *device, uint32_t samples,
-		    uint32_t mask, bool cyclic);
+		    const uint32_t *mask, uint32_t mask_words, bool cyclic);
 	/* Equivalent of iio_buffer_destroy */
 	int (*close)(struct iiod_ctx *ctx, const char *device);
 
@@ -142,6 +150,44 @@ struct iiod_ops {
 	int (*set_trigger)(struct iiod_ctx *ctx, const char *device,
 			   const char *trigger, uint32_t len);
 
+	/*
+	 * Used by the binary protocol, where objects are referred by their
+	 * index in the context xml instead of by name.
+	 * Fill device (MAX_DEV_ID bytes) with the id of device number dev.
+	 * If attr_idx is not negative, also fill attr (MAX_ATTR_NAME bytes)
+	 * with the name of the attribute of the given type and, for channel
+	 * attributes, channel (MAX_CHN_ID bytes) with the id of channel number
+	 * chn. type is updated to IIO_ATTR_TYPE_CH_IN or IIO_ATTR_TYPE_CH_OUT
+	 * depending on the channel direction.
+	 * If not set, clients can't switch the connection to binary mode.
+	 */
+	int (*get_names)(struct iiod_ctx *ctx, uint32_t dev, uint32_t chn,
+			 int32_t attr_idx, enum iio_attr_type *type,
+			 char *device, char *channel, char *attr);
+
+	/*
+	 * Used by the binary protocol, where buffers are created from a
+	 * channel mask and sized in bytes.
+	 * Fill nb_ch with the number of channels of device number dev. If mask
+	 * is not NULL, also fill sample_size with the size in bytes of a scan
+	 * of the channels set in mask and output with the direction of those
+	 * channels.
+	 * If not set, clients can't create buffers in binary mode.
+	 */
+	int (*get_buffer_info)(struct iiod_ctx *ctx, uint32_t dev,
+			       const uint32_t *mask, uint32_t mask_words,
+			       uint32_t *nb_ch, uint32_t *sample_size,
+			       bool *output);
+
+	/*
+	 * Fill buf with len bytes of the context xml, starting at offset.
+	 * Used when iiod_init_param.xml is not set, so the xml is sent in
+	 * chunks of the connection buffer size and never stored whole.
+	 * Must return the number of bytes written in buf.
+	 */
+	int (*read_xml)(struct iiod_ctx *ctx, uint32_t offset, char *buf,
+			uint32_t len);
+
 	/* I don't know what this should be used for :) */
 	int (*set_timeout)(struct iiod_ctx *ctx, uint32_t timeout);
 
@@ -163,7 +209,7 @@ struct iiod_init_param {
 	void *instance;
 	/*
 	 * Xml description of the context and devices. It should exist until
-	 * iiod_remove is called
+	 * iiod_remove is called. If NULL, the xml is got with ops->read_xml
 	 */
 	char *xml;
 	/* Size of xml in bytes */
@@ -186,7 +232,18 @@ int32_t iiod_conn_add(struct iiod_desc *desc, struct iiod_conn_data *data,
 /* Remove conn_id from iiod. Provided data is returned in data */
 int32_t iiod_conn_remove(struct iiod_desc *desc, uint32_t conn_id,
 			 struct iiod_conn_data *data);
-/* Advance in the state machine of a connection. Will not block */
+/*
+ * Advance in the state machine of a connection. Will not block.
+ * A connection starts with the text protocol and is switched to the binary
+ * one when the client sends the BINARY command.
+ */
 int32_t iiod_conn_step(struct iiod_desc *desc, uint32_t conn_id);
+/*
+ * Return true if the connection can't advance until more data is received
+ * from the client or, during a buffer transfer, from the device. Event driven
+ * backends can sleep until the connection is readable or the device has new
+ * data instead of calling iiod_conn_step.
+ */
+bool iiod_conn_is_idle(struct iiod_desc *desc, uint32_t conn_id);
 
 #endif //IIOD_H
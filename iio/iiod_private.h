@@ -40,6 +40,21 @@
 #define IIOD_ENDL			0x2
 #define IIOD_RD				0x4
 #define IIOD_PARSER_MAX_BUF_SIZE	128
+/* Size of a binary protocol command header on the wire */
+#define IIOD_BIN_CMD_SIZE		8
+/* Size of the length field preceding a binary command payload */
+#define IIOD_BIN_LEN_SIZE		8
+/* Number of buffers a binary connection can create */
+#ifndef IIOD_BIN_MAX_BUFFERS
+#define IIOD_BIN_MAX_BUFFERS		2
+#endif
+/* Number of blocks of a buffer created by a binary connection */
+#ifndef IIOD_BIN_MAX_BLOCKS
+#define IIOD_BIN_MAX_BLOCKS		8
+#endif
+/* Buffer and block ids in the code of binary buffer and block commands */
+#define IIOD_BIN_BUF_ID(code)		((uint32_t)(code) & 0xFFFF)
+#define IIOD_BIN_BLOCK_ID(code)		((uint32_t)(code) >> 16)
 
 #define IIOD_STR(cmd) {(cmd), sizeof(cmd) - 1}
 
@@ -71,7 +86,81 @@ enum iiod_cmd {
 	IIOD_CMD_WRITEBUF,
 	IIOD_CMD_GETTRIG,
 	IIOD_CMD_SETTRIG,
-	IIOD_CMD_SET
+	IIOD_CMD_SET,
+	IIOD_CMD_BINARY
+};
+
+/*
+ * Opcodes of the binary protocol. Numbering follows the one used by libiio so
+ * new values must only be appended.
+ */
+enum iiod_bin_op {
+	IIOD_BIN_OP_RESPONSE,
+	IIOD_BIN_OP_PRINT,
+	IIOD_BIN_OP_TIMEOUT,
+	IIOD_BIN_OP_READ_ATTR,
+	IIOD_BIN_OP_READ_DBG_ATTR,
+	IIOD_BIN_OP_READ_BUF_ATTR,
+	IIOD_BIN_OP_READ_CHN_ATTR,
+	IIOD_BIN_OP_WRITE_ATTR,
+	IIOD_BIN_OP_WRITE_DBG_ATTR,
+	IIOD_BIN_OP_WRITE_BUF_ATTR,
+	IIOD_BIN_OP_WRITE_CHN_ATTR,
+	IIOD_BIN_OP_GETTRIG,
+	IIOD_BIN_OP_SETTRIG,
+	IIOD_BIN_OP_CREATE_BUFFER,
+	IIOD_BIN_OP_FREE_BUFFER,
+	IIOD_BIN_OP_ENABLE_BUFFER,
+	IIOD_BIN_OP_DISABLE_BUFFER,
+	IIOD_BIN_OP_CREATE_BLOCK,
+	IIOD_BIN_OP_FREE_BLOCK,
+	IIOD_BIN_OP_TRANSFER_BLOCK,
+	IIOD_BIN_OP_ENQUEUE_BLOCK_CYCLIC,
+	IIOD_BIN_OP_RETRY_DEQUEUE_BLOCK,
+	IIOD_BIN_OP_CREATE_EVSTREAM,
+	IIOD_BIN_OP_FREE_EVSTREAM,
+	IIOD_BIN_OP_READ_EVENT,
+	/* Not in libiio. Read or write a list of attributes at once */
+	IIOD_BIN_OP_READ_ATTRS,
+	IIOD_BIN_OP_WRITE_ATTRS,
+	IIOD_BIN_NB_OPS
+};
+
+/*
+ * Header of a binary protocol command. On the wire it is IIOD_BIN_CMD_SIZE
+ * bytes long with all fields in little endian.
+ * Every command is answered with an IIOD_BIN_OP_RESPONSE header having the
+ * same client_id. code holds the result and, for commands returning data, the
+ * number of bytes following the header.
+ *
+ * The payloads follow the libiio iiod-responder layout:
+ * - Attribute writes are followed by a 64 bit little endian length and the
+ *   value.
+ * - CREATE_BUFFER, FREE_BUFFER, ENABLE_BUFFER and DISABLE_BUFFER have the
+ *   buffer id in code. CREATE_BUFFER is followed by the channel mask, one 32
+ *   bit word per 32 channels of the device, and is answered with the mask.
+ * - Block commands have the buffer id in the lower 16 bits of code and the
+ *   block id in the upper 16 bits. CREATE_BLOCK is followed by the 64 bit
+ *   size of the block. TRANSFER_BLOCK is followed by the 64 bit number of
+ *   bytes used and, for output buffers, by the data. For input buffers the
+ *   data is sent in the response.
+ *
+ * READ_ATTRS and WRITE_ATTRS carry a list of IIOD_BIN_CMD_SIZE entries laid
+ * out as command headers with client_id ignored, each one being a single
+ * attribute read (or write) command. In WRITE_ATTRS every entry is followed by
+ * a 32 bit length and the value, padded to 4 bytes. Attributes may belong to
+ * any device. The response data holds, for each entry, its 32 bit result and
+ * for reads the value padded to 4 bytes.
+ */
+struct iiod_bin_cmd {
+	/* Set by the client. Echoed back in the response */
+	uint16_t client_id;
+	/* Value from enum iiod_bin_op */
+	uint8_t op;
+	/* Index of the device in the context xml */
+	uint8_t dev;
+	/* Command specific argument or result */
+	int32_t code;
 };
 
 /*
@@ -80,7 +169,8 @@ enum iiod_cmd {
  */
 struct comand_desc {
 	enum iiod_cmd cmd;
-	uint32_t mask;
+	uint32_t mask[IIOD_MASK_WORDS];
+	uint32_t mask_words;
 	uint32_t timeout;
 	uint32_t sample_count;
 	uint32_t bytes_count;
@@ -93,6 +183,30 @@ struct comand_desc {
 	enum iio_attr_type type;
 };
 
+/* Buffer created by a binary CREATE_BUFFER command */
+struct iiod_bin_buffer {
+	/* Set while the buffer exists */
+	bool used;
+	/* Set while the device is open for the buffer */
+	bool enabled;
+	/* Set if the channels of the buffer are outputs */
+	bool output;
+	/* Index of the device in the context xml */
+	uint8_t dev;
+	/* Buffer id chosen by the client */
+	uint16_t id;
+	/* Size in bytes of a scan of the enabled channels */
+	uint32_t sample_size;
+	/* Mask of the channels of the buffer */
+	uint32_t mask[IIOD_MASK_WORDS];
+	/* Number of words of mask set by the client */
+	uint32_t mask_words;
+	/* Size in bytes of each block, 0 for blocks not created */
+	uint32_t block_size[IIOD_BIN_MAX_BLOCKS];
+	/* Bytes used in the last transfer of each block */
+	uint32_t bytes_used[IIOD_BIN_MAX_BLOCKS];
+};
+
 /* Used to store buffer indexes for non blocking transfers */
 struct iiod_buff {
 	char *buf;
@@ -136,6 +250,16 @@ struct iiod_conn_priv {
 		IIOD_LINE_DONE,
 		/* Pushing  cyclic buffer until IIO device is closed  */
 		IIOD_PUSH_CYCLIC_BUFFER,
+		/* Reading a binary command header */
+		IIOD_BIN_READING_CMD,
+		/* Reading the length of a binary command payload */
+		IIOD_BIN_READING_LEN,
+		/* Write the response header of a binary command */
+		IIOD_BIN_WRITING_RESPONSE,
+		/* I/O operations for binary block transfers */
+		IIOD_BIN_RW_BUF,
+		/* Sending the context xml chunk by chunk */
+		IIOD_WRITING_XML,
 	} state;
 
 	/* Buffer to store received line */
@@ -148,15 +272,37 @@ struct iiod_conn_priv {
 	uint32_t payload_buf_len;
 	/* Used in nonbloking transfers to save indexes */
 	struct iiod_buff nb_buf;
+	/* Offset in the context xml of the chunk in nb_buf */
+	uint32_t xml_offset;
+
+	/* Set after the BINARY command is executed on the connection */
+	bool binary;
+	/* Binary command being processed */
+	struct iiod_bin_cmd bin_cmd;
+	/* Raw binary command header or payload length */
+	uint8_t bin_raw[IIOD_BIN_LEN_SIZE];
+	/* Buffers created by the client */
+	struct iiod_bin_buffer bin_bufs[IIOD_BIN_MAX_BUFFERS];
+	/* Buffer of the block being transferred */
+	struct iiod_bin_buffer *bin_buf;
+	/* Error of an output block, reported after its data is dropped */
+	int32_t bin_err;
 
 	/* Mask of current opened buffer */
-	uint32_t mask;
+	uint32_t mask[IIOD_MASK_WORDS];
+	/* Number of words of mask set by the client */
+	uint32_t mask_words;
 	/* Buffer to store mask as a string */
-	char buf_mask[10];
+	char buf_mask[IIOD_MASK_WORDS * 8 + 1];
 	/* Context for strtok_r function */
 	char *strtok_ctx;
 	/* True if the device was open with cyclic buffer flag */
 	bool is_cyclic_buffer;
+	/*
+	 * Set when the last step stopped because the client or the device had
+	 * no data for the buffer transfer in progress
+	 */
+	bool waiting_data;
 };
 
 /* Private iiod information */
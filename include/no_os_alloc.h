@@ -35,6 +35,97 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+
+/*
+ * Allocator backends, selected at build time:
+ * - default: no_os_malloc/no_os_calloc/no_os_free are weak wrappers over the
+ *   C library.
+ * - NO_OS_ALLOC_POOL: requests of up to 2048 bytes are served in constant
+ *   time from static pools of fixed size blocks. The number of blocks of each
+ *   size is set with NO_OS_ALLOC_POOL_NB_<size> (0 disables a size). Bigger
+ *   requests, or requests finding their pools empty, go to the heap backend,
+ *   unless NO_OS_ALLOC_POOL_STRICT is defined, in which case they fail.
+ * - NO_OS_ALLOC_ARENA_SIZE=<bytes>: the heap backend is a static bump arena
+ *   instead of the C library. Freed arena memory is not reused, which fits
+ *   memory that is allocated once at initialization.
+ * Any of them, or NO_OS_ALLOC_STATS, enables the statistics below. The
+ * allocator then stores a small header in front of each block, so the
+ * allocation functions must not be overridden. Platforms with their own heap
+ * provide no_os_alloc_heap_malloc/no_os_alloc_heap_free instead, which the
+ * allocator uses in place of the C library.
+ *
+ * Allocations are accounted per tag. A translation unit defining
+ * NO_OS_ALLOC_TAG before its includes has its no_os_malloc/no_os_calloc
+ * calls accounted under that tag.
+ */
+#if defined(NO_OS_ALLOC_POOL) || defined(NO_OS_ALLOC_ARENA_SIZE)
+#ifndef NO_OS_ALLOC_STATS
+#define NO_OS_ALLOC_STATS
+#endif
+#endif
+
+/**
+ * @enum no_os_alloc_tag
+ * @brief Subsystems for which the allocations are accounted separately.
+ */
+enum no_os_alloc_tag {
+	NO_OS_ALLOC_TAG_DEFAULT,
+	NO_OS_ALLOC_TAG_IIO,
+	NO_OS_ALLOC_TAG_SPI,
+	NO_OS_ALLOC_TAG_LIST,
+	NO_OS_ALLOC_TAG_MAX
+};
+
+/**
+ * @struct no_os_alloc_stats
+ * @brief Allocation statistics of a tag.
+ */
+struct no_os_alloc_stats {
+	/** Bytes currently allocated */
+	uint32_t in_use;
+	/** Highest value reached by in_use */
+	uint32_t peak;
+	/** Number of successful allocations */
+	uint32_t nb_allocs;
+	/** Number of frees */
+	uint32_t nb_frees;
+	/** Number of failed allocations */
+	uint32_t nb_failed;
+	/** Bytes lost in the pool blocks currently allocated, by rounding up */
+	uint32_t wasted;
+};
+
+/**
+ * @struct no_os_alloc_pool_stats
+ * @brief Usage of the pool of blocks of one size.
+ */
+struct no_os_alloc_pool_stats {
+	/** Usable size of a block */
+	uint32_t block_size;
+	/** Number of blocks of the pool */
+	uint32_t nb_blocks;
+	/** Blocks currently allocated */
+	uint32_t used;
+	/** Highest value reached by used */
+	uint32_t peak;
+};
+
+/**
+ * @struct no_os_arena
+ * @brief Bump allocator over a user provided buffer. Memory is given back
+ * only all at once, by no_os_arena_reset.
+ */
+struct no_os_arena {
+	/** Start of the buffer */
+	uint8_t *buf;
+	/** Size of the buffer */
+	size_t size;
+	/** Bytes allocated since the last reset */
+	size_t used;
+	/** Highest value reached by used */
+	size_t peak;
+};
 
 /* Allocate memory and return a pointer to it */
 void *no_os_malloc(size_t size);
@@ -46,4 +137,42 @@ void *no_os_calloc(size_t nitems, size_t size);
  * no_os_malloc */
 void no_os_free(void *ptr);
 
+/* no_os_malloc, accounting the allocation under tag */
+void *no_os_malloc_tag(size_t size, enum no_os_alloc_tag tag);
+
+/* no_os_calloc, accounting the allocation under tag */
+void *no_os_calloc_tag(size_t nitems, size_t size, enum no_os_alloc_tag tag);
+
+/* Get the allocation statistics of a tag */
+int no_os_alloc_get_stats(enum no_os_alloc_tag tag,
+			  struct no_os_alloc_stats *stats);
+
+/* Get the usage of the pool number idx, -ENOENT past the last pool */
+int no_os_alloc_get_pool_stats(uint32_t idx,
+			       struct no_os_alloc_pool_stats *stats);
+
+/* Get the name of a tag */
+const char *no_os_alloc_tag_name(enum no_os_alloc_tag tag);
+
+/* Heap backend of the allocator with NO_OS_ALLOC_STATS, malloc by default */
+void *no_os_alloc_heap_malloc(size_t size);
+
+/* Heap backend of the allocator with NO_OS_ALLOC_STATS, free by default */
+void no_os_alloc_heap_free(void *ptr);
+
+/* Use buf as the memory of an arena */
+int no_os_arena_init(struct no_os_arena *arena, void *buf, size_t size);
+
+/* Allocate from an arena, NULL if there is not enough memory left */
+void *no_os_arena_alloc(struct no_os_arena *arena, size_t size);
+
+/* Free everything allocated from an arena */
+void no_os_arena_reset(struct no_os_arena *arena);
+
+#ifdef NO_OS_ALLOC_TAG
+#define no_os_malloc(size)		no_os_malloc_tag(size, NO_OS_ALLOC_TAG)
+#define no_os_calloc(nitems, size)	no_os_calloc_tag(nitems, size, \
+					NO_OS_ALLOC_TAG)
+#endif
+
 #endif // _NO_OS_ALLOC_H_
@@ -42,4 +42,12 @@ int32_t no_os_axi_io_read(uint32_t base, uint32_t offset, uint32_t *data);
 /* AXI IO Write data */
 int32_t no_os_axi_io_write(uint32_t base, uint32_t offset, uint32_t data);
 
+/* AXI IO Read len consecutive 32 bit registers starting at offset */
+int32_t no_os_axi_io_read_bulk(uint32_t base, uint32_t offset, uint32_t *data,
+			       uint32_t len);
+
+/* AXI IO Write len consecutive 32 bit registers starting at offset */
+int32_t no_os_axi_io_write_bulk(uint32_t base, uint32_t offset,
+				const uint32_t *data, uint32_t len);
+
 #endif // _NO_OS_AXI_IO_H_
@@ -38,12 +38,22 @@
 
 #define NO_OS_CRC16_TABLE_SIZE 256
 
+#define NO_OS_CRC16_SLICES 4
+
 #define NO_OS_DECLARE_CRC16_TABLE(_table) \
 	static uint16_t _table[NO_OS_CRC16_TABLE_SIZE]
 
+/* Slicing-by-4 tables, _table[0] is also a regular CRC-16 table */
+#define NO_OS_DECLARE_CRC16_SLICE_TABLE(_table) \
+	static uint16_t _table[NO_OS_CRC16_SLICES][NO_OS_CRC16_TABLE_SIZE]
+
 void no_os_crc16_populate_msb(uint16_t * table, const uint16_t polynomial);
 uint16_t no_os_crc16(const uint16_t * table, const uint8_t *pdata,
 		     size_t nbytes,
 		     uint16_t crc);
+void no_os_crc16_populate_msb_slice(uint16_t (*table)[NO_OS_CRC16_TABLE_SIZE],
+				    const uint16_t polynomial);
+uint16_t no_os_crc16_slice(const uint16_t (*table)[NO_OS_CRC16_TABLE_SIZE],
+			   const uint8_t *pdata, size_t nbytes, uint16_t crc);
 
 #endif // _NO_OS_CRC16_H_
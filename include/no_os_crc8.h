@@ -38,12 +38,24 @@
 
 #define NO_OS_CRC8_TABLE_SIZE 256
 
+#define NO_OS_CRC8_SLICES 4
+
 #define NO_OS_DECLARE_CRC8_TABLE(_table) \
 	static uint8_t _table[NO_OS_CRC8_TABLE_SIZE]
 
+/* Slicing-by-4 tables, _table[0] is also a regular CRC-8 table */
+#define NO_OS_DECLARE_CRC8_SLICE_TABLE(_table) \
+	static uint8_t _table[NO_OS_CRC8_SLICES][NO_OS_CRC8_TABLE_SIZE]
+
 void no_os_crc8_populate_msb(uint8_t * table, const uint8_t polynomial);
 void no_os_crc8_populate_lsb(uint8_t * table, const uint8_t polynomial);
 uint8_t no_os_crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 		   uint8_t crc);
+void no_os_crc8_populate_msb_slice(uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE],
+				   const uint8_t polynomial);
+void no_os_crc8_populate_lsb_slice(uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE],
+				   const uint8_t polynomial);
+uint8_t no_os_crc8_slice(const uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE],
+			 const uint8_t *pdata, size_t nbytes, uint8_t crc);
 
 #endif // _NO_OS_CRC8_H_
@@ -98,6 +98,9 @@ struct no_os_dma_xfer_desc {
 
 	/** User or platform defined data */
 	void *extra;
+
+	/** Link in the channel's list of transfers, handled by the DMA layer */
+	struct no_os_list_node node;
 };
 
 /**
@@ -109,8 +112,8 @@ struct no_os_dma_ch {
 	uint32_t id;
 	/** Whether or not there is a transfer in progress on this channel */
 	bool free;
-	/** List of transfers for this channel */
-	struct no_os_list_desc *sg_list;
+	/** List of transfers for this channel, linked through their node */
+	struct no_os_list_node sg_list;
 	/** Channel specific interrupt line number */
 	uint32_t irq_num;
 	/** irq callback */
@@ -39,6 +39,9 @@
 #define NO_OS_GPIO_OUT	0x01
 #define NO_OS_GPIO_IN		0x00
 
+/* Maximum number of GPIOs in a group, one bit of the group value per GPIO */
+#define NO_OS_GPIO_GROUP_MAX	32
+
 /**
  * @struct no_os_gpio_platform_ops
  * @brief Structure holding gpio function pointers that point to the platform
@@ -94,6 +97,49 @@ struct no_os_gpio_desc {
 	void		*extra;
 };
 
+/**
+ * @struct no_os_gpio_group_init_param
+ * @brief Structure holding the parameters for GPIO group initialization.
+ */
+struct no_os_gpio_group_init_param {
+	/** Port number, common to all the GPIOs of the group */
+	int32_t		port;
+	/** GPIO numbers, bit n of the group values maps to numbers[n] */
+	const int32_t	*numbers;
+	/** Number of GPIOs in the group */
+	uint32_t	num;
+	/** Pull up/down resistor configuration */
+	enum no_os_gpio_pull_up pull;
+	/** GPIO platform specific functions */
+	const struct no_os_gpio_platform_ops *platform_ops;
+	/** GPIO extra parameters (device specific) */
+	void		*extra;
+};
+
+/**
+ * @struct no_os_gpio_group_desc
+ * @brief Structure holding the GPIO group descriptor.
+ */
+struct no_os_gpio_group_desc {
+	/** Port number */
+	int32_t		port;
+	/** GPIO numbers */
+	int32_t		numbers[NO_OS_GPIO_GROUP_MAX];
+	/** Number of GPIOs in the group */
+	uint32_t	num;
+	/** Pull up/down resistor configuration */
+	enum no_os_gpio_pull_up pull;
+	/**
+	 * Per GPIO descriptors, used when the platform doesn't implement the
+	 * group operations.
+	 */
+	struct no_os_gpio_desc **gpios;
+	/** GPIO platform specific functions */
+	const struct no_os_gpio_platform_ops *platform_ops;
+	/** GPIO extra parameters (device specific) */
+	void		*extra;
+};
+
 /**
  * @enum no_os_gpio_values
  * @brief Enum that holds the possible output states of a GPIO.
@@ -131,6 +177,22 @@ struct no_os_gpio_platform_ops {
 	int32_t (*gpio_ops_set_value)(struct no_os_gpio_desc *, uint8_t);
 	/** gpio get value function pointer */
 	int32_t (*gpio_ops_get_value)(struct no_os_gpio_desc *, uint8_t *);
+	/** gpio group initialization function pointer */
+	int32_t (*gpio_ops_group_get)(struct no_os_gpio_group_desc **,
+				      const struct no_os_gpio_group_init_param *);
+	/** gpio group remove function pointer */
+	int32_t (*gpio_ops_group_remove)(struct no_os_gpio_group_desc *);
+	/** gpio group direction input function pointer */
+	int32_t (*gpio_ops_group_direction_input)(struct no_os_gpio_group_desc *);
+	/** gpio group direction output function pointer */
+	int32_t (*gpio_ops_group_direction_output)(struct no_os_gpio_group_desc *,
+			uint32_t);
+	/** gpio group set values function pointer */
+	int32_t (*gpio_ops_group_set_values)(struct no_os_gpio_group_desc *,
+					     uint32_t, uint32_t);
+	/** gpio group get values function pointer */
+	int32_t (*gpio_ops_group_get_values)(struct no_os_gpio_group_desc *,
+					     uint32_t *);
 };
 
 /* Obtain the GPIO decriptor. */
@@ -163,4 +225,26 @@ int32_t no_os_gpio_set_value(struct no_os_gpio_desc *desc,
 int32_t no_os_gpio_get_value(struct no_os_gpio_desc *desc,
 			     uint8_t *value);
 
+/* Obtain a descriptor for a group of GPIOs of the same port. */
+int32_t no_os_gpio_group_get(struct no_os_gpio_group_desc **desc,
+			     const struct no_os_gpio_group_init_param *param);
+
+/* Free the resources allocated by no_os_gpio_group_get(). */
+int32_t no_os_gpio_group_remove(struct no_os_gpio_group_desc *desc);
+
+/* Enable the input direction of all the GPIOs of the group. */
+int32_t no_os_gpio_group_direction_input(struct no_os_gpio_group_desc *desc);
+
+/* Enable the output direction of all the GPIOs of the group. */
+int32_t no_os_gpio_group_direction_output(struct no_os_gpio_group_desc *desc,
+		uint32_t values);
+
+/* Set the GPIOs of the group selected by mask to the bits of values. */
+int32_t no_os_gpio_group_set_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t mask, uint32_t values);
+
+/* Get the values of all the GPIOs of the group. */
+int32_t no_os_gpio_group_get_values(struct no_os_gpio_group_desc *desc,
+				    uint32_t *values);
+
 #endif // _NO_OS_GPIO_H_
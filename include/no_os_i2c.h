@@ -38,6 +38,23 @@
 
 #define I2C_MAX_BUS_NUMBER 4
 
+/* no_os_i2c_msg flags */
+#define NO_OS_I2C_M_RD		0x0001
+
+/**
+ * @struct no_os_i2c_msg
+ * @brief Segment of a combined I2C transaction. Consecutive messages are
+ * separated by a repeated start and a stop is generated after the last one.
+ */
+struct no_os_i2c_msg {
+	/** Bytes to write, or buffer for the read bytes */
+	uint8_t		*buf;
+	/** Number of bytes */
+	uint32_t	len;
+	/** NO_OS_I2C_M_RD to read, 0 to write */
+	uint16_t	flags;
+};
+
 /**
  * @struct no_os_i2c_platform_ops
  * @brief Structure holding I2C function pointers that point to the platform
@@ -116,6 +133,9 @@ struct no_os_i2c_platform_ops {
 	int32_t (*i2c_ops_read)(struct no_os_i2c_desc *, uint8_t *, uint8_t, uint8_t);
 	/** i2c remove function pointer */
 	int32_t (*i2c_ops_remove)(struct no_os_i2c_desc *);
+	/** i2c combined transaction function pointer */
+	int32_t (*i2c_ops_transfer)(struct no_os_i2c_desc *, struct no_os_i2c_msg *,
+				    uint32_t);
 };
 
 /* Initialize the I2C communication peripheral. */
@@ -137,6 +157,11 @@ int32_t no_os_i2c_read(struct no_os_i2c_desc *desc,
 		       uint8_t bytes_number,
 		       uint8_t stop_bit);
 
+/* Send messages as one combined transaction. */
+int32_t no_os_i2c_transfer(struct no_os_i2c_desc *desc,
+			   struct no_os_i2c_msg *msgs,
+			   uint32_t nb_msgs);
+
 /* Initialize I2C bus descriptor*/
 int32_t no_os_i2cbus_init(const struct no_os_i2c_init_param *param);
 
@@ -0,0 +1,164 @@
+/***************************************************************************//**
+ *   @file   no_os_lffifo.h
+ *   @brief  SPSC lock-free fifo generated for a given element type and size.
+********************************************************************************
+ *   @copyright
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef _NO_OS_LFFIFO_H_
+#define _NO_OS_LFFIFO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * NO_OS_LFFIFO_DEFINE(name, type, capacity) defines struct name, holding up
+ * to capacity elements of type, and the static inline functions below to
+ * access it. capacity must be a power of two.
+ *
+ * One producer and one consumer can use the fifo at the same time, e.g. an
+ * interrupt handler and the main loop, without locking. head is written only
+ * by the producer and tail only by the consumer, with release semantics so
+ * the elements are visible to the other side before the index.
+ * A zeroed structure is an empty fifo.
+ *
+ * Producer side:
+ *	int name_write(struct name *fifo, type val);
+ *		0 or -1 if the fifo is full.
+ *	uint32_t name_write_bulk(struct name *fifo, const type *vals,
+ *				 uint32_t nb);
+ *		Number of elements written, at most nb.
+ *	uint32_t name_space(struct name *fifo);
+ *	bool name_is_full(struct name *fifo);
+ *
+ * Consumer side:
+ *	int name_read(struct name *fifo, type *val);
+ *		0 or -1 if the fifo is empty.
+ *	uint32_t name_read_bulk(struct name *fifo, type *vals, uint32_t nb);
+ *		Number of elements read, at most nb.
+ *	uint32_t name_used(struct name *fifo);
+ *	bool name_is_empty(struct name *fifo);
+ *	void name_flush(struct name *fifo);
+ */
+#define NO_OS_LFFIFO_DEFINE(name, type, capacity)				\
+_Static_assert((capacity) && !((capacity) & ((capacity) - 1)),		\
+	       #name " capacity must be a power of two");			\
+									\
+struct name {								\
+	type		data[capacity];					\
+	uint32_t	head;						\
+	uint32_t	tail;						\
+};									\
+									\
+static inline uint32_t name##_used(struct name *fifo)			\
+{									\
+	return __atomic_load_n(&fifo->head, __ATOMIC_ACQUIRE) - fifo->tail;	\
+}									\
+									\
+static inline uint32_t name##_space(struct name *fifo)			\
+{									\
+	return (capacity) - (fifo->head -				\
+			     __atomic_load_n(&fifo->tail, __ATOMIC_ACQUIRE));	\
+}									\
+									\
+static inline bool name##_is_empty(struct name *fifo)			\
+{									\
+	return !name##_used(fifo);					\
+}									\
+									\
+static inline bool name##_is_full(struct name *fifo)			\
+{									\
+	return !name##_space(fifo);					\
+}									\
+									\
+static inline int name##_write(struct name *fifo, type val)		\
+{									\
+	if (name##_is_full(fifo))					\
+		return -1;						\
+									\
+	fifo->data[fifo->head & ((capacity) - 1)] = val;		\
+	__atomic_store_n(&fifo->head, fifo->head + 1, __ATOMIC_RELEASE);	\
+									\
+	return 0;							\
+}									\
+									\
+static inline int name##_read(struct name *fifo, type *val)		\
+{									\
+	if (name##_is_empty(fifo))					\
+		return -1;						\
+									\
+	*val = fifo->data[fifo->tail & ((capacity) - 1)];		\
+	__atomic_store_n(&fifo->tail, fifo->tail + 1, __ATOMIC_RELEASE);	\
+									\
+	return 0;							\
+}									\
+									\
+static inline uint32_t name##_write_bulk(struct name *fifo,		\
+		const type *vals, uint32_t nb)				\
+{									\
+	uint32_t idx = fifo->head & ((capacity) - 1);			\
+	uint32_t space = name##_space(fifo);				\
+	uint32_t first;							\
+									\
+	if (nb > space)							\
+		nb = space;						\
+	first = (capacity) - idx < nb ? (capacity) - idx : nb;		\
+	memcpy(&fifo->data[idx], vals, first * sizeof(type));		\
+	memcpy(fifo->data, vals + first, (nb - first) * sizeof(type));	\
+	__atomic_store_n(&fifo->head, fifo->head + nb, __ATOMIC_RELEASE);	\
+									\
+	return nb;							\
+}									\
+									\
+static inline uint32_t name##_read_bulk(struct name *fifo, type *vals,	\
+		uint32_t nb)						\
+{									\
+	uint32_t idx = fifo->tail & ((capacity) - 1);			\
+	uint32_t used = name##_used(fifo);				\
+	uint32_t first;							\
+									\
+	if (nb > used)							\
+		nb = used;						\
+	first = (capacity) - idx < nb ? (capacity) - idx : nb;		\
+	memcpy(vals, &fifo->data[idx], first * sizeof(type));		\
+	memcpy(vals + first, fifo->data, (nb - first) * sizeof(type));	\
+	__atomic_store_n(&fifo->tail, fifo->tail + nb, __ATOMIC_RELEASE);	\
+									\
+	return nb;							\
+}									\
+									\
+static inline void name##_flush(struct name *fifo)			\
+{									\
+	__atomic_store_n(&fifo->tail,					\
+			 __atomic_load_n(&fifo->head, __ATOMIC_ACQUIRE),	\
+			 __ATOMIC_RELEASE);					\
+}
+
+#endif //_NO_OS_LFFIFO_H_
@@ -86,6 +86,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * @struct no_os_list_desc
@@ -304,4 +305,108 @@ int32_t no_os_list_get_find(struct no_os_list_desc *list_desc, void **data,
 			    void *cmp_data);
 /** @}*/
 
+/**
+ * @name Intrusive list
+ * Circular double linked list whose nodes are embedded in the user structure,
+ * so adding and removing elements never allocates and takes constant time.
+ * Usable from interrupt handlers. A node may be in only one list at a time.
+ * @code{.c}
+ *	struct xfer {
+ *		uint32_t len;
+ *		struct no_os_list_node node;
+ *	};
+ *	struct no_os_list_node queue = NO_OS_LIST_NODE_INIT(queue);
+ *
+ *	no_os_list_node_add_last(&queue, &x->node);
+ *	x = no_os_list_entry(no_os_list_node_first(&queue), struct xfer, node);
+ * @endcode
+ * @{
+ */
+
+/**
+ * @struct no_os_list_node
+ * @brief Intrusive list node, also used as the list head.
+ */
+struct no_os_list_node {
+	struct no_os_list_node *next;
+	struct no_os_list_node *prev;
+};
+
+/** Static initializer of an empty list head */
+#define NO_OS_LIST_NODE_INIT(name)	{ &(name), &(name) }
+
+/** Get the structure containing the node ptr, embedded as member */
+#define no_os_list_entry(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+
+/** Iterate over the nodes of head. pos must not be removed from the list. */
+#define no_os_list_node_for_each(pos, head) \
+	for ((pos) = (head)->next; (pos) != (head); (pos) = (pos)->next)
+
+/** Initialize head as an empty list or node as not being in any list. */
+static inline void no_os_list_node_init(struct no_os_list_node *head)
+{
+	head->next = head;
+	head->prev = head;
+}
+
+/** Return true if there is no node in head. */
+static inline bool no_os_list_node_empty(const struct no_os_list_node *head)
+{
+	return head->next == head;
+}
+
+/** Insert node between prev and next. */
+static inline void _no_os_list_node_add(struct no_os_list_node *node,
+					struct no_os_list_node *prev,
+					struct no_os_list_node *next)
+{
+	next->prev = node;
+	node->next = next;
+	node->prev = prev;
+	prev->next = node;
+}
+
+/** Add node at the beginning of head. */
+static inline void no_os_list_node_add_first(struct no_os_list_node *head,
+		struct no_os_list_node *node)
+{
+	_no_os_list_node_add(node, head, head->next);
+}
+
+/** Add node at the end of head. */
+static inline void no_os_list_node_add_last(struct no_os_list_node *head,
+		struct no_os_list_node *node)
+{
+	_no_os_list_node_add(node, head->prev, head);
+}
+
+/** Remove node from the list it is in. */
+static inline void no_os_list_node_del(struct no_os_list_node *node)
+{
+	node->next->prev = node->prev;
+	node->prev->next = node->next;
+	no_os_list_node_init(node);
+}
+
+/** Return the first node of head or NULL if the list is empty. */
+static inline struct no_os_list_node *no_os_list_node_first(
+	const struct no_os_list_node *head)
+{
+	return no_os_list_node_empty(head) ? NULL : head->next;
+}
+
+/** Remove and return the first node of head or NULL if the list is empty. */
+static inline struct no_os_list_node *no_os_list_node_pop_first(
+	struct no_os_list_node *head)
+{
+	struct no_os_list_node *node = no_os_list_node_first(head);
+
+	if (node)
+		no_os_list_node_del(node);
+
+	return node;
+}
+/** @}*/
+
 #endif // _NO_OS_LIST_H_
@@ -0,0 +1,229 @@
+/***************************************************************************//**
+ *   @file   no_os_regmap.h
+ *   @brief  Header file of the register map layer.
+********************************************************************************
+ *   @copyright
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef _NO_OS_REGMAP_H_
+#define _NO_OS_REGMAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum number of value bytes moved by one bus burst */
+#define NO_OS_REGMAP_BURST_MAX	64
+
+struct no_os_regmap;
+
+/**
+ * @struct no_os_regmap_range
+ * @brief Registers min to max, both included.
+ */
+struct no_os_regmap_range {
+	uint32_t min;
+	uint32_t max;
+};
+
+/**
+ * @struct no_os_regmap_table
+ * @brief Set of registers, made of ranges.
+ */
+struct no_os_regmap_table {
+	const struct no_os_regmap_range	*ranges;
+	uint32_t			nb_ranges;
+};
+
+/**
+ * @struct no_os_regmap_reg_seq
+ * @brief Register and value pair, used for reset defaults and write
+ * sequences.
+ */
+struct no_os_regmap_reg_seq {
+	uint32_t reg;
+	uint32_t val;
+};
+
+/**
+ * @enum no_os_regmap_cache_type
+ * @brief Register cache kinds.
+ */
+enum no_os_regmap_cache_type {
+	/** Every access goes to the bus */
+	NO_OS_REGMAP_CACHE_NONE,
+	/** One entry for each register up to max_register */
+	NO_OS_REGMAP_CACHE_FLAT,
+};
+
+/**
+ * @struct no_os_regmap_bus_ops
+ * @brief Bus access of a register map.
+ *
+ * Either reg_read/reg_write, working on one register value, or
+ * bulk_read/bulk_write must be set. The bulk operations move count registers
+ * starting at reg in one transaction, with the values in their raw bus
+ * format: val_bits rounded up to bytes, most significant byte first. count
+ * is 1 unless the map was initialized with burst set.
+ */
+struct no_os_regmap_bus_ops {
+	int (*reg_read)(struct no_os_regmap *map, uint32_t reg, uint32_t *val);
+	int (*reg_write)(struct no_os_regmap *map, uint32_t reg, uint32_t val);
+	int (*bulk_read)(struct no_os_regmap *map, uint32_t reg, uint8_t *data,
+			 uint32_t count);
+	int (*bulk_write)(struct no_os_regmap *map, uint32_t reg,
+			  const uint8_t *data, uint32_t count);
+};
+
+/**
+ * @struct no_os_regmap_init_param
+ * @brief Register map initialization parameters.
+ */
+struct no_os_regmap_init_param {
+	/** Bus access */
+	const struct no_os_regmap_bus_ops	*bus_ops;
+	/** Descriptor of the bus, or context of the driver bus_ops */
+	void					*bus;
+	/** Address width, in bits */
+	uint8_t					reg_bits;
+	/** Register width, in bits, up to 32 */
+	uint8_t					val_bits;
+	/** Set in the address sent on the bus for reads */
+	uint32_t				read_flag_mask;
+	/** Set in the address sent on the bus for writes */
+	uint32_t				write_flag_mask;
+	/** Highest register address */
+	uint32_t				max_register;
+	/** Set if the device increments the address in multi-byte transfers */
+	bool					burst;
+	/** Registers that can be read. All of them if NULL */
+	const struct no_os_regmap_table		*rd_table;
+	/** Registers that can be written. All of them if NULL */
+	const struct no_os_regmap_table		*wr_table;
+	/** Registers changed by the device, which are never cached */
+	const struct no_os_regmap_table		*volatile_table;
+	/** Cache kind */
+	enum no_os_regmap_cache_type		cache_type;
+	/** Known register values after reset, used to fill the cache */
+	const struct no_os_regmap_reg_seq	*reg_defaults;
+	/** Number of entries in reg_defaults */
+	uint32_t				nb_reg_defaults;
+};
+
+/**
+ * @struct no_os_regmap
+ * @brief Register map descriptor.
+ */
+struct no_os_regmap {
+	const struct no_os_regmap_bus_ops	*bus_ops;
+	void					*bus;
+	uint8_t					reg_bits;
+	uint8_t					val_bits;
+	/** Bytes of a value on the bus */
+	uint8_t					val_bytes;
+	uint32_t				read_flag_mask;
+	uint32_t				write_flag_mask;
+	uint32_t				max_register;
+	bool					burst;
+	const struct no_os_regmap_table		*rd_table;
+	const struct no_os_regmap_table		*wr_table;
+	const struct no_os_regmap_table		*volatile_table;
+	enum no_os_regmap_cache_type		cache_type;
+	/** Cached values, one uint8_t, uint16_t or uint32_t per register */
+	void					*cache;
+	/** Bitmap of the registers having a value in cache */
+	uint32_t				*cache_valid;
+	/** Bitmap of the cached registers not yet written to the device */
+	uint32_t				*cache_dirty;
+	/** Set when writes only update the cache */
+	bool					cache_only;
+};
+
+/**
+ * @brief Put the address of a register on the bus format, most significant
+ * byte first. Used by the bus implementations.
+ * @param map - The register map.
+ * @param reg - The register address.
+ * @param flag_mask - read_flag_mask or write_flag_mask of the map.
+ * @param buf - Where to write the address, at least 4 bytes.
+ * @return Number of bytes written in buf.
+ */
+static inline uint8_t no_os_regmap_format_reg(struct no_os_regmap *map,
+		uint32_t reg, uint32_t flag_mask, uint8_t *buf)
+{
+	uint8_t len = (map->reg_bits + 7) / 8;
+	uint8_t i;
+
+	reg |= flag_mask;
+	for (i = len; i > 0; i--) {
+		buf[i - 1] = reg & 0xFF;
+		reg >>= 8;
+	}
+
+	return len;
+}
+
+/* Bus access through the SPI API, implemented in no_os_regmap_spi.c */
+extern const struct no_os_regmap_bus_ops no_os_regmap_spi_ops;
+/* Bus access through the I2C API, implemented in no_os_regmap_i2c.c */
+extern const struct no_os_regmap_bus_ops no_os_regmap_i2c_ops;
+
+/* Initialize a register map */
+int no_os_regmap_init(struct no_os_regmap **map,
+		      const struct no_os_regmap_init_param *param);
+/* Free the resources allocated by no_os_regmap_init */
+int no_os_regmap_remove(struct no_os_regmap *map);
+
+/* Read a register, from the cache when possible */
+int no_os_regmap_read(struct no_os_regmap *map, uint32_t reg, uint32_t *val);
+/* Write a register */
+int no_os_regmap_write(struct no_os_regmap *map, uint32_t reg, uint32_t val);
+/* Read-modify-write the bits of mask. Only writes if the value changes */
+int no_os_regmap_update_bits(struct no_os_regmap *map, uint32_t reg,
+			     uint32_t mask, uint32_t val);
+/* Read count consecutive registers */
+int no_os_regmap_bulk_read(struct no_os_regmap *map, uint32_t reg,
+			   uint32_t *vals, uint32_t count);
+/* Write count consecutive registers */
+int no_os_regmap_bulk_write(struct no_os_regmap *map, uint32_t reg,
+			    const uint32_t *vals, uint32_t count);
+/* Write a sequence of registers, in order */
+int no_os_regmap_multi_reg_write(struct no_os_regmap *map,
+				 const struct no_os_regmap_reg_seq *seq,
+				 uint32_t count);
+
+/* When enabled, writes only update the cache until no_os_regmap_sync */
+void no_os_regmap_cache_only(struct no_os_regmap *map, bool enable);
+/* Mark all the cached registers as not written to the device */
+void no_os_regmap_mark_dirty(struct no_os_regmap *map);
+/* Forget all the cached values */
+void no_os_regmap_cache_drop(struct no_os_regmap *map);
+/* Write the dirty registers to the device */
+int no_os_regmap_sync(struct no_os_regmap *map);
+
+#endif // _NO_OS_REGMAP_H_
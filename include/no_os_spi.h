@@ -40,6 +40,19 @@
 #define	NO_OS_SPI_CPOL	0x02
 #define SPI_MAX_BUS_NUMBER 8
 
+/* Maximum number of messages and bytes of a no_os_spi_batch_begin() batch */
+#ifndef NO_OS_SPI_BATCH_MSGS
+#define NO_OS_SPI_BATCH_MSGS	32
+#endif
+#ifndef NO_OS_SPI_BATCH_BYTES
+#define NO_OS_SPI_BATCH_BYTES	256
+#endif
+
+/* Maximum number of messages merged in one transfer by the request queue */
+#ifndef NO_OS_SPI_QUEUE_MSGS
+#define NO_OS_SPI_QUEUE_MSGS	16
+#endif
+
 /**
  * @enum no_os_spi_mode
  * @brief SPI configuration for clock phase and polarity.
@@ -105,6 +118,30 @@ struct no_os_spi_msg {
 	uint32_t		cs_delay_last;
 };
 
+/**
+ * @struct no_os_spi_request
+ * @brief Batch of messages queued with no_os_spi_submit(). It is owned by the
+ * caller and must not be changed until its callback is called.
+ */
+struct no_os_spi_request {
+	/** Array of messages to be transferred */
+	struct no_os_spi_msg	*msgs;
+	/** Number of messages in the array */
+	uint32_t		len;
+	/**
+	 * Called once the messages are transferred, with the result of the
+	 * transfer. It may run in interrupt or worker thread context and may
+	 * submit new requests.
+	 */
+	void (*callback)(struct no_os_spi_request *req, int32_t ret);
+	/** User specific data for the callback */
+	void			*ctx;
+	/** SPI device of the request, set by no_os_spi_submit() */
+	struct no_os_spi_desc	*desc;
+	/** Next request in the bus queue */
+	struct no_os_spi_request *next;
+};
+
 /**
  * @struct no_os_platform_spi_delays
  * @brief Delays resulted from components in the SPI signal path. The values is ns.
@@ -171,8 +208,29 @@ struct no_os_spibus_desc {
 	const struct no_os_spi_platform_ops *platform_ops;
 	/** SPI bus extra */
 	void		*extra;
+	/**
+	 * Requests submitted since the queue was last processed, newest first.
+	 * Updated with atomic operations, so requests can be submitted from
+	 * interrupt context without the bus mutex.
+	 */
+	struct no_os_spi_request *queue_in;
+	/**
+	 * First and last request waiting in the bus queue, only accessed by
+	 * the context processing the queue
+	 */
+	struct no_os_spi_request *queue_head;
+	struct no_os_spi_request *queue_tail;
+	/** Requests being transferred */
+	struct no_os_spi_request *queue_batch;
+	/** Set while a context is processing the queue */
+	uint8_t		queue_busy;
+	/** Messages of the requests merged in one transfer */
+	struct no_os_spi_msg queue_msgs[NO_OS_SPI_QUEUE_MSGS];
 };
 
+/* Messages appended to a batch, allocated on the first use */
+struct no_os_spi_batch;
+
 /**
  * @struct no_os_spi_desc
  * @brief Structure holding SPI descriptor.
@@ -200,6 +258,13 @@ struct no_os_spi_desc {
 	void		*extra;
 	/** Parent of the device */
 	struct no_os_spi_desc *parent;
+	/** Transaction batch, see no_os_spi_batch_begin() */
+	struct no_os_spi_batch *batch;
+	/**
+	 * Result of the last transfer_dma_async transfer, set by the platforms
+	 * that report errors before calling the callback.
+	 */
+	int32_t		dma_async_ret;
 };
 
 /**
@@ -265,6 +330,24 @@ int32_t no_os_spi_transfer_dma_async(struct no_os_spi_desc *desc,
 /* Abort SPI transfers. */
 int32_t no_os_spi_transfer_abort(struct no_os_spi_desc *desc);
 
+/*
+ * Queue a request on the bus of the device and return. The callback of the
+ * request is invoked once its messages are transferred.
+ */
+int32_t no_os_spi_submit(struct no_os_spi_desc *desc,
+			 struct no_os_spi_request *req);
+
+/* Start collecting transactions to be sent in a single transfer */
+int32_t no_os_spi_batch_begin(struct no_os_spi_desc *desc);
+
+/* Add a transaction to the batch, or send it if no batch was started */
+int32_t no_os_spi_batch_append(struct no_os_spi_desc *desc,
+			       const uint8_t *tx, uint8_t *rx,
+			       uint16_t bytes_number);
+
+/* Send the transactions of the batch and close it */
+int32_t no_os_spi_batch_commit(struct no_os_spi_desc *desc);
+
 /* Initialize SPI bus descriptor*/
 int32_t no_os_spibus_init(const struct no_os_spi_init_param *param);
 
@@ -0,0 +1,87 @@
+/***************************************************************************//**
+ *   @file   no_os_spsc_ring.h
+ *   @brief  Header file of the lock-free single producer single consumer ring.
+********************************************************************************
+ *   @copyright
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef _NO_OS_SPSC_RING_H_
+#define _NO_OS_SPSC_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @struct no_os_spsc_ring
+ * @brief Lock-free ring of bytes for one producer and one consumer.
+ *
+ * The producer and the consumer may run in different threads, cores or in
+ * interrupt context. head is only written by the producer and tail only by
+ * the consumer. Both are free running and are masked with size - 1 to get
+ * the position in the buffer.
+ */
+struct no_os_spsc_ring {
+	/** Address of the buffer */
+	uint8_t		*buff;
+	/** Size of the buffer in bytes. Must be a power of two */
+	uint32_t	size;
+	/** Number of bytes written since the ring was configured */
+	uint32_t	head;
+	/** Number of bytes read since the ring was configured */
+	uint32_t	tail;
+	/** Set if buff was allocated by no_os_spsc_ring_init */
+	bool		allocated;
+};
+
+int32_t no_os_spsc_ring_init(struct no_os_spsc_ring **ring, uint32_t size);
+/* Configure ring with given buffer without memory allocation */
+int32_t no_os_spsc_ring_cfg(struct no_os_spsc_ring *ring, uint8_t *buff,
+			    uint32_t size);
+int32_t no_os_spsc_ring_remove(struct no_os_spsc_ring *ring);
+
+/* Number of bytes that can be read. Safe to be called by the consumer */
+uint32_t no_os_spsc_ring_used(struct no_os_spsc_ring *ring);
+/* Number of bytes that can be written. Safe to be called by the producer */
+uint32_t no_os_spsc_ring_space(struct no_os_spsc_ring *ring);
+
+/* Producer side */
+int32_t no_os_spsc_ring_reserve(struct no_os_spsc_ring *ring, uint32_t len,
+				void **addr, uint32_t *avail);
+int32_t no_os_spsc_ring_commit(struct no_os_spsc_ring *ring, uint32_t len);
+int32_t no_os_spsc_ring_write(struct no_os_spsc_ring *ring, const void *data,
+			      uint32_t len);
+
+/* Consumer side */
+int32_t no_os_spsc_ring_peek(struct no_os_spsc_ring *ring, uint32_t len,
+			     void **addr, uint32_t *avail);
+int32_t no_os_spsc_ring_consume(struct no_os_spsc_ring *ring, uint32_t len);
+int32_t no_os_spsc_ring_read(struct no_os_spsc_ring *ring, void *data,
+			     uint32_t len);
+
+#endif //_NO_OS_SPSC_RING_H_
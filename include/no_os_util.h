@@ -132,6 +132,15 @@ inline int no_os_test_bit(int pos, const volatile void * addr)
 	return (((const int *)addr)[pos / 32] >> pos) & 1UL;
 }
 
+/* Number of 32 bit words needed to store a bitmap of nbits */
+#define NO_OS_BITS_TO_WORDS(nbits)	NO_OS_DIV_ROUND_UP(nbits, 32)
+
+/* Iterate over the set bits of a bitmap of nbits */
+#define no_os_for_each_set_bit(bit, bitmap, nbits)				\
+	for ((bit) = no_os_find_next_set_bit((bitmap), (nbits), 0);		\
+	     (bit) < (nbits);							\
+	     (bit) = no_os_find_next_set_bit((bitmap), (nbits), (bit) + 1))
+
 /* Find first set bit in word. */
 uint32_t no_os_find_first_set_bit(uint32_t word);
 uint64_t no_os_find_first_set_bit_u64(uint64_t word);
@@ -179,6 +188,11 @@ unsigned int no_os_hweight8(uint8_t word);
 unsigned int no_os_hweight16(uint16_t word);
 /* Calculate the number of set bits (32-bit size). */
 unsigned int no_os_hweight32(uint32_t word);
+/* Find the first set bit of a bitmap starting from a given position. */
+uint32_t no_os_find_next_set_bit(const uint32_t *bitmap, uint32_t nbits,
+				 uint32_t start);
+/* Calculate the number of set bits of a bitmap. */
+uint32_t no_os_bitmap_weight(const uint32_t *bitmap, uint32_t nbits);
 /* Calculate the quotient and the remainder of an integer division. */
 uint64_t no_os_do_div(uint64_t* n,
 		      uint64_t base);
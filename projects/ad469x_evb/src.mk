@@ -22,6 +22,7 @@ SRCS += $(DRIVERS)/api/no_os_uart.c		\
 	$(NO-OS)/util/no_os_lf256fifo.c		\
 	$(NO-OS)/util/no_os_fifo.c		\
 	$(DRIVERS)/api/no_os_spi.c		\
+	$(DRIVERS)/api/no_os_regmap.c		\
 	$(DRIVERS)/api/no_os_pwm.c
 
 INCS += $(INCLUDE)/no_os_delay.h	\
@@ -39,6 +40,7 @@ INCS += $(INCLUDE)/no_os_delay.h	\
 	$(INCLUDE)/no_os_mutex.h	\
 	$(INCLUDE)/no_os_mutex.h	\
 	$(INCLUDE)/no_os_spi.h		\
+	$(INCLUDE)/no_os_regmap.h	\
 	$(INCLUDE)/no_os_pwm.h		\
 	$(INCLUDE)/no_os_print_log.h	\
 	$(INCLUDE)/no_os_axi_io.h
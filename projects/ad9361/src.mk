@@ -27,7 +27,9 @@ SRCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_axi_io.c
 SRCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_spi.c \
 	$(PLATFORM_DRIVERS)/$(PLATFORM)_gpio.c
 ifeq (linux,$(strip $(PLATFORM)))
-SRCS +=	$(PLATFORM_DRIVERS)/linux_delay.c
+SRCS +=	$(PLATFORM_DRIVERS)/linux_delay.c \
+	$(PLATFORM_DRIVERS)/linux_irq.c \
+	$(DRIVERS)/api/no_os_irq.c
 else
 SRCS +=	$(PLATFORM_DRIVERS)/$(PLATFORM)_delay.c
 endif
@@ -69,6 +71,7 @@ ifeq (linux,$(strip $(PLATFORM)))
 CFLAGS += -DPLATFORM_MB
 INCS +=	$(PLATFORM_DRIVERS)/linux_spi.h \
 	$(PLATFORM_DRIVERS)/linux_gpio.h \
+	$(PLATFORM_DRIVERS)/linux_irq.h \
 	$(INCLUDE)/no_os_lf256fifo.h \
 	$(PLATFORM_DRIVERS)/linux_uart.h
 endif
@@ -53,6 +53,8 @@
 #ifdef LINUX_PLATFORM
 #include "linux_spi.h"
 #include "linux_gpio.h"
+#include "no_os_irq.h"
+#include "linux_irq.h"
 #else
 #include "xilinx_irq.h"
 #endif //LINUX
@@ -612,6 +614,47 @@ int main(void)
 		printf("axi_dmac_init rx init error: %"PRIi32"\n", status);
 		return status;
 	}
+#if defined LINUX_PLATFORM && defined DMA_IRQ_ENABLE
+	/**
+	 * The DMA interrupts are delivered by the same UIO devices (/dev/uioX)
+	 * the DMA registers are mapped from.
+	 */
+	struct no_os_irq_init_param irq_init_param = {
+		.irq_ctrl_id = 0,
+		.platform_ops = &linux_irq_ops,
+	};
+	struct no_os_irq_ctrl_desc *irq_desc;
+	struct no_os_callback_desc rx_dmac_callback = {
+		.ctx = rx_dmac,
+		.callback = axi_dmac_dev_to_mem_isr,
+	};
+	struct no_os_callback_desc tx_dmac_callback = {
+		.ctx = tx_dmac,
+		.callback = axi_dmac_mem_to_dev_isr,
+	};
+
+	status = no_os_irq_ctrl_init(&irq_desc, &irq_init_param);
+	if (status < 0)
+		return status;
+
+	status = no_os_irq_register_callback(irq_desc, CF_AD9361_RX_DMA_BASEADDR,
+					     &rx_dmac_callback);
+	if (status < 0)
+		return status;
+
+	status = no_os_irq_register_callback(irq_desc, CF_AD9361_TX_DMA_BASEADDR,
+					     &tx_dmac_callback);
+	if (status < 0)
+		return status;
+
+	status = no_os_irq_enable(irq_desc, CF_AD9361_RX_DMA_BASEADDR);
+	if (status < 0)
+		return status;
+
+	status = no_os_irq_enable(irq_desc, CF_AD9361_TX_DMA_BASEADDR);
+	if (status < 0)
+		return status;
+#endif
 #ifndef AXI_ADC_NOT_PRESENT
 #if defined XILINX_PLATFORM || defined LINUX_PLATFORM || defined ALTERA_PLATFORM
 #ifdef DMA_EXAMPLE
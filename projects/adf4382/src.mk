@@ -1,6 +1,7 @@
 SRCS += $(DRIVERS)/api/no_os_uart.c     \
         $(DRIVERS)/api/no_os_gpio.c     \
 	$(DRIVERS)/api/no_os_spi.c  	\
+	$(DRIVERS)/api/no_os_regmap.c	\
 	$(DRIVERS)/api/no_os_irq.c 	\
 	$(DRIVERS)/api/no_os_timer.c	\
         $(DRIVERS)/api/no_os_dma.c      \
@@ -16,6 +17,7 @@ INCS += $(INCLUDE)/no_os_delay.h     \
 	$(INCLUDE)/no_os_gpio.h      \
 	$(INCLUDE)/no_os_mutex.h     \
 	$(INCLUDE)/no_os_spi.h       \
+	$(INCLUDE)/no_os_regmap.h    \
         $(INCLUDE)/no_os_fifo.h      \
         $(INCLUDE)/no_os_irq.h       \
         $(INCLUDE)/no_os_lf256fifo.h \
@@ -16,7 +16,8 @@ SRCS += $(NO-OS)/util/no_os_circular_buffer.c
 INCS += $(INCLUDE)/no_os_circular_buffer.h
 
 SRCS += $(DRIVERS)/platform/linux/linux_uart.c \
-	$(DRIVERS)/platform/linux/linux_delay.c
+	$(DRIVERS)/platform/linux/linux_delay.c \
+	$(DRIVERS)/platform/linux/linux_mutex.c
 
 
 INCS += $(INCLUDE)/no_os_gpio.h \
@@ -0,0 +1,266 @@
+/***************************************************************************//**
+ *   @file   test_no_os_regmap.c
+ *   @brief  Unit tests for the register map cache
+ *******************************************************************************
+ * Copyright 2025(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "unity.h"
+#include "no_os_regmap.h"
+#include "no_os_util.h"
+#include <errno.h>
+#include <string.h>
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+#define NB_REGS		0x200
+#define VOLATILE_REG	0x0A
+
+/* Simulated device, 8-bit registers with 16-bit addresses */
+static uint8_t dev_regs[NB_REGS];
+/* Bus transactions done by the register map */
+static uint32_t nb_xfers;
+
+static struct no_os_regmap *map;
+
+/* Registers 0x100-0x10F are reserved */
+static const struct no_os_regmap_range rd_ranges[] = {
+	{ 0x000, 0x0FF },
+	{ 0x110, NB_REGS - 1 },
+};
+
+static const struct no_os_regmap_table rd_table = {
+	.ranges = rd_ranges,
+	.nb_ranges = NO_OS_ARRAY_SIZE(rd_ranges),
+};
+
+static const struct no_os_regmap_range volatile_ranges[] = {
+	{ VOLATILE_REG, VOLATILE_REG },
+};
+
+static const struct no_os_regmap_table volatile_table = {
+	.ranges = volatile_ranges,
+	.nb_ranges = NO_OS_ARRAY_SIZE(volatile_ranges),
+};
+
+/*******************************************************************************
+ *    HELPERS
+ ******************************************************************************/
+
+static int fake_bulk_read(struct no_os_regmap *m, uint32_t reg, uint8_t *data,
+			  uint32_t count)
+{
+	(void)m;
+
+	if (reg + count > NB_REGS)
+		return -EINVAL;
+
+	nb_xfers++;
+	memcpy(data, &dev_regs[reg], count);
+
+	return 0;
+}
+
+static int fake_bulk_write(struct no_os_regmap *m, uint32_t reg,
+			   const uint8_t *data, uint32_t count)
+{
+	(void)m;
+
+	if (reg + count > NB_REGS)
+		return -EINVAL;
+
+	nb_xfers++;
+	memcpy(&dev_regs[reg], data, count);
+
+	return 0;
+}
+
+static const struct no_os_regmap_bus_ops fake_bus_ops = {
+	.bulk_read = fake_bulk_read,
+	.bulk_write = fake_bulk_write,
+};
+
+/*******************************************************************************
+ *    SETUP, TEARDOWN
+ ******************************************************************************/
+
+void setUp(void)
+{
+	struct no_os_regmap_init_param param = {
+		.bus_ops = &fake_bus_ops,
+		.reg_bits = 16,
+		.val_bits = 8,
+		.max_register = NB_REGS - 1,
+		.burst = true,
+		.rd_table = &rd_table,
+		.volatile_table = &volatile_table,
+		.cache_type = NO_OS_REGMAP_CACHE_FLAT,
+	};
+	uint32_t i;
+
+	for (i = 0; i < NB_REGS; i++)
+		dev_regs[i] = (uint8_t)i;
+	nb_xfers = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_init(&map, &param));
+}
+
+void tearDown(void)
+{
+	no_os_regmap_remove(map);
+	map = NULL;
+}
+
+/*******************************************************************************
+ *    TEST FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Once a register is cached, read-modify-write costs only the write,
+ * and nothing when the value doesn't change.
+ */
+void test_update_bits_uses_cache(void)
+{
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_update_bits(map, 0x10, 0xF0, 0x30));
+	TEST_ASSERT_EQUAL_UINT32(2, nb_xfers);
+	TEST_ASSERT_EQUAL_HEX8(0x30, dev_regs[0x10]);
+
+	nb_xfers = 0;
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_update_bits(map, 0x10, 0x0F, 0x05));
+	TEST_ASSERT_EQUAL_UINT32(1, nb_xfers);
+	TEST_ASSERT_EQUAL_HEX8(0x35, dev_regs[0x10]);
+
+	nb_xfers = 0;
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_update_bits(map, 0x10, 0x0F, 0x05));
+	TEST_ASSERT_EQUAL_UINT32(0, nb_xfers);
+}
+
+/**
+ * @brief Volatile registers are read from the device every time.
+ */
+void test_volatile_read_goes_to_bus(void)
+{
+	uint32_t val;
+
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_read(map, VOLATILE_REG, &val));
+	dev_regs[VOLATILE_REG] = 0xA5;
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_read(map, VOLATILE_REG, &val));
+	TEST_ASSERT_EQUAL_HEX32(0xA5, val);
+	TEST_ASSERT_EQUAL_UINT32(2, nb_xfers);
+}
+
+/**
+ * @brief Registers outside the readable ranges are rejected without a bus
+ * access.
+ */
+void test_read_reserved_register(void)
+{
+	uint32_t val;
+
+	TEST_ASSERT_EQUAL_INT(-EINVAL, no_os_regmap_read(map, 0x105, &val));
+	TEST_ASSERT_EQUAL_INT(-EINVAL, no_os_regmap_read(map, NB_REGS, &val));
+	TEST_ASSERT_EQUAL_UINT32(0, nb_xfers);
+}
+
+/**
+ * @brief A 100 register bulk write is done in 2 bursts and the values are
+ * read back from the cache.
+ */
+void test_bulk_write_in_bursts(void)
+{
+	uint32_t vals[100];
+	uint32_t back[100];
+	uint32_t i;
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(vals); i++)
+		vals[i] = 0xFF - i;
+
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_bulk_write(map, 0x20, vals,
+			      NO_OS_ARRAY_SIZE(vals)));
+	TEST_ASSERT_EQUAL_UINT32(2, nb_xfers);
+	for (i = 0; i < NO_OS_ARRAY_SIZE(vals); i++)
+		TEST_ASSERT_EQUAL_HEX8(vals[i], dev_regs[0x20 + i]);
+
+	nb_xfers = 0;
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_bulk_read(map, 0x20, back,
+			      NO_OS_ARRAY_SIZE(back)));
+	TEST_ASSERT_EQUAL_UINT32(0, nb_xfers);
+	TEST_ASSERT_EQUAL_MEMORY(vals, back, sizeof(vals));
+}
+
+/**
+ * @brief mark_dirty and sync restore the configuration of a reset device.
+ */
+void test_mark_dirty_sync_restores_device(void)
+{
+	uint32_t vals[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_bulk_write(map, 0x40, vals,
+			      NO_OS_ARRAY_SIZE(vals)));
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_write(map, 0x1F0, 0x99));
+
+	memset(dev_regs, 0, sizeof(dev_regs));
+	no_os_regmap_mark_dirty(map);
+
+	nb_xfers = 0;
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_sync(map));
+	/* One burst for the consecutive registers, one for 0x1F0 */
+	TEST_ASSERT_EQUAL_UINT32(2, nb_xfers);
+	TEST_ASSERT_EQUAL_HEX8(1, dev_regs[0x40]);
+	TEST_ASSERT_EQUAL_HEX8(8, dev_regs[0x47]);
+	TEST_ASSERT_EQUAL_HEX8(0x99, dev_regs[0x1F0]);
+
+	/* Nothing is left dirty */
+	nb_xfers = 0;
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_sync(map));
+	TEST_ASSERT_EQUAL_UINT32(0, nb_xfers);
+}
+
+/**
+ * @brief In cache-only mode writes stay in the cache until sync.
+ */
+void test_cache_only_defers_writes(void)
+{
+	no_os_regmap_cache_only(map, true);
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_write(map, 0x30, 0x11));
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_write(map, 0x31, 0x22));
+	TEST_ASSERT_EQUAL_UINT32(0, nb_xfers);
+	TEST_ASSERT_EQUAL_INT(-EBUSY, no_os_regmap_sync(map));
+
+	no_os_regmap_cache_only(map, false);
+	TEST_ASSERT_EQUAL_INT(0, no_os_regmap_sync(map));
+	TEST_ASSERT_EQUAL_UINT32(1, nb_xfers);
+	TEST_ASSERT_EQUAL_HEX8(0x11, dev_regs[0x30]);
+	TEST_ASSERT_EQUAL_HEX8(0x22, dev_regs[0x31]);
+}
@@ -0,0 +1,587 @@
+/***************************************************************************//**
+ *   @file   test_iiod.c
+ *   @brief  Unit tests for the binary protocol of iiod
+ *******************************************************************************
+ * Copyright 2025(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "unity.h"
+#include "iiod.h"
+#include "iiod_private.h"
+#include "no_os_util.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+/* Small connection buffer so that blocks are sent in several chunks */
+#define CONN_BUF_LEN	64
+#define STREAM_LEN	1024
+#define NB_CHANNELS	4
+#define CLIENT_ID	0x1234
+
+static struct iiod_desc *desc;
+static uint32_t conn_id;
+static char conn_buf[CONN_BUF_LEN];
+
+/* Data sent by the client and data sent by iiod */
+static uint8_t rx[STREAM_LEN];
+static uint32_t rx_len, rx_idx;
+static uint8_t tx[STREAM_LEN];
+static uint32_t tx_len, tx_idx;
+
+/* Fake device state */
+static bool dev_output;
+static uint32_t open_cnt, close_cnt, refill_cnt, push_cnt;
+static uint32_t open_samples, open_mask;
+static uint8_t dev_data[STREAM_LEN];
+static uint32_t dev_data_len;
+static uint8_t next_sample;
+/* Attributes written, as "name=value;" */
+static char written[STREAM_LEN];
+
+/*******************************************************************************
+ *    FAKE OPS
+ ******************************************************************************/
+
+static int fake_send(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
+{
+	len = no_os_min(len, STREAM_LEN - tx_len);
+	memcpy(tx + tx_len, buf, len);
+	tx_len += len;
+
+	return len;
+}
+
+static int fake_recv(struct iiod_ctx *ctx, uint8_t *buf, uint32_t len)
+{
+	len = no_os_min(len, rx_len - rx_idx);
+	if (!len)
+		return -EAGAIN;
+
+	memcpy(buf, rx + rx_idx, len);
+	rx_idx += len;
+
+	return len;
+}
+
+static int fake_get_names(struct iiod_ctx *ctx, uint32_t dev, uint32_t chn,
+			  int32_t attr_idx, enum iio_attr_type *type,
+			  char *device, char *channel, char *attr)
+{
+	if (dev != 0 || chn >= NB_CHANNELS)
+		return -ENOENT;
+
+	strcpy(device, "dev0");
+	if (attr_idx >= 0) {
+		sprintf(attr, "attr%d", (int)attr_idx);
+		sprintf(channel, "voltage%d", (int)chn);
+	}
+
+	return 0;
+}
+
+static int fake_get_buffer_info(struct iiod_ctx *ctx, uint32_t dev,
+				const uint32_t *mask, uint32_t mask_words,
+				uint32_t *nb_ch, uint32_t *sample_size,
+				bool *output)
+{
+	uint32_t i;
+
+	if (dev != 0)
+		return -ENOENT;
+
+	*nb_ch = NB_CHANNELS;
+	if (!mask)
+		return 0;
+
+	if (!(mask[0] & NO_OS_GENMASK(NB_CHANNELS - 1, 0)))
+		return -ENOENT;
+
+	/* 16 bit samples */
+	*sample_size = 0;
+	for (i = 0; i < NB_CHANNELS; i++)
+		if (mask[0] & NO_OS_BIT(i))
+			*sample_size += 2;
+	*output = dev_output;
+
+	return 0;
+}
+
+static int fake_open(struct iiod_ctx *ctx, const char *device, uint32_t samples,
+		     const uint32_t *mask, uint32_t mask_words, bool cyclic)
+{
+	open_cnt++;
+	open_samples = samples;
+	open_mask = mask[0];
+
+	return 0;
+}
+
+static int fake_close(struct iiod_ctx *ctx, const char *device)
+{
+	close_cnt++;
+
+	return 0;
+}
+
+static int fake_refill(struct iiod_ctx *ctx, const char *device)
+{
+	refill_cnt++;
+
+	return 0;
+}
+
+static int fake_push(struct iiod_ctx *ctx, const char *device)
+{
+	push_cnt++;
+
+	return 0;
+}
+
+static int fake_read_buffer(struct iiod_ctx *ctx, const char *device,
+			    char *buf, uint32_t bytes)
+{
+	uint32_t i;
+
+	for (i = 0; i < bytes; i++)
+		buf[i] = next_sample++;
+
+	return bytes;
+}
+
+static int fake_write_buffer(struct iiod_ctx *ctx, const char *device,
+			     const char *buf, uint32_t bytes)
+{
+	bytes = no_os_min(bytes, STREAM_LEN - dev_data_len);
+	memcpy(dev_data + dev_data_len, buf, bytes);
+	dev_data_len += bytes;
+
+	return bytes;
+}
+
+static int fake_read_attr(struct iiod_ctx *ctx, const char *device,
+			  struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	if (attr->type == IIO_ATTR_TYPE_CH_IN)
+		return snprintf(buf, len, "%s_%s", attr->channel, attr->name);
+
+	return snprintf(buf, len, "%s", attr->name);
+}
+
+static int fake_write_attr(struct iiod_ctx *ctx, const char *device,
+			   struct iiod_attr *attr, char *buf, uint32_t len)
+{
+	snprintf(written + strlen(written), sizeof(written) - strlen(written),
+		 "%s=%.*s;", attr->name, (int)len, buf);
+
+	return len;
+}
+
+static struct iiod_ops fake_ops = {
+	.send = fake_send,
+	.recv = fake_recv,
+	.get_names = fake_get_names,
+	.get_buffer_info = fake_get_buffer_info,
+	.open = fake_open,
+	.close = fake_close,
+	.refill_buffer = fake_refill,
+	.push_buffer = fake_push,
+	.read_buffer = fake_read_buffer,
+	.write_buffer = fake_write_buffer,
+	.read_attr = fake_read_attr,
+	.write_attr = fake_write_attr,
+};
+
+/*******************************************************************************
+ *    HELPERS
+ ******************************************************************************/
+
+static void put_bytes(const void *buf, uint32_t len)
+{
+	TEST_ASSERT_TRUE(rx_len + len <= STREAM_LEN);
+	memcpy(rx + rx_len, buf, len);
+	rx_len += len;
+}
+
+static void put_cmd(uint8_t op, uint8_t dev, int32_t code)
+{
+	uint8_t hdr[IIOD_BIN_CMD_SIZE];
+
+	no_os_put_unaligned_le16(CLIENT_ID, hdr);
+	hdr[2] = op;
+	hdr[3] = dev;
+	no_os_put_unaligned_le32(code, hdr + 4);
+	put_bytes(hdr, sizeof(hdr));
+}
+
+/* Entry of a READ_ATTRS or WRITE_ATTRS list */
+static void put_entry(uint8_t *list, uint32_t *len, uint8_t op, uint8_t dev,
+		      int32_t code)
+{
+	/* client_id is ignored in the entries */
+	no_os_put_unaligned_le16(0xFFFF, list + *len);
+	list[*len + 2] = op;
+	list[*len + 3] = dev;
+	no_os_put_unaligned_le32(code, list + *len + 4);
+	*len += IIOD_BIN_CMD_SIZE;
+}
+
+static void put_u64(uint64_t val)
+{
+	uint8_t raw[IIOD_BIN_LEN_SIZE];
+
+	no_os_put_unaligned_le64(val, raw);
+	put_bytes(raw, sizeof(raw));
+}
+
+/* Step the connection until all the client data is consumed */
+static void run(void)
+{
+	uint32_t i;
+	int32_t ret;
+
+	for (i = 0; i < 1000; i++) {
+		if (rx_idx == rx_len && iiod_conn_is_idle(desc, conn_id))
+			return;
+		ret = iiod_conn_step(desc, conn_id);
+		TEST_ASSERT_TRUE(ret == 0 || ret == -EAGAIN);
+	}
+
+	TEST_FAIL_MESSAGE("Connection did not become idle");
+}
+
+/* Check the next response header sent by iiod and return its code */
+static int32_t get_resp(void)
+{
+	TEST_ASSERT_TRUE(tx_len - tx_idx >= IIOD_BIN_CMD_SIZE);
+	TEST_ASSERT_EQUAL_UINT16(CLIENT_ID, no_os_get_unaligned_le16(tx + tx_idx));
+	TEST_ASSERT_EQUAL_UINT8(IIOD_BIN_OP_RESPONSE, tx[tx_idx + 2]);
+	tx_idx += IIOD_BIN_CMD_SIZE;
+
+	return (int32_t)no_os_get_unaligned_le32(tx + tx_idx - 4);
+}
+
+static void get_data(void *buf, uint32_t len)
+{
+	TEST_ASSERT_TRUE(tx_len - tx_idx >= len);
+	memcpy(buf, tx + tx_idx, len);
+	tx_idx += len;
+}
+
+/* Create buffer 0 of dev0 with channels 0 and 2 and one block of size */
+static void create_buffer(uint32_t block, uint32_t size)
+{
+	uint8_t mask[4] = {0x05, 0, 0, 0};
+	uint8_t echo[4];
+
+	put_cmd(IIOD_BIN_OP_CREATE_BUFFER, 0, 0);
+	put_bytes(mask, sizeof(mask));
+	put_cmd(IIOD_BIN_OP_CREATE_BLOCK, 0, block << 16);
+	put_u64(size);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(sizeof(mask), get_resp());
+	get_data(echo, sizeof(echo));
+	TEST_ASSERT_EQUAL_MEMORY(mask, echo, sizeof(mask));
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+}
+
+/*******************************************************************************
+ *    SETUP AND TEARDOWN
+ ******************************************************************************/
+
+void setUp(void)
+{
+	struct iiod_init_param param = {
+		.ops = &fake_ops,
+		.xml = "<context/>",
+		.xml_len = sizeof("<context/>") - 1,
+		.phy_type = USE_UART,
+	};
+	struct iiod_conn_data data = {
+		.buf = conn_buf,
+		.len = sizeof(conn_buf),
+	};
+
+	rx_len = rx_idx = tx_len = tx_idx = 0;
+	open_cnt = close_cnt = refill_cnt = push_cnt = 0;
+	open_samples = open_mask = 0;
+	dev_data_len = 0;
+	next_sample = 0;
+	written[0] = '\0';
+	dev_output = false;
+
+	TEST_ASSERT_EQUAL_INT32(0, iiod_init(&desc, &param));
+	TEST_ASSERT_EQUAL_INT32(0, iiod_conn_add(desc, &data, &conn_id));
+
+	put_bytes("BINARY\r\n", 8);
+	run();
+	TEST_ASSERT_EQUAL_UINT32(2, tx_len);
+	TEST_ASSERT_EQUAL_MEMORY("0\n", tx, 2);
+	tx_idx = tx_len;
+}
+
+void tearDown(void)
+{
+	struct iiod_conn_data data;
+
+	iiod_conn_remove(desc, conn_id, &data);
+	iiod_remove(desc);
+}
+
+/*******************************************************************************
+ *    TEST CASES
+ ******************************************************************************/
+
+void test_create_buffer_unknown_device_closes_connection(void)
+{
+	put_cmd(IIOD_BIN_OP_CREATE_BUFFER, 1, 0);
+
+	TEST_ASSERT_EQUAL_INT32(-ENOTCONN, iiod_conn_step(desc, conn_id));
+}
+
+void test_create_buffer_empty_mask(void)
+{
+	uint8_t mask[4] = {0};
+
+	put_cmd(IIOD_BIN_OP_CREATE_BUFFER, 0, 0);
+	put_bytes(mask, sizeof(mask));
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(-ENOENT, get_resp());
+	TEST_ASSERT_EQUAL_UINT32(tx_len, tx_idx);
+}
+
+void test_create_block_size_not_multiple_of_sample(void)
+{
+	uint8_t mask[4] = {0x05, 0, 0, 0};
+
+	put_cmd(IIOD_BIN_OP_CREATE_BUFFER, 0, 0);
+	put_bytes(mask, sizeof(mask));
+	put_cmd(IIOD_BIN_OP_CREATE_BLOCK, 0, 0);
+	put_u64(6);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(sizeof(mask), get_resp());
+	tx_idx += sizeof(mask);
+	TEST_ASSERT_EQUAL_INT32(-EINVAL, get_resp());
+}
+
+void test_input_block_before_enable(void)
+{
+	uint8_t data[160];
+	uint32_t i;
+
+	create_buffer(1, sizeof(data));
+
+	/* libiio may enqueue input blocks before enabling the buffer */
+	put_cmd(IIOD_BIN_OP_TRANSFER_BLOCK, 0, 1 << 16);
+	put_u64(sizeof(data));
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(sizeof(data), get_resp());
+	get_data(data, sizeof(data));
+	for (i = 0; i < sizeof(data); i++)
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)i, data[i]);
+	TEST_ASSERT_EQUAL_UINT32(tx_len, tx_idx);
+
+	TEST_ASSERT_EQUAL_UINT32(1, open_cnt);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(data) / 4, open_samples);
+	TEST_ASSERT_EQUAL_UINT32(0x05, open_mask);
+	TEST_ASSERT_EQUAL_UINT32(1, refill_cnt);
+
+	/* Already enabled by the transfer */
+	put_cmd(IIOD_BIN_OP_ENABLE_BUFFER, 0, 0);
+	put_cmd(IIOD_BIN_OP_DISABLE_BUFFER, 0, 0);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+	TEST_ASSERT_EQUAL_UINT32(1, open_cnt);
+	TEST_ASSERT_EQUAL_UINT32(1, close_cnt);
+}
+
+void test_output_block(void)
+{
+	uint8_t data[96];
+	uint32_t i;
+
+	dev_output = true;
+	create_buffer(0, 128);
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = 0xFF - i;
+
+	put_cmd(IIOD_BIN_OP_ENABLE_BUFFER, 0, 0);
+	put_cmd(IIOD_BIN_OP_TRANSFER_BLOCK, 0, 0);
+	put_u64(sizeof(data));
+	put_bytes(data, sizeof(data));
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+	TEST_ASSERT_EQUAL_INT32(sizeof(data), get_resp());
+	TEST_ASSERT_EQUAL_UINT32(tx_len, tx_idx);
+
+	TEST_ASSERT_EQUAL_UINT32(1, open_cnt);
+	TEST_ASSERT_EQUAL_UINT32(128 / 4, open_samples);
+	TEST_ASSERT_EQUAL_UINT32(1, push_cnt);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(data), dev_data_len);
+	TEST_ASSERT_EQUAL_MEMORY(data, dev_data, sizeof(data));
+}
+
+void test_output_block_too_big_is_dropped(void)
+{
+	uint8_t data[96] = {0};
+
+	dev_output = true;
+	create_buffer(0, 64);
+
+	/* The data is consumed so the next command is still parsed */
+	put_cmd(IIOD_BIN_OP_TRANSFER_BLOCK, 0, 0);
+	put_u64(sizeof(data));
+	put_bytes(data, sizeof(data));
+	put_cmd(IIOD_BIN_OP_FREE_BUFFER, 0, 0);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(-EINVAL, get_resp());
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+	TEST_ASSERT_EQUAL_UINT32(0, push_cnt);
+	TEST_ASSERT_EQUAL_UINT32(0, dev_data_len);
+}
+
+void test_free_block(void)
+{
+	create_buffer(2, 64);
+
+	put_cmd(IIOD_BIN_OP_FREE_BLOCK, 0, 2 << 16);
+	put_cmd(IIOD_BIN_OP_TRANSFER_BLOCK, 0, 2 << 16);
+	put_u64(64);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+	TEST_ASSERT_EQUAL_INT32(-EINVAL, get_resp());
+	TEST_ASSERT_EQUAL_UINT32(tx_len, tx_idx);
+	TEST_ASSERT_EQUAL_UINT32(0, refill_cnt);
+}
+
+void test_unknown_buffer_id(void)
+{
+	create_buffer(0, 64);
+
+	put_cmd(IIOD_BIN_OP_ENABLE_BUFFER, 0, 1);
+	put_cmd(IIOD_BIN_OP_CREATE_BLOCK, 0, 1 | (1 << 16));
+	put_u64(64);
+	put_cmd(IIOD_BIN_OP_FREE_BUFFER, 0, 1);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(-ENOENT, get_resp());
+	TEST_ASSERT_EQUAL_INT32(-ENOENT, get_resp());
+	TEST_ASSERT_EQUAL_INT32(-ENOENT, get_resp());
+	TEST_ASSERT_EQUAL_UINT32(0, open_cnt);
+}
+
+void test_conn_remove_closes_enabled_buffer(void)
+{
+	struct iiod_conn_data data;
+
+	create_buffer(0, 64);
+	put_cmd(IIOD_BIN_OP_ENABLE_BUFFER, 0, 0);
+	run();
+	TEST_ASSERT_EQUAL_INT32(0, get_resp());
+
+	TEST_ASSERT_EQUAL_INT32(0, iiod_conn_remove(desc, conn_id, &data));
+	TEST_ASSERT_EQUAL_UINT32(1, close_cnt);
+	TEST_ASSERT_EQUAL_INT32(0, iiod_conn_add(desc, &data, &conn_id));
+}
+
+void test_read_attrs(void)
+{
+	uint8_t list[3 * IIOD_BIN_CMD_SIZE];
+	uint8_t res[64];
+	uint32_t len = 0;
+
+	put_entry(list, &len, IIOD_BIN_OP_READ_ATTR, 0, 1);
+	put_entry(list, &len, IIOD_BIN_OP_READ_CHN_ATTR, 0, (2 << 16) | 3);
+	/* Not a read, only reported in its result */
+	put_entry(list, &len, IIOD_BIN_OP_WRITE_ATTR, 0, 0);
+
+	put_cmd(IIOD_BIN_OP_READ_ATTRS, 0, 0);
+	put_u64(len);
+	put_bytes(list, len);
+	run();
+
+	/* "attr1" and "voltage2_attr3" padded to 4 bytes */
+	TEST_ASSERT_EQUAL_INT32(4 + 8 + 4 + 16 + 4, get_resp());
+	get_data(res, 36);
+	TEST_ASSERT_EQUAL_INT32(5, no_os_get_unaligned_le32(res));
+	TEST_ASSERT_EQUAL_MEMORY("attr1\0\0\0", res + 4, 8);
+	TEST_ASSERT_EQUAL_INT32(14, no_os_get_unaligned_le32(res + 12));
+	TEST_ASSERT_EQUAL_MEMORY("voltage2_attr3\0\0", res + 16, 16);
+	TEST_ASSERT_EQUAL_INT32(-EINVAL, (int32_t)no_os_get_unaligned_le32(res + 32));
+	TEST_ASSERT_EQUAL_UINT32(tx_len, tx_idx);
+}
+
+void test_write_attrs(void)
+{
+	uint8_t list[64];
+	uint8_t res[8];
+	uint32_t len = 0;
+
+	put_entry(list, &len, IIOD_BIN_OP_WRITE_ATTR, 0, 4);
+	no_os_put_unaligned_le32(3, list + len);
+	memcpy(list + len + 4, "abc\0", 4);
+	len += 8;
+	put_entry(list, &len, IIOD_BIN_OP_WRITE_CHN_ATTR, 0, (1 << 16) | 5);
+	no_os_put_unaligned_le32(4, list + len);
+	memcpy(list + len + 4, "1234", 4);
+	len += 8;
+
+	put_cmd(IIOD_BIN_OP_WRITE_ATTRS, 0, 0);
+	put_u64(len);
+	put_bytes(list, len);
+	/* The connection is still in sync after the list */
+	put_cmd(IIOD_BIN_OP_WRITE_ATTR, 0, 6);
+	put_u64(2);
+	put_bytes("xy", 2);
+	run();
+
+	TEST_ASSERT_EQUAL_INT32(sizeof(res), get_resp());
+	get_data(res, sizeof(res));
+	TEST_ASSERT_EQUAL_INT32(3, no_os_get_unaligned_le32(res));
+	TEST_ASSERT_EQUAL_INT32(4, no_os_get_unaligned_le32(res + 4));
+	TEST_ASSERT_EQUAL_INT32(2, get_resp());
+	TEST_ASSERT_EQUAL_STRING("attr4=abc;attr5=1234;attr6=xy;", written);
+}
@@ -0,0 +1,190 @@
+/***************************************************************************//**
+ *   @file   test_no_os_crc.c
+ *   @brief  Unit tests for the slicing-by-4 CRC functions
+ *******************************************************************************
+ * Copyright 2025(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "unity.h"
+#include "no_os_crc8.h"
+#include "no_os_crc16.h"
+#include "no_os_crc24.h"
+#include "no_os_util.h"
+#include <string.h>
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+/* Longest buffer checked, covers several slices and every remainder */
+#define DATA_LEN	67
+
+static const uint8_t check_data[] = "123456789";
+
+static const uint32_t seeds[] = {0x000000, 0xffffff, 0xb704ce, 0x5a5a5a};
+
+static uint8_t data[DATA_LEN + 3];
+
+NO_OS_DECLARE_CRC8_SLICE_TABLE(crc8_msb);
+NO_OS_DECLARE_CRC8_SLICE_TABLE(crc8_lsb);
+NO_OS_DECLARE_CRC16_SLICE_TABLE(crc16);
+NO_OS_DECLARE_CRC24_SLICE_TABLE(crc24);
+
+/*******************************************************************************
+ *    SETUP, TEARDOWN
+ ******************************************************************************/
+
+void setUp(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (uint8_t)(i * 151 + 7);
+
+	no_os_crc8_populate_msb_slice(crc8_msb, 0x07);
+	no_os_crc8_populate_lsb_slice(crc8_lsb, 0x8c);
+	no_os_crc16_populate_msb_slice(crc16, 0x8005);
+	no_os_crc24_populate_msb_slice(crc24, 0x864cfb);
+}
+
+void tearDown(void) {}
+
+/*******************************************************************************
+ *    TEST FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief table[0] of the slicing tables is the regular lookup table.
+ */
+void test_slice_tables_extend_regular_tables(void)
+{
+	uint8_t table8[NO_OS_CRC8_TABLE_SIZE];
+	uint16_t table16[NO_OS_CRC16_TABLE_SIZE];
+	uint32_t table24[NO_OS_CRC24_TABLE_SIZE];
+
+	no_os_crc8_populate_msb(table8, 0x07);
+	TEST_ASSERT_EQUAL_MEMORY(table8, crc8_msb[0], sizeof(table8));
+	no_os_crc8_populate_lsb(table8, 0x8c);
+	TEST_ASSERT_EQUAL_MEMORY(table8, crc8_lsb[0], sizeof(table8));
+	no_os_crc16_populate_msb(table16, 0x8005);
+	TEST_ASSERT_EQUAL_MEMORY(table16, crc16[0], sizeof(table16));
+	no_os_crc24_populate_msb(table24, 0x864cfb);
+	TEST_ASSERT_EQUAL_MEMORY(table24, crc24[0], sizeof(table24));
+}
+
+/**
+ * @brief Check values of the catalogued CRCs with the same polynomials.
+ */
+void test_slice_check_values(void)
+{
+	/* CRC-8/SMBUS */
+	TEST_ASSERT_EQUAL_HEX8(0xf4, no_os_crc8_slice(crc8_msb, check_data, 9, 0));
+	/* CRC-8/MAXIM-DOW */
+	TEST_ASSERT_EQUAL_HEX8(0xa1, no_os_crc8_slice(crc8_lsb, check_data, 9, 0));
+	/* CRC-16/UMTS */
+	TEST_ASSERT_EQUAL_HEX16(0xfee8, no_os_crc16_slice(crc16, check_data, 9, 0));
+	/* CRC-24/OPENPGP */
+	TEST_ASSERT_EQUAL_HEX32(0x21cf02, no_os_crc24_slice(crc24, check_data, 9,
+				0xb704ce));
+}
+
+/**
+ * @brief Slicing-by-4 gives the same CRC-8 as the bytewise computation for
+ * every length, alignment and initial value.
+ */
+void test_crc8_slice_matches_bytewise(void)
+{
+	uint32_t len, off, s;
+	uint8_t seed;
+
+	for (s = 0; s < NO_OS_ARRAY_SIZE(seeds); s++) {
+		seed = (uint8_t)seeds[s];
+		for (off = 0; off < 4; off++) {
+			for (len = 0; len <= DATA_LEN; len++) {
+				TEST_ASSERT_EQUAL_HEX8(
+					no_os_crc8(crc8_msb[0], &data[off], len, seed),
+					no_os_crc8_slice(crc8_msb, &data[off], len, seed));
+				TEST_ASSERT_EQUAL_HEX8(
+					no_os_crc8(crc8_lsb[0], &data[off], len, seed),
+					no_os_crc8_slice(crc8_lsb, &data[off], len, seed));
+			}
+		}
+	}
+}
+
+/**
+ * @brief Slicing-by-4 gives the same CRC-16 as the bytewise computation for
+ * every length, alignment and initial value.
+ */
+void test_crc16_slice_matches_bytewise(void)
+{
+	uint32_t len, off, s;
+	uint16_t seed;
+
+	for (s = 0; s < NO_OS_ARRAY_SIZE(seeds); s++) {
+		seed = (uint16_t)seeds[s];
+		for (off = 0; off < 4; off++)
+			for (len = 0; len <= DATA_LEN; len++)
+				TEST_ASSERT_EQUAL_HEX16(
+					no_os_crc16(crc16[0], &data[off], len, seed),
+					no_os_crc16_slice(crc16, &data[off], len, seed));
+	}
+}
+
+/**
+ * @brief Slicing-by-4 gives the same CRC-24 as the bytewise computation for
+ * every length, alignment and initial value.
+ */
+void test_crc24_slice_matches_bytewise(void)
+{
+	uint32_t len, off, s;
+
+	for (s = 0; s < NO_OS_ARRAY_SIZE(seeds); s++)
+		for (off = 0; off < 4; off++)
+			for (len = 0; len <= DATA_LEN; len++)
+				TEST_ASSERT_EQUAL_HEX32(
+					no_os_crc24(crc24[0], &data[off], len, seeds[s]),
+					no_os_crc24_slice(crc24, &data[off], len, seeds[s]));
+}
+
+/**
+ * @brief A CRC computed in several calls equals the one computed at once.
+ */
+void test_slice_cascade(void)
+{
+	uint32_t crc;
+
+	crc = no_os_crc24_slice(crc24, data, 13, 0xb704ce);
+	crc = no_os_crc24_slice(crc24, &data[13], DATA_LEN - 13, crc);
+	TEST_ASSERT_EQUAL_HEX32(no_os_crc24_slice(crc24, data, DATA_LEN, 0xb704ce),
+				crc);
+}
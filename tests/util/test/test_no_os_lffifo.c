@@ -0,0 +1,192 @@
+/***************************************************************************//**
+ *   @file   test_no_os_lffifo.c
+ *   @brief  Unit tests for the lock-free fifo template
+ *******************************************************************************
+ * Copyright 2025(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "unity.h"
+#include "no_os_lffifo.h"
+#include "no_os_util.h"
+#include <pthread.h>
+#include <sched.h>
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+#define FIFO_SIZE	16
+/* Elements moved through the fifo by the stress test */
+#define STRESS_ELEMS	(1 << 21)
+
+NO_OS_LFFIFO_DEFINE(test_fifo, uint32_t, FIFO_SIZE)
+
+static struct test_fifo fifo;
+
+/*******************************************************************************
+ *    HELPERS
+ ******************************************************************************/
+
+/*
+ * Bulk and single element accesses are mixed on both sides. Yield when the
+ * fifo is full or empty, so the test also runs on a single core.
+ */
+static void *producer(void *arg)
+{
+	uint32_t vals[5];
+	uint32_t sent = 0, nb, i;
+
+	while (sent < STRESS_ELEMS) {
+		if (test_fifo_is_full(&fifo)) {
+			sched_yield();
+			continue;
+		}
+
+		if (sent & 1) {
+			if (!test_fifo_write(&fifo, sent))
+				sent++;
+			continue;
+		}
+
+		nb = no_os_min(NO_OS_ARRAY_SIZE(vals), STRESS_ELEMS - sent);
+		for (i = 0; i < nb; i++)
+			vals[i] = sent + i;
+		sent += test_fifo_write_bulk(&fifo, vals, nb);
+	}
+
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	uint32_t *errors = arg;
+	uint32_t vals[3];
+	uint32_t recv = 0, nb, i;
+
+	while (recv < STRESS_ELEMS) {
+		if (test_fifo_is_empty(&fifo)) {
+			sched_yield();
+			continue;
+		}
+
+		if (recv & 2) {
+			if (!test_fifo_read(&fifo, vals)) {
+				if (vals[0] != recv)
+					(*errors)++;
+				recv++;
+			}
+			continue;
+		}
+
+		nb = test_fifo_read_bulk(&fifo, vals, NO_OS_ARRAY_SIZE(vals));
+		for (i = 0; i < nb; i++)
+			if (vals[i] != recv + i)
+				(*errors)++;
+		recv += nb;
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ *    SETUP AND TEARDOWN
+ ******************************************************************************/
+
+void setUp(void)
+{
+	memset(&fifo, 0, sizeof(fifo));
+}
+
+void tearDown(void)
+{
+}
+
+/*******************************************************************************
+ *    TEST CASES
+ ******************************************************************************/
+
+void test_full_and_empty(void)
+{
+	uint32_t vals[FIFO_SIZE + 1];
+	uint32_t i, val;
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(vals); i++)
+		vals[i] = i;
+
+	TEST_ASSERT_TRUE(test_fifo_is_empty(&fifo));
+	TEST_ASSERT_EQUAL_INT(-1, test_fifo_read(&fifo, &val));
+	TEST_ASSERT_EQUAL_UINT32(FIFO_SIZE,
+				 test_fifo_write_bulk(&fifo, vals, FIFO_SIZE + 1));
+	TEST_ASSERT_TRUE(test_fifo_is_full(&fifo));
+	TEST_ASSERT_EQUAL_INT(-1, test_fifo_write(&fifo, 0));
+
+	TEST_ASSERT_EQUAL_INT(0, test_fifo_read(&fifo, &val));
+	TEST_ASSERT_EQUAL_UINT32(0, val);
+	TEST_ASSERT_EQUAL_UINT32(1, test_fifo_space(&fifo));
+
+	test_fifo_flush(&fifo);
+	TEST_ASSERT_TRUE(test_fifo_is_empty(&fifo));
+	TEST_ASSERT_EQUAL_UINT32(FIFO_SIZE, test_fifo_space(&fifo));
+}
+
+void test_bulk_wrap(void)
+{
+	uint32_t in[12], out[12];
+	uint32_t i;
+
+	for (i = 0; i < NO_OS_ARRAY_SIZE(in); i++)
+		in[i] = 0x100 + i;
+
+	/* Second bulk write and read wrap around the end of data */
+	TEST_ASSERT_EQUAL_UINT32(12, test_fifo_write_bulk(&fifo, in, 12));
+	TEST_ASSERT_EQUAL_UINT32(12, test_fifo_read_bulk(&fifo, out, 12));
+	TEST_ASSERT_EQUAL_UINT32(12, test_fifo_write_bulk(&fifo, in, 12));
+	TEST_ASSERT_EQUAL_UINT32(12, test_fifo_used(&fifo));
+
+	memset(out, 0, sizeof(out));
+	TEST_ASSERT_EQUAL_UINT32(12, test_fifo_read_bulk(&fifo, out, 20));
+	TEST_ASSERT_EQUAL_MEMORY(in, out, sizeof(in));
+}
+
+void test_producer_consumer_threads(void)
+{
+	pthread_t prod, cons;
+	uint32_t errors = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, pthread_create(&cons, NULL, consumer, &errors));
+	TEST_ASSERT_EQUAL_INT(0, pthread_create(&prod, NULL, producer, NULL));
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+
+	TEST_ASSERT_EQUAL_UINT32(0, errors);
+	TEST_ASSERT_TRUE(test_fifo_is_empty(&fifo));
+}
@@ -0,0 +1,231 @@
+/***************************************************************************//**
+ *   @file   test_no_os_spsc_ring.c
+ *   @brief  Unit tests for the lock-free SPSC ring
+ *******************************************************************************
+ * Copyright 2025(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    INCLUDED FILES
+ ******************************************************************************/
+
+#include "unity.h"
+#include "no_os_spsc_ring.h"
+#include "no_os_util.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+/*******************************************************************************
+ *    PRIVATE DATA
+ ******************************************************************************/
+
+#define RING_SIZE	64
+/* Bytes moved through the ring by the stress test */
+#define STRESS_BYTES	(1 << 22)
+
+static struct no_os_spsc_ring *ring;
+
+/*******************************************************************************
+ *    HELPERS
+ ******************************************************************************/
+
+/* Value of byte i of the stress stream */
+static uint8_t stream_byte(uint32_t i)
+{
+	return (uint8_t)(i ^ (i >> 8) ^ (i >> 16));
+}
+
+/* Chunk sizes of both sides are varied so they don't stay aligned */
+static uint32_t chunk_len(uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+
+	return 1 + (*seed >> 16) % 23;
+}
+
+/*
+ * Alternate copies with in place accesses, chunk by chunk. Yield when the
+ * ring is full or empty, so the test also runs on a single core.
+ */
+static void *producer(void *arg)
+{
+	uint8_t tmp[32];
+	uint32_t seed = 1, sent = 0, len, avail, i;
+	void *addr;
+
+	while (sent < STRESS_BYTES) {
+		len = chunk_len(&seed);
+		len = no_os_min(len, STRESS_BYTES - sent);
+		if (seed & 0x100) {
+			for (i = 0; i < len; i++)
+				tmp[i] = stream_byte(sent + i);
+			if (no_os_spsc_ring_write(ring, tmp, len)) {
+				sched_yield();
+				continue;
+			}
+		} else {
+			if (no_os_spsc_ring_reserve(ring, len, &addr, &avail)) {
+				sched_yield();
+				continue;
+			}
+			len = avail;
+			for (i = 0; i < len; i++)
+				((uint8_t *)addr)[i] = stream_byte(sent + i);
+			no_os_spsc_ring_commit(ring, len);
+		}
+		sent += len;
+	}
+
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	uint32_t *errors = arg;
+	uint8_t tmp[32];
+	uint32_t seed = 7, recv = 0, len, avail, i;
+	uint8_t *data;
+	void *addr;
+
+	while (recv < STRESS_BYTES) {
+		len = chunk_len(&seed);
+		len = no_os_min(len, STRESS_BYTES - recv);
+		if (seed & 0x100) {
+			if (no_os_spsc_ring_read(ring, tmp, len)) {
+				sched_yield();
+				continue;
+			}
+			data = tmp;
+		} else {
+			if (no_os_spsc_ring_peek(ring, len, &addr, &avail)) {
+				sched_yield();
+				continue;
+			}
+			len = avail;
+			data = addr;
+		}
+		for (i = 0; i < len; i++)
+			if (data[i] != stream_byte(recv + i))
+				(*errors)++;
+		if (data != tmp)
+			no_os_spsc_ring_consume(ring, len);
+		recv += len;
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ *    SETUP AND TEARDOWN
+ ******************************************************************************/
+
+void setUp(void)
+{
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_init(&ring, RING_SIZE));
+}
+
+void tearDown(void)
+{
+	no_os_spsc_ring_remove(ring);
+}
+
+/*******************************************************************************
+ *    TEST CASES
+ ******************************************************************************/
+
+void test_init_size_not_power_of_two(void)
+{
+	struct no_os_spsc_ring *bad;
+
+	TEST_ASSERT_EQUAL_INT32(-EINVAL, no_os_spsc_ring_init(&bad, 48));
+}
+
+void test_write_read_wrap(void)
+{
+	uint8_t in[40], out[40];
+	uint32_t i;
+
+	for (i = 0; i < sizeof(in); i++)
+		in[i] = i;
+
+	/* Second write wraps around the end of the buffer */
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_write(ring, in, 40));
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_read(ring, out, 40));
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_write(ring, in, 40));
+	TEST_ASSERT_EQUAL_UINT32(40, no_os_spsc_ring_used(ring));
+	TEST_ASSERT_EQUAL_UINT32(RING_SIZE - 40, no_os_spsc_ring_space(ring));
+
+	/* Nothing is written or read partially */
+	TEST_ASSERT_EQUAL_INT32(-EAGAIN, no_os_spsc_ring_write(ring, in, 25));
+	TEST_ASSERT_EQUAL_INT32(-EAGAIN, no_os_spsc_ring_read(ring, out, 41));
+
+	memset(out, 0, sizeof(out));
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_read(ring, out, 40));
+	TEST_ASSERT_EQUAL_MEMORY(in, out, sizeof(in));
+	TEST_ASSERT_EQUAL_UINT32(0, no_os_spsc_ring_used(ring));
+}
+
+void test_reserve_stops_at_buffer_end(void)
+{
+	uint8_t in[48] = {0};
+	uint32_t avail;
+	void *addr;
+
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_write(ring, in, 48));
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_consume(ring, 48));
+
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_reserve(ring, 32, &addr,
+				&avail));
+	TEST_ASSERT_EQUAL_UINT32(16, avail);
+	TEST_ASSERT_EQUAL_PTR(ring->buff + 48, addr);
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_commit(ring, avail));
+
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_peek(ring, 32, &addr,
+				&avail));
+	TEST_ASSERT_EQUAL_UINT32(16, avail);
+	TEST_ASSERT_EQUAL_INT32(-EINVAL, no_os_spsc_ring_consume(ring, 17));
+	TEST_ASSERT_EQUAL_INT32(0, no_os_spsc_ring_consume(ring, 16));
+	TEST_ASSERT_EQUAL_INT32(-EAGAIN, no_os_spsc_ring_peek(ring, 1, &addr,
+				&avail));
+}
+
+void test_producer_consumer_threads(void)
+{
+	pthread_t prod, cons;
+	uint32_t errors = 0;
+
+	TEST_ASSERT_EQUAL_INT(0, pthread_create(&cons, NULL, consumer, &errors));
+	TEST_ASSERT_EQUAL_INT(0, pthread_create(&prod, NULL, producer, NULL));
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+
+	TEST_ASSERT_EQUAL_UINT32(0, errors);
+	TEST_ASSERT_EQUAL_UINT32(0, no_os_spsc_ring_used(ring));
+}
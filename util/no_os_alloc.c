@@ -31,9 +31,430 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
 #include "no_os_alloc.h"
 #include "no_os_util.h"
 
+/* Alignment of the returned blocks */
+#define NO_OS_ALLOC_ALIGN	sizeof(max_align_t)
+
+static const char * const no_os_alloc_tag_names[NO_OS_ALLOC_TAG_MAX] = {
+	[NO_OS_ALLOC_TAG_DEFAULT] = "default",
+	[NO_OS_ALLOC_TAG_IIO] = "iio",
+	[NO_OS_ALLOC_TAG_SPI] = "spi",
+	[NO_OS_ALLOC_TAG_LIST] = "list",
+};
+
+#ifdef NO_OS_ALLOC_STATS
+
+#ifndef NO_OS_ALLOC_POOL_NB_32
+#define NO_OS_ALLOC_POOL_NB_32		64
+#endif
+#ifndef NO_OS_ALLOC_POOL_NB_64
+#define NO_OS_ALLOC_POOL_NB_64		32
+#endif
+#ifndef NO_OS_ALLOC_POOL_NB_128
+#define NO_OS_ALLOC_POOL_NB_128		16
+#endif
+#ifndef NO_OS_ALLOC_POOL_NB_256
+#define NO_OS_ALLOC_POOL_NB_256		8
+#endif
+#ifndef NO_OS_ALLOC_POOL_NB_512
+#define NO_OS_ALLOC_POOL_NB_512		4
+#endif
+#ifndef NO_OS_ALLOC_POOL_NB_1024
+#define NO_OS_ALLOC_POOL_NB_1024	2
+#endif
+#ifndef NO_OS_ALLOC_POOL_NB_2048
+#define NO_OS_ALLOC_POOL_NB_2048	1
+#endif
+
+/* pool field of the blocks which don't belong to a pool */
+#define NO_OS_ALLOC_HEAP	0xFF
+
+/*
+ * Stored in front of every block. Padded to NO_OS_ALLOC_ALIGN so the block
+ * following it keeps the alignment of the C library allocator.
+ */
+union no_os_alloc_hdr {
+	struct {
+		/** Requested size */
+		uint32_t size;
+		/** enum no_os_alloc_tag */
+		uint8_t tag;
+		/** Index of the pool or NO_OS_ALLOC_HEAP */
+		uint8_t pool;
+	};
+	max_align_t align;
+};
+
+/* A free pool block, linked through its first bytes */
+struct no_os_alloc_free_block {
+	struct no_os_alloc_free_block *next;
+};
+
+struct no_os_alloc_pool {
+	/* Usable size of a block */
+	uint32_t block_size;
+	uint32_t nb_blocks;
+	uint8_t *mem;
+	struct no_os_alloc_free_block *free_list;
+	uint32_t used;
+	uint32_t peak;
+};
+
+#define NO_OS_ALLOC_BLOCK(size)	(sizeof(union no_os_alloc_hdr) + (size))
+
+#define NO_OS_ALLOC_POOL_MEM(size)					\
+	static uint8_t no_os_alloc_pool_##size[NO_OS_ALLOC_POOL_NB_##size]	\
+		[NO_OS_ALLOC_BLOCK(size)]					\
+		__attribute__((aligned(NO_OS_ALLOC_ALIGN)))
+
+#define NO_OS_ALLOC_POOL_ENTRY(size) {					\
+	.block_size = size,						\
+	.nb_blocks = NO_OS_ALLOC_POOL_NB_##size,			\
+	.mem = (uint8_t *)no_os_alloc_pool_##size,			\
+}
+
+#ifdef NO_OS_ALLOC_POOL
+NO_OS_ALLOC_POOL_MEM(32);
+NO_OS_ALLOC_POOL_MEM(64);
+NO_OS_ALLOC_POOL_MEM(128);
+NO_OS_ALLOC_POOL_MEM(256);
+NO_OS_ALLOC_POOL_MEM(512);
+NO_OS_ALLOC_POOL_MEM(1024);
+NO_OS_ALLOC_POOL_MEM(2048);
+
+/* Sorted by block size */
+static struct no_os_alloc_pool no_os_alloc_pools[] = {
+	NO_OS_ALLOC_POOL_ENTRY(32),
+	NO_OS_ALLOC_POOL_ENTRY(64),
+	NO_OS_ALLOC_POOL_ENTRY(128),
+	NO_OS_ALLOC_POOL_ENTRY(256),
+	NO_OS_ALLOC_POOL_ENTRY(512),
+	NO_OS_ALLOC_POOL_ENTRY(1024),
+	NO_OS_ALLOC_POOL_ENTRY(2048),
+};
+#define NO_OS_ALLOC_NB_POOLS	NO_OS_ARRAY_SIZE(no_os_alloc_pools)
+static bool no_os_alloc_pools_ready;
+#endif
+
+#ifdef NO_OS_ALLOC_ARENA_SIZE
+static uint8_t no_os_alloc_arena_mem[NO_OS_ALLOC_ARENA_SIZE]
+__attribute__((aligned(NO_OS_ALLOC_ALIGN)));
+static struct no_os_arena no_os_alloc_arena = {
+	.buf = no_os_alloc_arena_mem,
+	.size = sizeof(no_os_alloc_arena_mem),
+};
+#endif
+
+static struct no_os_alloc_stats no_os_alloc_stats[NO_OS_ALLOC_TAG_MAX];
+
+/* Protects the pools and the statistics. Not to be taken from interrupts. */
+static volatile bool no_os_alloc_locked;
+
+static void no_os_alloc_lock(void)
+{
+	while (__atomic_test_and_set(&no_os_alloc_locked, __ATOMIC_ACQUIRE))
+		;
+}
+
+static void no_os_alloc_unlock(void)
+{
+	__atomic_clear(&no_os_alloc_locked, __ATOMIC_RELEASE);
+}
+
+#ifdef NO_OS_ALLOC_POOL
+/* Link all the blocks of every pool in its free list. Called locked. */
+static void no_os_alloc_pools_init(void)
+{
+	struct no_os_alloc_free_block *block;
+	struct no_os_alloc_pool *pool;
+	uint32_t i, j;
+
+	for (i = 0; i < NO_OS_ALLOC_NB_POOLS; i++) {
+		pool = &no_os_alloc_pools[i];
+		for (j = pool->nb_blocks; j > 0; j--) {
+			block = (struct no_os_alloc_free_block *)(pool->mem +
+					(j - 1) * NO_OS_ALLOC_BLOCK(pool->block_size) +
+					sizeof(union no_os_alloc_hdr));
+			block->next = pool->free_list;
+			pool->free_list = block;
+		}
+	}
+
+	no_os_alloc_pools_ready = true;
+}
+
+/* Take a block from the smallest pool fitting size. Called locked. */
+static union no_os_alloc_hdr *no_os_alloc_pool_get(size_t size)
+{
+	struct no_os_alloc_free_block *block;
+	struct no_os_alloc_pool *pool;
+	union no_os_alloc_hdr *hdr;
+	uint32_t i;
+
+	if (!no_os_alloc_pools_ready)
+		no_os_alloc_pools_init();
+
+	for (i = 0; i < NO_OS_ALLOC_NB_POOLS; i++) {
+		pool = &no_os_alloc_pools[i];
+		if (pool->block_size < size || !pool->free_list)
+			continue;
+
+		block = pool->free_list;
+		pool->free_list = block->next;
+		pool->used++;
+		if (pool->used > pool->peak)
+			pool->peak = pool->used;
+
+		hdr = (union no_os_alloc_hdr *)block - 1;
+		hdr->pool = i;
+
+		return hdr;
+	}
+
+	return NULL;
+}
+#endif
+
+/* Get a block from the heap backend. */
+static union no_os_alloc_hdr *no_os_alloc_heap_get(size_t size)
+{
+	union no_os_alloc_hdr *hdr;
+
+#if defined(NO_OS_ALLOC_POOL) && defined(NO_OS_ALLOC_POOL_STRICT)
+	(void)size;
+	hdr = NULL;
+#elif defined(NO_OS_ALLOC_ARENA_SIZE)
+	hdr = no_os_arena_alloc(&no_os_alloc_arena, sizeof(*hdr) + size);
+#else
+	hdr = no_os_alloc_heap_malloc(sizeof(*hdr) + size);
+#endif
+	if (hdr)
+		hdr->pool = NO_OS_ALLOC_HEAP;
+
+	return hdr;
+}
+
+/**
+ * @brief Allocate memory and account it under a tag.
+ * @param size - Size of the memory block, in bytes.
+ * @param tag - Subsystem doing the allocation.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_malloc_tag(size_t size, enum no_os_alloc_tag tag)
+{
+	union no_os_alloc_hdr *hdr = NULL;
+	struct no_os_alloc_stats *stats;
+	uint32_t wasted = 0;
+
+	if (tag >= NO_OS_ALLOC_TAG_MAX)
+		tag = NO_OS_ALLOC_TAG_DEFAULT;
+	stats = &no_os_alloc_stats[tag];
+
+	no_os_alloc_lock();
+	if (size > UINT32_MAX - sizeof(*hdr)) {
+		stats->nb_failed++;
+		no_os_alloc_unlock();
+		return NULL;
+	}
+
+#ifdef NO_OS_ALLOC_POOL
+	hdr = no_os_alloc_pool_get(size);
+	if (hdr)
+		wasted = no_os_alloc_pools[hdr->pool].block_size - size;
+#endif
+	if (!hdr) {
+#ifndef NO_OS_ALLOC_ARENA_SIZE
+		/* The C library has its own locking */
+		no_os_alloc_unlock();
+		hdr = no_os_alloc_heap_get(size);
+		no_os_alloc_lock();
+#else
+		hdr = no_os_alloc_heap_get(size);
+#endif
+	}
+	if (!hdr) {
+		stats->nb_failed++;
+		no_os_alloc_unlock();
+		return NULL;
+	}
+
+	hdr->size = size;
+	hdr->tag = tag;
+	stats->nb_allocs++;
+	stats->in_use += size;
+	stats->wasted += wasted;
+	if (stats->in_use > stats->peak)
+		stats->peak = stats->in_use;
+	no_os_alloc_unlock();
+
+	return hdr + 1;
+}
+
+/**
+ * @brief Allocate memory set to 0 and account it under a tag.
+ * @param nitems - Number of elements to be allocated.
+ * @param size - Size of elements.
+ * @param tag - Subsystem doing the allocation.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_calloc_tag(size_t nitems, size_t size, enum no_os_alloc_tag tag)
+{
+	void *ptr;
+
+	if (size && nitems > SIZE_MAX / size)
+		return NULL;
+
+	ptr = no_os_malloc_tag(nitems * size, tag);
+	if (ptr)
+		memset(ptr, 0, nitems * size);
+
+	return ptr;
+}
+
+/**
+ * @brief Allocate memory and return a pointer to it.
+ * @param size - Size of the memory block, in bytes.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_malloc(size_t size)
+{
+	return no_os_malloc_tag(size, NO_OS_ALLOC_TAG_DEFAULT);
+}
+
+/**
+ * @brief Allocate memory and return a pointer to it, set memory to 0.
+ * @param nitems - Number of elements to be allocated.
+ * @param size - Size of elements.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_calloc(size_t nitems, size_t size)
+{
+	return no_os_calloc_tag(nitems, size, NO_OS_ALLOC_TAG_DEFAULT);
+}
+
+/**
+ * @brief Deallocate memory previously allocated by a call to no_os_calloc
+ * 		  or no_os_malloc.
+ * @param ptr - Pointer to a memory block previously allocated by a call
+ * 		  to no_os_calloc or no_os_malloc.
+ * @return None.
+ */
+void no_os_free(void *ptr)
+{
+	union no_os_alloc_hdr *hdr;
+	struct no_os_alloc_stats *stats;
+#ifdef NO_OS_ALLOC_POOL
+	struct no_os_alloc_free_block *block = ptr;
+	struct no_os_alloc_pool *pool;
+#endif
+
+	if (!ptr)
+		return;
+
+	hdr = (union no_os_alloc_hdr *)ptr - 1;
+	stats = &no_os_alloc_stats[hdr->tag];
+
+	no_os_alloc_lock();
+	stats->nb_frees++;
+	stats->in_use -= hdr->size;
+#ifdef NO_OS_ALLOC_POOL
+	if (hdr->pool != NO_OS_ALLOC_HEAP) {
+		pool = &no_os_alloc_pools[hdr->pool];
+		stats->wasted -= pool->block_size - hdr->size;
+		block->next = pool->free_list;
+		pool->free_list = block;
+		pool->used--;
+		no_os_alloc_unlock();
+		return;
+	}
+#endif
+	no_os_alloc_unlock();
+
+#ifndef NO_OS_ALLOC_ARENA_SIZE
+	no_os_alloc_heap_free(hdr);
+#endif
+}
+
+/**
+ * @brief Allocate memory from the heap backend. Weak, so platforms with their
+ * own heap can override it.
+ * @param size - Size of the memory block, in bytes.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+__no_os_weak__((weak)) void *no_os_alloc_heap_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+/**
+ * @brief Deallocate memory allocated by no_os_alloc_heap_malloc(). Weak, so
+ * platforms with their own heap can override it.
+ * @param ptr - Pointer to the memory block.
+ * @return None.
+ */
+__no_os_weak__((weak)) void no_os_alloc_heap_free(void *ptr)
+{
+	free(ptr);
+}
+
+/**
+ * @brief Get the allocation statistics of a tag.
+ * @param tag - The tag.
+ * @param stats - Filled with the statistics.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_alloc_get_stats(enum no_os_alloc_tag tag,
+			  struct no_os_alloc_stats *stats)
+{
+	if (tag >= NO_OS_ALLOC_TAG_MAX || !stats)
+		return -EINVAL;
+
+	no_os_alloc_lock();
+	*stats = no_os_alloc_stats[tag];
+	no_os_alloc_unlock();
+
+	return 0;
+}
+
+/**
+ * @brief Get the usage of a pool of fixed size blocks.
+ * @param idx - Index of the pool, pools are sorted by block size.
+ * @param stats - Filled with the pool usage.
+ * @return 0 in case of success, -ENOENT if there is no pool idx.
+ */
+int no_os_alloc_get_pool_stats(uint32_t idx,
+			       struct no_os_alloc_pool_stats *stats)
+{
+	if (!stats)
+		return -EINVAL;
+
+#ifndef NO_OS_ALLOC_POOL
+	(void)idx;
+
+	return -ENOENT;
+#else
+	if (idx >= NO_OS_ALLOC_NB_POOLS)
+		return -ENOENT;
+
+	no_os_alloc_lock();
+	stats->block_size = no_os_alloc_pools[idx].block_size;
+	stats->nb_blocks = no_os_alloc_pools[idx].nb_blocks;
+	stats->used = no_os_alloc_pools[idx].used;
+	stats->peak = no_os_alloc_pools[idx].peak;
+	no_os_alloc_unlock();
+
+	return 0;
+#endif
+}
+
+#else
+
 /**
  * @brief Allocate memory and return a pointer to it.
  * @param size - Size of the memory block, in bytes.
@@ -66,3 +487,134 @@ __no_os_weak__((weak)) void no_os_free(void *ptr)
 {
 	free(ptr);
 }
+
+/**
+ * @brief Allocate memory. Tags are only accounted with NO_OS_ALLOC_STATS.
+ * @param size - Size of the memory block, in bytes.
+ * @param tag - Subsystem doing the allocation.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_malloc_tag(size_t size, enum no_os_alloc_tag tag)
+{
+	(void)tag;
+
+	return no_os_malloc(size);
+}
+
+/**
+ * @brief Allocate memory set to 0. Tags are only accounted with
+ * NO_OS_ALLOC_STATS.
+ * @param nitems - Number of elements to be allocated.
+ * @param size - Size of elements.
+ * @param tag - Subsystem doing the allocation.
+ * @return Pointer to the allocated memory, or NULL if the request fails.
+ */
+void *no_os_calloc_tag(size_t nitems, size_t size, enum no_os_alloc_tag tag)
+{
+	(void)tag;
+
+	return no_os_calloc(nitems, size);
+}
+
+/**
+ * @brief Statistics are only available with NO_OS_ALLOC_STATS.
+ * @param tag - The tag.
+ * @param stats - Unused.
+ * @return -ENOSYS
+ */
+int no_os_alloc_get_stats(enum no_os_alloc_tag tag,
+			  struct no_os_alloc_stats *stats)
+{
+	(void)tag;
+	(void)stats;
+
+	return -ENOSYS;
+}
+
+/**
+ * @brief Pools are only available with NO_OS_ALLOC_POOL.
+ * @param idx - Index of the pool.
+ * @param stats - Unused.
+ * @return -ENOENT
+ */
+int no_os_alloc_get_pool_stats(uint32_t idx,
+			       struct no_os_alloc_pool_stats *stats)
+{
+	(void)idx;
+	(void)stats;
+
+	return -ENOENT;
+}
+
+#endif
+
+/**
+ * @brief Get the name of a tag.
+ * @param tag - The tag.
+ * @return Name of the tag, NULL for an invalid tag.
+ */
+const char *no_os_alloc_tag_name(enum no_os_alloc_tag tag)
+{
+	if (tag >= NO_OS_ALLOC_TAG_MAX)
+		return NULL;
+
+	return no_os_alloc_tag_names[tag];
+}
+
+/**
+ * @brief Use a buffer as the memory of an arena.
+ * @param arena - The arena.
+ * @param buf - Memory of the arena.
+ * @param size - Size of buf, in bytes.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int no_os_arena_init(struct no_os_arena *arena, void *buf, size_t size)
+{
+	if (!arena || !buf)
+		return -EINVAL;
+
+	arena->buf = buf;
+	arena->size = size;
+	arena->used = 0;
+	arena->peak = 0;
+
+	return 0;
+}
+
+/**
+ * @brief Allocate memory from an arena, in constant time.
+ * @param arena - The arena.
+ * @param size - Size of the memory block, in bytes.
+ * @return Pointer to the allocated memory, aligned like the C library
+ * allocations, or NULL if the arena has not enough memory left.
+ */
+void *no_os_arena_alloc(struct no_os_arena *arena, size_t size)
+{
+	uintptr_t start;
+	size_t offset;
+
+	if (!arena)
+		return NULL;
+
+	start = (uintptr_t)arena->buf + arena->used;
+	offset = arena->used + (-start & (NO_OS_ALLOC_ALIGN - 1));
+	if (offset > arena->size || size > arena->size - offset)
+		return NULL;
+
+	arena->used = offset + size;
+	if (arena->used > arena->peak)
+		arena->peak = arena->used;
+
+	return arena->buf + offset;
+}
+
+/**
+ * @brief Free everything allocated from an arena.
+ * @param arena - The arena.
+ * @return None.
+ */
+void no_os_arena_reset(struct no_os_arena *arena)
+{
+	if (arena)
+		arena->used = 0;
+}
@@ -95,3 +95,65 @@ uint16_t no_os_crc16(const uint16_t * table, const uint8_t *pdata,
 
 	return crc;
 }
+
+/***************************************************************************//**
+ * @brief Creates the CRC-16 slicing-by-4 lookup tables for a given polynomial.
+ *
+ * table[0] is the table created by no_os_crc16_populate_msb(), table[k]
+ * holds the CRC of a byte followed by k zero bytes.
+ *
+ * @param table      - Pointer to the CRC-16 slicing tables to write to.
+ * @param polynomial - Msb-first representation of desired polynomial.
+ *
+ * @return None.
+*******************************************************************************/
+void no_os_crc16_populate_msb_slice(uint16_t (*table)[NO_OS_CRC16_TABLE_SIZE],
+				    const uint16_t polynomial)
+{
+	uint16_t crc;
+
+	if (!table)
+		return;
+
+	no_os_crc16_populate_msb(table[0], polynomial);
+
+	for (int16_t n = 0; n < NO_OS_CRC16_TABLE_SIZE; n++) {
+		crc = table[0][n];
+		for (uint8_t k = 1; k < NO_OS_CRC16_SLICES; k++) {
+			crc = table[0][crc >> 8] ^ (uint16_t)(crc << 8);
+			table[k][n] = crc;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Computes the CRC-16 over a buffer of data, 4 bytes at a time.
+ *
+ * Gives the same result as no_os_crc16() with table[0], with one table
+ * lookup per byte but without the dependency between consecutive bytes.
+ *
+ * @param table     - Pointer to CRC-16 slicing tables for the desired
+ *                    polynomial.
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-16 over.
+ * @param crc       - Initial value for the CRC-16 computation.
+ *
+ * @return crc      - Computed CRC-16 value.
+*******************************************************************************/
+uint16_t no_os_crc16_slice(const uint16_t (*table)[NO_OS_CRC16_TABLE_SIZE],
+			   const uint8_t *pdata, size_t nbytes, uint16_t crc)
+{
+	uint32_t x;
+
+	while (nbytes >= NO_OS_CRC16_SLICES) {
+		x = ((uint32_t)crc << 16) ^ ((uint32_t)pdata[0] << 24) ^
+		    ((uint32_t)pdata[1] << 16) ^ ((uint32_t)pdata[2] << 8) ^
+		    pdata[3];
+		crc = table[3][x >> 24] ^ table[2][(x >> 16) & 0xff] ^
+		      table[1][(x >> 8) & 0xff] ^ table[0][x & 0xff];
+		pdata += NO_OS_CRC16_SLICES;
+		nbytes -= NO_OS_CRC16_SLICES;
+	}
+
+	return no_os_crc16(table[0], pdata, nbytes, crc);
+}
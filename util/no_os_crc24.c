@@ -96,3 +96,65 @@ uint32_t no_os_crc24(const uint32_t * table, const uint8_t *pdata,
 
 	return (crc & 0xffffff);
 }
+
+/***************************************************************************//**
+ * @brief Creates the CRC-24 slicing-by-4 lookup tables for a given polynomial.
+ *
+ * table[0] is the table created by no_os_crc24_populate_msb(), table[k]
+ * holds the CRC of a byte followed by k zero bytes.
+ *
+ * @param table      - Pointer to the CRC-24 slicing tables to write to.
+ * @param polynomial - Msb-first representation of desired polynomial.
+ *
+ * @return None.
+*******************************************************************************/
+void no_os_crc24_populate_msb_slice(uint32_t (*table)[NO_OS_CRC24_TABLE_SIZE],
+				    const uint32_t polynomial)
+{
+	uint32_t crc;
+
+	if (!table)
+		return;
+
+	no_os_crc24_populate_msb(table[0], polynomial);
+
+	for (int16_t n = 0; n < NO_OS_CRC24_TABLE_SIZE; n++) {
+		crc = table[0][n];
+		for (uint8_t k = 1; k < NO_OS_CRC24_SLICES; k++) {
+			crc = table[0][(crc >> 16) & 0xff] ^ ((crc << 8) & 0xffffff);
+			table[k][n] = crc;
+		}
+	}
+}
+
+/***************************************************************************//**
+ * @brief Computes the CRC-24 over a buffer of data, 4 bytes at a time.
+ *
+ * Gives the same result as no_os_crc24() with table[0], with one table
+ * lookup per byte but without the dependency between consecutive bytes.
+ *
+ * @param table     - Pointer to CRC-24 slicing tables for the desired
+ *                    polynomial.
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-24 over.
+ * @param crc       - Initial value for the CRC-24 computation.
+ *
+ * @return crc      - Computed CRC-24 value.
+*******************************************************************************/
+uint32_t no_os_crc24_slice(const uint32_t (*table)[NO_OS_CRC24_TABLE_SIZE],
+			   const uint8_t *pdata, size_t nbytes, uint32_t crc)
+{
+	uint32_t x;
+
+	while (nbytes >= NO_OS_CRC24_SLICES) {
+		x = ((crc & 0xffffff) << 8) ^ ((uint32_t)pdata[0] << 24) ^
+		    ((uint32_t)pdata[1] << 16) ^ ((uint32_t)pdata[2] << 8) ^
+		    pdata[3];
+		crc = table[3][x >> 24] ^ table[2][(x >> 16) & 0xff] ^
+		      table[1][(x >> 8) & 0xff] ^ table[0][x & 0xff];
+		pdata += NO_OS_CRC24_SLICES;
+		nbytes -= NO_OS_CRC24_SLICES;
+	}
+
+	return no_os_crc24(table[0], pdata, nbytes, crc);
+}
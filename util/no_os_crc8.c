@@ -127,3 +127,86 @@ uint8_t no_os_crc8(const uint8_t * table, const uint8_t *pdata, size_t nbytes,
 
 	return crc;
 }
+
+/***************************************************************************//**
+ * @brief Fills table[1..3] of the CRC-8 slicing tables from table[0].
+ *
+ * @param table      - Pointer to the CRC-8 slicing tables, table[0] populated.
+ *
+ * @return None.
+*******************************************************************************/
+static void no_os_crc8_populate_slices(uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE])
+{
+	for (int16_t n = 0; n < NO_OS_CRC8_TABLE_SIZE; n++)
+		for (uint8_t k = 1; k < NO_OS_CRC8_SLICES; k++)
+			table[k][n] = table[0][table[k - 1][n]];
+}
+
+/***************************************************************************//**
+ * @brief Creates the CRC-8 slicing-by-4 lookup tables for a given polynomial.
+ *
+ * table[0] is the table created by no_os_crc8_populate_msb(), table[k]
+ * holds the CRC of a byte followed by k zero bytes.
+ *
+ * @param table      - Pointer to the CRC-8 slicing tables to write to.
+ * @param polynomial - Msb-first representation of desired polynomial.
+ *
+ * @return None.
+*******************************************************************************/
+void no_os_crc8_populate_msb_slice(uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE],
+				   const uint8_t polynomial)
+{
+	if (!table)
+		return;
+
+	no_os_crc8_populate_msb(table[0], polynomial);
+	no_os_crc8_populate_slices(table);
+}
+
+/***************************************************************************//**
+ * @brief Creates the CRC-8 slicing-by-4 lookup tables for a given polynomial.
+ *
+ * table[0] is the table created by no_os_crc8_populate_lsb(), table[k]
+ * holds the CRC of a byte followed by k zero bytes.
+ *
+ * @param table      - Pointer to the CRC-8 slicing tables to write to.
+ * @param polynomial - lsb-first representation of desired polynomial.
+ *
+ * @return None.
+*******************************************************************************/
+void no_os_crc8_populate_lsb_slice(uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE],
+				   const uint8_t polynomial)
+{
+	if (!table)
+		return;
+
+	no_os_crc8_populate_lsb(table[0], polynomial);
+	no_os_crc8_populate_slices(table);
+}
+
+/***************************************************************************//**
+ * @brief Computes the CRC-8 over a buffer of data, 4 bytes at a time.
+ *
+ * Gives the same result as no_os_crc8() with table[0], with one table
+ * lookup per byte but without the dependency between consecutive bytes.
+ *
+ * @param table     - Pointer to CRC-8 slicing tables for the desired
+ *                    polynomial.
+ * @param pdata     - Pointer to data buffer.
+ * @param nbytes    - Number of bytes to compute the CRC-8 over.
+ * @param crc       - Initial value for the CRC-8 computation.
+ *
+ * @return crc      - Computed CRC-8 value.
+*******************************************************************************/
+uint8_t no_os_crc8_slice(const uint8_t (*table)[NO_OS_CRC8_TABLE_SIZE],
+			 const uint8_t *pdata, size_t nbytes, uint8_t crc)
+{
+	while (nbytes >= NO_OS_CRC8_SLICES) {
+		crc = table[3][crc ^ pdata[0]] ^ table[2][pdata[1]] ^
+		      table[1][pdata[2]] ^ table[0][pdata[3]];
+		pdata += NO_OS_CRC8_SLICES;
+		nbytes -= NO_OS_CRC8_SLICES;
+	}
+
+	return no_os_crc8(table[0], pdata, nbytes, crc);
+}
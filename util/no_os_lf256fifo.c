@@ -33,16 +33,17 @@
 *******************************************************************************/
 #include <errno.h>
 #include "no_os_lf256fifo.h"
+#include "no_os_lffifo.h"
 #include "no_os_alloc.h"
 
+NO_OS_LFFIFO_DEFINE(lf256, uint8_t, 256)
+
 /**
  * @struct lf256fifo
  * @brief Structure holding the fifo element parameters.
  */
 struct lf256fifo {
-	uint8_t * data; // pointer to memory area where the buffer will be allocated
-	uint8_t ffilled; // the index where the data starts
-	uint8_t fempty; // the index where empty/non-used area starts
+	struct lf256 fifo;
 };
 
 /**
@@ -59,12 +60,6 @@ int lf256fifo_init(struct lf256fifo **fifo)
 	if (b == NULL)
 		return -ENOMEM;
 
-	b->data = no_os_calloc(1, 256);
-	if (b->data == NULL) {
-		no_os_free(b);
-		return -ENOMEM;
-	}
-
 	*fifo = b;
 
 	return 0;
@@ -77,8 +72,7 @@ int lf256fifo_init(struct lf256fifo **fifo)
  */
 bool lf256fifo_is_full(struct lf256fifo *fifo)
 {
-	return (fifo->fempty + 1) ==
-	       fifo->ffilled; // intended overflow at 256 (data size is 256)
+	return lf256_is_full(&fifo->fifo);
 }
 
 /**
@@ -88,7 +82,7 @@ bool lf256fifo_is_full(struct lf256fifo *fifo)
 */
 bool lf256fifo_is_empty(struct lf256fifo *fifo)
 {
-	return fifo->fempty == fifo->ffilled;
+	return lf256_is_empty(&fifo->fifo);
 }
 
 /**
@@ -99,13 +93,7 @@ bool lf256fifo_is_empty(struct lf256fifo *fifo)
 */
 int lf256fifo_read(struct lf256fifo * fifo, uint8_t *c)
 {
-	if (lf256fifo_is_empty(fifo))
-		return -1; // buffer empty
-
-	*c = fifo->data[fifo->ffilled];
-	fifo->ffilled++; // intended overflow at 256 (data size is 256)
-
-	return 0;
+	return lf256_read(&fifo->fifo, c);
 }
 
 /**
@@ -116,13 +104,33 @@ int lf256fifo_read(struct lf256fifo * fifo, uint8_t *c)
 */
 int lf256fifo_write(struct lf256fifo *fifo, uint8_t c)
 {
-	if (lf256fifo_is_full(fifo))
-		return -1; // buffer full
+	return lf256_write(&fifo->fifo, c);
+}
 
-	fifo->data[fifo->fempty] = c;
-	fifo->fempty++; // intended overflow at 256 (data size is 256)
+/**
+* @brief Read up to len chars from fifo.
+* @param fifo - pointer to fifo descriptor.
+* @param data - pointer to memory where the chars are read.
+* @param len - maximum number of chars to read.
+* @return number of chars read.
+*/
+uint32_t lf256fifo_read_bulk(struct lf256fifo *fifo, uint8_t *data,
+			     uint32_t len)
+{
+	return lf256_read_bulk(&fifo->fifo, data, len);
+}
 
-	return 0; // return success
+/**
+* @brief Write up to len chars to fifo.
+* @param fifo - pointer to fifo descriptor.
+* @param data - chars to write.
+* @param len - number of chars to write.
+* @return number of chars written, less than len if the fifo got full.
+*/
+uint32_t lf256fifo_write_bulk(struct lf256fifo *fifo, const uint8_t *data,
+			      uint32_t len)
+{
+	return lf256_write_bulk(&fifo->fifo, data, len);
 }
 
 /**
@@ -132,7 +140,7 @@ int lf256fifo_write(struct lf256fifo *fifo, uint8_t c)
 */
 void lf256fifo_flush(struct lf256fifo *fifo)
 {
-	fifo->ffilled = fifo->fempty;
+	lf256_flush(&fifo->fifo);
 }
 
 /**
@@ -142,7 +150,5 @@ void lf256fifo_flush(struct lf256fifo *fifo)
 */
 void lf256fifo_remove(struct lf256fifo *fifo)
 {
-	if (fifo && fifo->data)
-		no_os_free(fifo->data);
+	no_os_free(fifo);
 }
-
@@ -31,6 +31,8 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************/
 
+#define NO_OS_ALLOC_TAG		NO_OS_ALLOC_TAG_LIST
+
 #include "no_os_list.h"
 #include "no_os_error.h"
 #include "no_os_alloc.h"
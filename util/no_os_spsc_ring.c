@@ -0,0 +1,301 @@
+/***************************************************************************//**
+ *   @file   no_os_spsc_ring.c
+ *   @brief  Lock-free single producer single consumer ring.
+********************************************************************************
+ *   @copyright
+ * Copyright 2024(c) Analog Devices, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. “AS IS” AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <string.h>
+#include "no_os_spsc_ring.h"
+#include "no_os_error.h"
+#include "no_os_util.h"
+#include "no_os_alloc.h"
+
+/*
+ * The data copied in the buffer must be visible before the index that
+ * publishes it and the other side must not access the buffer before reading
+ * the index. The GCC atomic builtins emit the required barriers (e.g. DMB on
+ * ARM) and are supported by all the toolchains used to build no-OS.
+ */
+#define _load_acquire(ptr)		__atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define _store_release(ptr, val)	__atomic_store_n((ptr), (val), \
+						 __ATOMIC_RELEASE)
+
+/**
+ * @brief Configure ring to use the given buffer.
+ * @param ring - Ring descriptor.
+ * @param buff - Buffer where data is stored.
+ * @param size - Size of buff in bytes. Must be a power of two.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_spsc_ring_cfg(struct no_os_spsc_ring *ring, uint8_t *buff,
+			    uint32_t size)
+{
+	if (!ring || !buff || !size || (size & (size - 1)))
+		return -EINVAL;
+
+	memset(ring, 0, sizeof(*ring));
+	ring->buff = buff;
+	ring->size = size;
+
+	return 0;
+}
+
+/**
+ * @brief Allocate a ring.
+ * @param ring - Where to store the ring reference.
+ * @param size - Size of the ring in bytes. Must be a power of two.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t no_os_spsc_ring_init(struct no_os_spsc_ring **ring, uint32_t size)
+{
+	struct no_os_spsc_ring *lring;
+	uint8_t *buff;
+	int32_t ret;
+
+	if (!ring)
+		return -EINVAL;
+
+	lring = no_os_calloc(1, sizeof(*lring));
+	if (!lring)
+		return -ENOMEM;
+
+	buff = no_os_calloc(1, size);
+	if (!buff) {
+		ret = -ENOMEM;
+		goto free_ring;
+	}
+
+	ret = no_os_spsc_ring_cfg(lring, buff, size);
+	if (ret)
+		goto free_buff;
+
+	lring->allocated = true;
+	*ring = lring;
+
+	return 0;
+
+free_buff:
+	no_os_free(buff);
+free_ring:
+	no_os_free(lring);
+
+	return ret;
+}
+
+/**
+ * @brief Free a ring allocated with no_os_spsc_ring_init.
+ * @param ring - Ring descriptor.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_spsc_ring_remove(struct no_os_spsc_ring *ring)
+{
+	if (!ring)
+		return -EINVAL;
+
+	if (ring->allocated)
+		no_os_free(ring->buff);
+	no_os_free(ring);
+
+	return 0;
+}
+
+/**
+ * @brief Get the number of bytes available to the consumer.
+ * @param ring - Ring descriptor.
+ * @return Number of bytes that can be read.
+ */
+uint32_t no_os_spsc_ring_used(struct no_os_spsc_ring *ring)
+{
+	return _load_acquire(&ring->head) - ring->tail;
+}
+
+/**
+ * @brief Get the number of bytes available to the producer.
+ * @param ring - Ring descriptor.
+ * @return Number of bytes that can be written.
+ */
+uint32_t no_os_spsc_ring_space(struct no_os_spsc_ring *ring)
+{
+	return ring->size - (ring->head - _load_acquire(&ring->tail));
+}
+
+/**
+ * @brief Get a contiguous area of the ring to be written in place.
+ *
+ * The area ends at the end of the buffer, so less than len bytes may be
+ * available even if the ring has more space. The data becomes visible to the
+ * consumer when no_os_spsc_ring_commit is called.
+ * @param ring - Ring descriptor.
+ * @param len - Number of bytes needed.
+ * @param addr - Address of the area.
+ * @param avail - Size of the area, at most len.
+ * @return 0 in case of success, -EAGAIN if the ring is full or -EINVAL.
+ */
+int32_t no_os_spsc_ring_reserve(struct no_os_spsc_ring *ring, uint32_t len,
+				void **addr, uint32_t *avail)
+{
+	uint32_t idx;
+
+	if (!ring || !addr || !avail)
+		return -EINVAL;
+
+	idx = ring->head & (ring->size - 1);
+	len = no_os_min(len, no_os_spsc_ring_space(ring));
+	len = no_os_min(len, ring->size - idx);
+	if (!len)
+		return -EAGAIN;
+
+	*addr = ring->buff + idx;
+	*avail = len;
+
+	return 0;
+}
+
+/**
+ * @brief Publish bytes written in an area got with no_os_spsc_ring_reserve.
+ * @param ring - Ring descriptor.
+ * @param len - Number of bytes written.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_spsc_ring_commit(struct no_os_spsc_ring *ring, uint32_t len)
+{
+	if (!ring || len > no_os_spsc_ring_space(ring))
+		return -EINVAL;
+
+	_store_release(&ring->head, ring->head + len);
+
+	return 0;
+}
+
+/**
+ * @brief Get a contiguous area of the ring to be read in place.
+ *
+ * The area ends at the end of the buffer, so less than len bytes may be
+ * available even if the ring has more data. The area is given back to the
+ * producer when no_os_spsc_ring_consume is called.
+ * @param ring - Ring descriptor.
+ * @param len - Number of bytes needed.
+ * @param addr - Address of the area.
+ * @param avail - Size of the area, at most len.
+ * @return 0 in case of success, -EAGAIN if the ring is empty or -EINVAL.
+ */
+int32_t no_os_spsc_ring_peek(struct no_os_spsc_ring *ring, uint32_t len,
+			     void **addr, uint32_t *avail)
+{
+	uint32_t idx;
+
+	if (!ring || !addr || !avail)
+		return -EINVAL;
+
+	idx = ring->tail & (ring->size - 1);
+	len = no_os_min(len, no_os_spsc_ring_used(ring));
+	len = no_os_min(len, ring->size - idx);
+	if (!len)
+		return -EAGAIN;
+
+	*addr = ring->buff + idx;
+	*avail = len;
+
+	return 0;
+}
+
+/**
+ * @brief Release bytes read from an area got with no_os_spsc_ring_peek.
+ * @param ring - Ring descriptor.
+ * @param len - Number of bytes read.
+ * @return 0 in case of success, -EINVAL otherwise.
+ */
+int32_t no_os_spsc_ring_consume(struct no_os_spsc_ring *ring, uint32_t len)
+{
+	if (!ring || len > no_os_spsc_ring_used(ring))
+		return -EINVAL;
+
+	_store_release(&ring->tail, ring->tail + len);
+
+	return 0;
+}
+
+/**
+ * @brief Copy len bytes in the ring. Nothing is written if they don't fit.
+ * @param ring - Ring descriptor.
+ * @param data - Data to be written.
+ * @param len - Number of bytes.
+ * @return 0 in case of success, -EAGAIN if there is not enough space or
+ * -EINVAL.
+ */
+int32_t no_os_spsc_ring_write(struct no_os_spsc_ring *ring, const void *data,
+			      uint32_t len)
+{
+	uint32_t idx, first;
+
+	if (!ring || !data)
+		return -EINVAL;
+
+	if (len > no_os_spsc_ring_space(ring))
+		return -EAGAIN;
+
+	idx = ring->head & (ring->size - 1);
+	first = no_os_min(len, ring->size - idx);
+	memcpy(ring->buff + idx, data, first);
+	memcpy(ring->buff, (const uint8_t *)data + first, len - first);
+
+	_store_release(&ring->head, ring->head + len);
+
+	return 0;
+}
+
+/**
+ * @brief Copy len bytes from the ring. Nothing is read if there are less.
+ * @param ring - Ring descriptor.
+ * @param data - Where to copy the data.
+ * @param len - Number of bytes.
+ * @return 0 in case of success, -EAGAIN if there is not enough data or
+ * -EINVAL.
+ */
+int32_t no_os_spsc_ring_read(struct no_os_spsc_ring *ring, void *data,
+			     uint32_t len)
+{
+	uint32_t idx, first;
+
+	if (!ring || !data)
+		return -EINVAL;
+
+	if (len > no_os_spsc_ring_used(ring))
+		return -EAGAIN;
+
+	idx = ring->tail & (ring->size - 1);
+	first = no_os_min(len, ring->size - idx);
+	memcpy(data, ring->buff + idx, first);
+	memcpy((uint8_t *)data + first, ring->buff, len - first);
+
+	_store_release(&ring->tail, ring->tail + len);
+
+	return 0;
+}
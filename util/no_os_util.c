@@ -313,6 +313,56 @@ unsigned int no_os_hweight32(uint32_t word)
 	       no_os_hweight16(word);
 }
 
+/**
+ * Find the first set bit of a bitmap, starting from position start.
+ * Returns nbits if there is no set bit.
+ */
+uint32_t no_os_find_next_set_bit(const uint32_t *bitmap, uint32_t nbits,
+				 uint32_t start)
+{
+	uint32_t word;
+	uint32_t bit;
+
+	if (start >= nbits)
+		return nbits;
+
+	/* Skip whole words instead of testing every bit */
+	word = bitmap[start / 32] & (0xFFFFFFFF << (start % 32));
+	start &= ~0x1F;
+	while (!word) {
+		start += 32;
+		if (start >= nbits)
+			return nbits;
+		word = bitmap[start / 32];
+	}
+
+#if defined(__GNUC__)
+	bit = start + __builtin_ctz(word);
+#else
+	bit = start + no_os_find_first_set_bit(word);
+#endif
+
+	return no_os_min(bit, nbits);
+}
+
+/**
+ * Calculate the number of set bits of a bitmap.
+ */
+uint32_t no_os_bitmap_weight(const uint32_t *bitmap, uint32_t nbits)
+{
+	uint32_t weight = 0;
+	uint32_t i;
+
+	for (i = 0; i < nbits / 32; i++)
+		weight += no_os_hweight32(bitmap[i]);
+
+	if (nbits % 32)
+		weight += no_os_hweight32(bitmap[i] &
+					  (0xFFFFFFFF >> (32 - nbits % 32)));
+
+	return weight;
+}
+
 /**
  * Calculate the quotient and the remainder of an integer division.
  */